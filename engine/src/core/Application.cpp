@@ -1,6 +1,7 @@
 #include "core/Application.hpp"
 
 #include "core/Input.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
 #include "core/ResourceManager.hpp"
 #include "ecs/Scene.hpp"
@@ -8,7 +9,11 @@
 #include "events/InputEvents.hpp"
 #include "events/WindowResizeEvent.hpp"
 #include "render/Camera.hpp"
+#include "render/GeometryArena.hpp"
+#include "render/MaterialTable.hpp"
+#include "render/RenderState.hpp"
 #include "render/Rendertarget.hpp"
+#include "render/Texture.hpp"
 #include "ui/Canvas.hpp"
 #include "ui/Theme.hpp"
 #include "ui/console/Commands.hpp"
@@ -24,12 +29,14 @@ namespace Birdy3d::core {
     std::weak_ptr<ui::Canvas> Application::canvas;
     ecs::Entity* Application::selected_entity = nullptr;
     GLFWwindow* Application::m_window = nullptr;
+    std::thread::id Application::m_main_thread;
     std::unordered_map<BoolOption, bool> Application::m_options_bool;
     std::unordered_map<IntOption, int> Application::m_options_int;
 
     Channel<std::function<void()>> Application::m_channel_main;
-    Channel<std::function<void()>> Application::m_channel_loading;
-    std::vector<std::thread> Application::m_loading_threads;
+    std::deque<std::function<void()>> Application::m_main_backlog;
+    MainTaskStats Application::m_main_task_stats;
+    LoadingQueue Application::m_loading_queue;
 
     void glfw_error_callback([[maybe_unused]] int error, char const* description)
     {
@@ -38,6 +45,8 @@ namespace Birdy3d::core {
 
     bool Application::init(char const* window_name, int width, int height, std::string const& theme_name)
     {
+        m_main_thread = std::this_thread::get_id();
+
 #ifdef _GLFW_WAYLAND
         // make wayland default instead of X11
         auto const wayland_display = std::getenv("WAYLAND_DISPLAY");
@@ -71,13 +80,14 @@ namespace Birdy3d::core {
             return false;
         }
 
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        render::Texture::init_bindless();
+        render::RenderState::enable(GL_DEPTH_TEST);
+        render::RenderState::enable(GL_CULL_FACE);
+        render::RenderState::enable(GL_BLEND);
+        render::RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         // Set Viewport and resize callback
-        glViewport(0, 0, width, height);
+        render::RenderState::viewport(0, 0, width, height);
         glfwSetFramebufferSizeCallback(m_window, framebuffer_size_callback);
         glfwSetWindowFocusCallback(m_window, window_focus_callback);
         glfwSetScrollCallback(m_window, scroll_callback);
@@ -95,34 +105,44 @@ namespace Birdy3d::core {
             Logger::critical("Invalid Theme '{}'", theme_name);
         ui::ConsoleCommands::register_all();
         render::Rendertarget::DEFAULT = std::shared_ptr<render::Rendertarget>(new render::Rendertarget(width, height, 0));
+        // Every option has a value from here on, so that reading an option never modifies the maps.
+        m_options_bool = {
+            {BoolOption::VSYNC, false},
+            {BoolOption::SHOW_COLLIDERS, false},
+            {BoolOption::HOT_RELOAD, false},
+            {BoolOption::PIPELINED_SIMULATION, false},
+            {BoolOption::SHADER_CACHE, false},
+            {BoolOption::BACKGROUND_BVH_REBUILD, false},
+            {BoolOption::GEOMETRY_ARENA, false},
+        };
+        m_options_int = {
+            {IntOption::SHADOW_CASCADE_SIZE, 0},
+            {IntOption::RESOURCE_CPU_BUDGET, 0},
+            {IntOption::RESOURCE_GPU_BUDGET, 0},
+            {IntOption::MAIN_TASK_BUDGET, 0},
+        };
         option_bool(BoolOption::VSYNC, true);
+        option_bool(BoolOption::SHADER_CACHE, true);
+        option_bool(BoolOption::GEOMETRY_ARENA, true);
         option_int(IntOption::SHADOW_CASCADE_SIZE, 5);
+        option_int(IntOption::RESOURCE_CPU_BUDGET, 1024);
+        option_int(IntOption::RESOURCE_GPU_BUDGET, 1024);
+        option_int(IntOption::MAIN_TASK_BUDGET, 4000);
 
-        std::size_t const loading_thread_count = 4;
-
-        for (std::size_t i = 0; i < loading_thread_count; ++i) {
-            m_loading_threads.push_back(std::thread([]() {
-                try {
-                    while (true) {
-                        auto task = m_channel_loading.get();
-                        std::invoke(task);
-                    }
-                } catch (ChannelClosedException&) {
-                    return;
-                }
-            }));
-        }
+        JobSystem::init(m_loading_queue);
 
         return true;
     }
 
     void Application::cleanup()
     {
+        m_loading_queue.close();
+        JobSystem::cleanup();
+        // Resources own OpenGL objects, so they have to be destroyed before the context
+        ResourceManager::cleanup();
+        render::MaterialTable::cleanup();
+        render::GeometryArena::cleanup();
         glfwTerminate();
-        m_channel_loading.close();
-        for (auto& thread : m_loading_threads) {
-            thread.join();
-        }
     }
 
     void Application::mainloop()
@@ -141,42 +161,90 @@ namespace Birdy3d::core {
             if (canvas_ptr)
                 canvas_ptr->update();
 
-            if (scene_ptr)
-                scene_ptr->update();
+            bool pipelined = option_bool(BoolOption::PIPELINED_SIMULATION);
+            if (scene_ptr) {
+                if (pipelined) {
+                    scene_ptr->update_components();
+                    scene_ptr->transform.update();
+                } else {
+                    scene_ptr->update();
+                }
+            }
 
             event_bus->flush();
 
-            while (true) {
-                auto task = m_channel_main.try_get();
-                if (task.has_value()) {
-                    std::invoke(task.value());
-                } else {
-                    break;
-                }
+            run_main_tasks();
+
+            ResourceManager::enforce_memory_budget();
+
+            std::shared_ptr<render::Camera> camera;
+            if (scene_ptr) {
+                camera = scene_ptr->main_camera.lock();
+                if (camera)
+                    camera->capture(selected_entity);
             }
 
+            // The camera only renders its snapshot, so the scene can already be simulated further.
+            JobHandle simulation;
+            if (scene_ptr && pipelined)
+                simulation = JobSystem::run([scene_ptr]() { scene_ptr->simulate(); });
+
             // draw the entitys
-            if (scene_ptr) {
-                if (auto camera = scene_ptr->main_camera.lock()) {
-                    camera->render();
-                    camera->render_outline(selected_entity);
-                    if (option_bool(BoolOption::SHOW_COLLIDERS))
-                        camera->render_collider_wireframe();
-                }
+            if (camera) {
+                camera->render();
+                camera->render_outline();
+                if (option_bool(BoolOption::SHOW_COLLIDERS))
+                    camera->render_collider_wireframe();
             }
 
             if (canvas_ptr)
                 canvas_ptr->draw_canvas();
 
+            if (simulation)
+                JobSystem::wait(simulation);
+
             if (scene_ptr)
                 scene_ptr->post_update();
 
+            render::RenderState::end_frame();
+
             // swap Buffers
             glfwSwapBuffers(m_window);
             glfwPollEvents();
         }
     }
 
+    void Application::run_main_tasks()
+    {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        auto budget = std::chrono::microseconds(option_int(IntOption::MAIN_TASK_BUDGET));
+
+        m_channel_main.try_pop_bulk(m_main_backlog);
+
+        // At least one task runs every frame, so the backlog always shrinks.
+        std::size_t tasks = 0;
+        auto elapsed = Clock::duration::zero();
+        while (!m_main_backlog.empty()) {
+            if (tasks > 0 && budget.count() > 0 && elapsed >= budget)
+                break;
+            auto task = std::move(m_main_backlog.front());
+            m_main_backlog.pop_front();
+            std::invoke(task);
+            tasks++;
+            elapsed = Clock::now() - start;
+        }
+
+        m_main_task_stats.last_frame_tasks = tasks;
+        m_main_task_stats.backlog = m_main_backlog.size();
+        if (budget.count() > 0 && elapsed > budget) {
+            auto overrun = std::chrono::duration_cast<std::chrono::microseconds>(elapsed - budget);
+            m_main_task_stats.overrun_frames++;
+            m_main_task_stats.total_overrun += overrun;
+            m_main_task_stats.max_overrun = std::max(m_main_task_stats.max_overrun, overrun);
+        }
+    }
+
     void Application::framebuffer_size_callback(GLFWwindow*, int width, int height)
     {
         render::Rendertarget::DEFAULT->resize(width, height);
@@ -259,7 +327,8 @@ namespace Birdy3d::core {
 
     bool Application::option_bool(BoolOption option)
     {
-        return m_options_bool[option];
+        auto it = m_options_bool.find(option);
+        return it != m_options_bool.end() && it->second;
     }
 
     void Application::option_toggle(BoolOption option)
@@ -274,6 +343,9 @@ namespace Birdy3d::core {
         case BoolOption::VSYNC:
             glfwSwapInterval(value);
             break;
+        case BoolOption::HOT_RELOAD:
+            ResourceManager::hot_reload(value);
+            break;
         default:
             break;
         }
@@ -281,7 +353,8 @@ namespace Birdy3d::core {
 
     int Application::option_int(IntOption option)
     {
-        return m_options_int[option];
+        auto it = m_options_int.find(option);
+        return it != m_options_int.end() ? it->second : 0;
     }
 
     void Application::option_int(IntOption option, int value)
@@ -303,6 +376,11 @@ namespace Birdy3d::core {
         return true;
     }
 
+    bool Application::is_main_thread()
+    {
+        return std::this_thread::get_id() == m_main_thread;
+    }
+
     void Application::defer_main(std::function<void()> function)
     {
         m_channel_main.push_task(function);
@@ -310,7 +388,15 @@ namespace Birdy3d::core {
 
     void Application::defer_loading(std::function<void()> function)
     {
-        m_channel_loading.push_task(function);
+        m_loading_queue.push([function = std::move(function)](std::stop_token) { function(); }, 0.0f);
+        JobSystem::wake();
+    }
+
+    LoadingTicket Application::defer_loading(std::function<void(std::stop_token)> function, float priority)
+    {
+        auto ticket = m_loading_queue.push(std::move(function), priority);
+        JobSystem::wake();
+        return ticket;
     }
 
 }
@@ -2,20 +2,52 @@
 
 #include "core/Base.hpp"
 #include "core/Forward.hpp"
+#include "core/LoadingQueue.hpp"
 #include "ecs/Forward.hpp"
 #include "events/Forward.hpp"
 #include "ui/Forward.hpp"
 #include "utils/Channel.hpp"
+#include <chrono>
+#include <deque>
+#include <thread>
 
 namespace Birdy3d::core {
 
     enum class BoolOption {
         VSYNC,
-        SHOW_COLLIDERS
+        SHOW_COLLIDERS,
+        HOT_RELOAD,
+        // Simulate the physics of a frame on a worker while the previous state of the scene is rendered
+        PIPELINED_SIMULATION,
+        // Load linked shader programs from an on-disk cache instead of compiling them
+        SHADER_CACHE,
+        // Rebuild the bounding volume hierarchy of the scene on a worker instead of during the simulation
+        BACKGROUND_BVH_REBUILD,
+        // Put the meshes into the shared buffers of the GeometryArena and draw whole passes with indirect draws. Only
+        // affects meshes that are created afterwards.
+        GEOMETRY_ARENA
     };
 
     enum class IntOption {
-        SHADOW_CASCADE_SIZE
+        SHADOW_CASCADE_SIZE,
+        RESOURCE_CPU_BUDGET,
+        RESOURCE_GPU_BUDGET,
+        // Time in microseconds the main thread may spend on deferred tasks per frame. 0 or less means unlimited.
+        MAIN_TASK_BUDGET
+    };
+
+    /**
+     * @brief Statistics of the tasks that were deferred to the main thread.
+     */
+    struct MainTaskStats {
+        // Tasks run in the last frame
+        std::size_t last_frame_tasks = 0;
+        // Tasks that were carried over to the next frame
+        std::size_t backlog = 0;
+        // Frames in which the tasks took longer than the budget
+        std::size_t overrun_frames = 0;
+        std::chrono::microseconds total_overrun{0};
+        std::chrono::microseconds max_overrun{0};
     };
 
     class Application {
@@ -39,19 +71,40 @@ namespace Birdy3d::core {
         static ui::Theme const& theme();
         static bool theme(std::string const&);
 
+        /**
+         * @returns whether the calling thread is the one that called init() and owns the OpenGL context
+         */
+        static bool is_main_thread();
+        /**
+         * @brief Runs a function on the main thread.
+         *
+         * Tasks run in the order they were deferred, between the update and the rendering of a frame. Tasks that don't
+         * fit into IntOption::MAIN_TASK_BUDGET are carried over to the next frame.
+         */
         static void defer_main(std::function<void()>);
+        static MainTaskStats const& main_task_stats() { return m_main_task_stats; }
         static void defer_loading(std::function<void()>);
+        /**
+         * @brief Runs a function on a worker of the JobSystem, once it has no other jobs.
+         * @param priority Tasks with a higher priority run first
+         * @returns ticket to reprioritize or cancel the task
+         */
+        static LoadingTicket defer_loading(std::function<void(std::stop_token)>, float priority = 0.0f);
 
     private:
         static GLFWwindow* m_window;
+        static std::thread::id m_main_thread;
         static std::unordered_map<BoolOption, bool> m_options_bool;
         static std::unordered_map<IntOption, int> m_options_int;
         static ResourceHandle<ui::Theme> m_theme;
 
         static Channel<std::function<void()>> m_channel_main;
-        static Channel<std::function<void()>> m_channel_loading;
-        static std::vector<std::thread> m_loading_threads;
+        // Tasks taken from m_channel_main that didn't fit into the budget of a previous frame
+        static std::deque<std::function<void()>> m_main_backlog;
+        static MainTaskStats m_main_task_stats;
+        static LoadingQueue m_loading_queue;
 
+        static void run_main_tasks();
         static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
         static void window_focus_callback(GLFWwindow* window, int focused);
         static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
@@ -7,6 +7,7 @@ namespace Birdy3d::core {
     class Logger;
     template <class T>
     class ResourceHandle;
+    class ResourceIdentifier;
     class ResourceManager;
 
 }
@@ -0,0 +1,184 @@
+#include "core/JobSystem.hpp"
+
+#include "core/LoadingQueue.hpp"
+
+namespace Birdy3d::core {
+
+    namespace {
+
+        // Index of the worker the current thread belongs to
+        thread_local std::size_t t_worker_index = static_cast<std::size_t>(-1);
+
+    }
+
+    std::vector<std::unique_ptr<JobSystem::Worker>> JobSystem::m_workers;
+    std::mutex JobSystem::m_injected_mutex;
+    std::deque<JobHandle> JobSystem::m_injected;
+    LoadingQueue* JobSystem::m_loading_queue = nullptr;
+    std::mutex JobSystem::m_sleep_mutex;
+    std::condition_variable JobSystem::m_sleep_convar;
+    std::size_t JobSystem::m_wake_count = 0;
+    std::atomic<bool> JobSystem::m_running = false;
+
+    void JobSystem::init(LoadingQueue& loading_queue, std::size_t worker_count)
+    {
+        if (worker_count == 0) {
+            auto hardware_concurrency = std::thread::hardware_concurrency();
+            worker_count = hardware_concurrency > 1 ? hardware_concurrency - 1 : 1;
+        }
+
+        m_loading_queue = &loading_queue;
+        m_running = true;
+        // All workers have to exist before any of them tries to steal.
+        for (std::size_t i = 0; i < worker_count; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+        for (std::size_t i = 0; i < worker_count; ++i)
+            m_workers[i]->thread = std::thread(worker_main, i);
+    }
+
+    void JobSystem::cleanup()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_sleep_mutex};
+            m_running = false;
+        }
+        m_sleep_convar.notify_all();
+        for (auto& worker : m_workers)
+            worker->thread.join();
+        m_workers.clear();
+        std::lock_guard<std::mutex> lock{m_injected_mutex};
+        m_injected.clear();
+    }
+
+    JobHandle JobSystem::create(std::function<void()> function, JobHandle const& parent)
+    {
+        if (parent)
+            parent->m_unfinished.fetch_add(1, std::memory_order_relaxed);
+        return std::make_shared<Job>(std::move(function), parent);
+    }
+
+    void JobSystem::run(JobHandle const& job)
+    {
+        if (t_worker_index < m_workers.size()) {
+            auto& worker = *m_workers[t_worker_index];
+            std::lock_guard<std::mutex> lock{worker.mutex};
+            worker.jobs.push_back(job);
+        } else {
+            std::lock_guard<std::mutex> lock{m_injected_mutex};
+            m_injected.push_back(job);
+        }
+        wake();
+    }
+
+    void JobSystem::wait(JobHandle const& job)
+    {
+        while (!job->finished()) {
+            if (auto other = next_job())
+                execute(other);
+            else
+                std::this_thread::yield();
+        }
+        if (job->m_exception)
+            std::rethrow_exception(job->m_exception);
+    }
+
+    void JobSystem::wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_sleep_mutex};
+            m_wake_count++;
+        }
+        m_sleep_convar.notify_one();
+    }
+
+    void JobSystem::worker_main(std::size_t index)
+    {
+        t_worker_index = index;
+        while (m_running) {
+            std::size_t wake_count;
+            {
+                std::lock_guard<std::mutex> lock{m_sleep_mutex};
+                wake_count = m_wake_count;
+            }
+
+            if (auto job = next_job()) {
+                execute(job);
+                continue;
+            }
+            // Loading tasks can block on IO for a long time, so they only run when there are no jobs.
+            if (auto task = m_loading_queue->try_get()) {
+                task.value()();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock{m_sleep_mutex};
+            m_sleep_convar.wait(lock, [&]() { return m_wake_count != wake_count || !m_running; });
+        }
+    }
+
+    JobHandle JobSystem::next_job()
+    {
+        auto worker_count = m_workers.size();
+        if (t_worker_index < worker_count) {
+            auto& worker = *m_workers[t_worker_index];
+            std::lock_guard<std::mutex> lock{worker.mutex};
+            if (!worker.jobs.empty()) {
+                auto job = std::move(worker.jobs.back());
+                worker.jobs.pop_back();
+                return job;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_injected_mutex};
+            if (!m_injected.empty()) {
+                auto job = std::move(m_injected.front());
+                m_injected.pop_front();
+                return job;
+            }
+        }
+
+        // Steal the oldest job, starting with the next worker to spread the thieves.
+        auto start = t_worker_index < worker_count ? t_worker_index + 1 : 0;
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            auto& victim = *m_workers[(start + i) % worker_count];
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            if (!victim.jobs.empty()) {
+                auto job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void JobSystem::execute(JobHandle const& job)
+    {
+        // The job has to finish either way, otherwise its waiters never return.
+        try {
+            job->m_function();
+        } catch (...) {
+            fail(*job, std::current_exception());
+        }
+        finish(*job);
+    }
+
+    void JobSystem::fail(Job& job, std::exception_ptr exception)
+    {
+        // Stored up to the root, so that waiting for any of the ancestors rethrows it.
+        for (auto* current = &job; current; current = current->m_parent.get()) {
+            std::lock_guard<std::mutex> lock{current->m_exception_mutex};
+            if (!current->m_exception)
+                current->m_exception = exception;
+        }
+    }
+
+    void JobSystem::finish(Job& job)
+    {
+        if (job.m_unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        if (job.m_parent)
+            finish(*job.m_parent);
+    }
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Birdy3d::core {
+
+    class LoadingQueue;
+
+    /**
+     * @brief Unit of work for the JobSystem. A job is finished once its function and all of its children have finished.
+     *
+     * An exception thrown by the function or by one of the children is kept in the job until it finished.
+     */
+    class Job {
+    public:
+        Job(std::function<void()> function, std::shared_ptr<Job> parent)
+            : m_function(std::move(function))
+            , m_parent(std::move(parent))
+        { }
+
+        [[nodiscard]] bool finished() const { return m_unfinished.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::function<void()> m_function;
+        std::shared_ptr<Job> m_parent;
+        // The job itself and its unfinished children
+        std::atomic<std::size_t> m_unfinished = 1;
+        // First exception of the job or its children, only read once the job finished
+        std::mutex m_exception_mutex;
+        std::exception_ptr m_exception;
+    };
+
+    using JobHandle = std::shared_ptr<Job>;
+
+    /**
+     * @brief Pool of worker threads with one job deque per worker and work stealing.
+     *
+     * Workers run their own jobs newest first and steal the oldest jobs of other workers when they run out.
+     * Idle workers run the tasks of the loading queue, so resource loading shares the pool with all other jobs.
+     * Waiting for a job runs other jobs in the meantime, so jobs and the main thread can wait for children without
+     * blocking a worker.
+     */
+    class JobSystem {
+    public:
+        /**
+         * @brief Starts the workers.
+         * @param loading_queue Queue whose tasks the workers run when they have no jobs
+         * @param worker_count Amount of worker threads. 0 uses one less than the hardware concurrency, leaving a core for the main thread.
+         */
+        static void init(LoadingQueue& loading_queue, std::size_t worker_count = 0);
+
+        /**
+         * @brief Stops and joins the workers. Jobs that didn't start yet are discarded.
+         */
+        static void cleanup();
+
+        [[nodiscard]] static std::size_t worker_count() { return m_workers.size(); }
+        /// @returns whether the workers were started and not stopped yet
+        [[nodiscard]] static bool running() { return m_running.load(); }
+
+        /**
+         * @brief Creates a job without running it.
+         * @param parent The parent doesn't finish before this job. It must not have finished yet.
+         */
+        static JobHandle create(std::function<void()> function, JobHandle const& parent = {});
+
+        /**
+         * @brief Queues a job created with create().
+         */
+        static void run(JobHandle const& job);
+
+        static JobHandle run(std::function<void()> function, JobHandle const& parent = {})
+        {
+            auto job = create(std::move(function), parent);
+            run(job);
+            return job;
+        }
+
+        /**
+         * @brief Runs other jobs until the job and all of its children have finished.
+         *
+         * Jobs that were discarded by cleanup() never finish, so this must not be called for them.
+         * @throws the first exception that the job or one of its children threw
+         */
+        static void wait(JobHandle const& job);
+
+        /**
+         * @brief Calls function(i) for every i in [0, count) and waits until all calls have returned.
+         *
+         * Runs inline if there are no workers or the range fits into one batch.
+         * @param batch_size Amount of indices per job. 0 splits the range evenly into a few jobs per worker.
+         */
+        template <typename F>
+        static void parallel_for(std::size_t count, F const& function, std::size_t batch_size = 0)
+        {
+            if (count == 0)
+                return;
+            if (batch_size == 0)
+                batch_size = std::max<std::size_t>(1, count / ((m_workers.size() + 1) * 4));
+            if (m_workers.empty() || count <= batch_size) {
+                for (std::size_t i = 0; i < count; ++i)
+                    function(i);
+                return;
+            }
+
+            auto root = create([]() { });
+            for (std::size_t begin = batch_size; begin < count; begin += batch_size) {
+                auto end = std::min(begin + batch_size, count);
+                run([&function, begin, end]() {
+                    for (std::size_t i = begin; i < end; ++i)
+                        function(i);
+                },
+                    root);
+            }
+            run(root);
+            // The calling thread takes the first batch itself. The other batches reference the function, so they have
+            // to finish even if this one throws.
+            std::exception_ptr exception;
+            try {
+                for (std::size_t i = 0; i < batch_size; ++i)
+                    function(i);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            wait(root);
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+
+        /**
+         * @brief Wakes an idle worker, e.g. after a loading task was queued.
+         */
+        static void wake();
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<JobHandle> jobs;
+            std::thread thread;
+        };
+
+        static std::vector<std::unique_ptr<Worker>> m_workers;
+        // Jobs queued by threads that aren't workers
+        static std::mutex m_injected_mutex;
+        static std::deque<JobHandle> m_injected;
+        static LoadingQueue* m_loading_queue;
+
+        static std::mutex m_sleep_mutex;
+        static std::condition_variable m_sleep_convar;
+        // Incremented whenever there may be new work, guarded by m_sleep_mutex
+        static std::size_t m_wake_count;
+        static std::atomic<bool> m_running;
+
+        static void worker_main(std::size_t index);
+        static JobHandle next_job();
+        static void execute(JobHandle const& job);
+        static void fail(Job& job, std::exception_ptr exception);
+        static void finish(Job& job);
+    };
+
+}
@@ -0,0 +1,129 @@
+#include "core/LoadingQueue.hpp"
+
+namespace Birdy3d::core {
+
+    void LoadingTicket::priority(float priority) const
+    {
+        if (m_task)
+            m_task->queue->reprioritize(m_task, priority);
+    }
+
+    void LoadingTicket::cancel() const
+    {
+        if (!m_task)
+            return;
+        // The task stays in the queue until a worker pops and skips it.
+        m_task->stop_source.request_stop();
+    }
+
+    bool LoadingTicket::cancelled() const
+    {
+        return m_task && m_task->stop_source.stop_requested();
+    }
+
+    LoadingTicket LoadingQueue::push(std::function<void(std::stop_token)> function, float priority)
+    {
+        auto task = std::make_shared<LoadingTicket::Task>();
+        task->function = std::move(function);
+        task->queue = this;
+        task->priority = priority;
+        std::lock_guard<std::mutex> lock{m_mutex};
+        task->sequence = m_sequence++;
+        place(m_heap.size(), task);
+        sift_up(m_heap.size() - 1);
+        return LoadingTicket{task};
+    }
+
+    std::optional<std::function<void()>> LoadingQueue::try_get()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        while (m_is_open && !m_heap.empty()) {
+            auto task = pop();
+            if (task->stop_source.stop_requested())
+                continue;
+            return [task = std::move(task)]() {
+                task->function(task->stop_source.get_token());
+            };
+        }
+        return {};
+    }
+
+    void LoadingQueue::close()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_is_open = false;
+    }
+
+    void LoadingQueue::reprioritize(std::shared_ptr<LoadingTicket::Task> const& task, float priority)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (task->heap_index == NOT_QUEUED || task->priority == priority || task->stop_source.stop_requested())
+            return;
+        bool raised = priority > task->priority;
+        task->priority = priority;
+        if (raised)
+            sift_up(task->heap_index);
+        else
+            sift_down(task->heap_index);
+    }
+
+    bool LoadingQueue::runs_before(LoadingTicket::Task const& a, LoadingTicket::Task const& b)
+    {
+        if (a.priority != b.priority)
+            return a.priority > b.priority;
+        return a.sequence < b.sequence;
+    }
+
+    void LoadingQueue::place(std::size_t index, TaskPtr task)
+    {
+        task->heap_index = index;
+        if (index == m_heap.size())
+            m_heap.push_back(std::move(task));
+        else
+            m_heap[index] = std::move(task);
+    }
+
+    void LoadingQueue::sift_up(std::size_t index)
+    {
+        auto task = std::move(m_heap[index]);
+        while (index > 0) {
+            auto parent = (index - 1) / 2;
+            if (!runs_before(*task, *m_heap[parent]))
+                break;
+            place(index, std::move(m_heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(task));
+    }
+
+    void LoadingQueue::sift_down(std::size_t index)
+    {
+        auto task = std::move(m_heap[index]);
+        while (true) {
+            auto child = index * 2 + 1;
+            if (child >= m_heap.size())
+                break;
+            if (child + 1 < m_heap.size() && runs_before(*m_heap[child + 1], *m_heap[child]))
+                ++child;
+            if (!runs_before(*m_heap[child], *task))
+                break;
+            place(index, std::move(m_heap[child]));
+            index = child;
+        }
+        place(index, std::move(task));
+    }
+
+    LoadingQueue::TaskPtr LoadingQueue::pop()
+    {
+        auto top = std::move(m_heap.front());
+        top->heap_index = NOT_QUEUED;
+        auto last = std::move(m_heap.back());
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            place(0, std::move(last));
+            sift_down(0);
+        }
+        return top;
+    }
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+namespace Birdy3d::core {
+
+    class LoadingQueue;
+
+    /**
+     * @brief Handle to a task in a LoadingQueue, which can be used to reprioritize or cancel it.
+     *
+     * An empty ticket ignores all calls.
+     */
+    class LoadingTicket {
+    public:
+        LoadingTicket() = default;
+
+        /**
+         * @brief Changes the priority of the task, if it hasn't started yet. Tasks with a higher priority run first.
+         */
+        void priority(float) const;
+        /**
+         * @brief Requests the task to stop. A task that hasn't started yet will never run.
+         */
+        void cancel() const;
+        [[nodiscard]] bool cancelled() const;
+        explicit operator bool() const { return static_cast<bool>(m_task); }
+
+    private:
+        friend class LoadingQueue;
+
+        struct Task {
+            std::function<void(std::stop_token)> function;
+            std::stop_source stop_source;
+            LoadingQueue* queue;
+            // Guarded by the queue mutex
+            float priority;
+            std::uint64_t sequence = 0;
+            // Position in the heap of the queue, NOT_QUEUED once the task was taken
+            std::size_t heap_index = 0;
+        };
+
+        std::shared_ptr<Task> m_task;
+
+        LoadingTicket(std::shared_ptr<Task> task)
+            : m_task(std::move(task))
+        { }
+    };
+
+    /**
+     * @brief Thread-safe priority queue of loading tasks.
+     *
+     * Tasks with the same priority run in the order they were pushed. The tasks know their position in the heap, so
+     * changing the priority moves them in place and the heap never holds more entries than tasks.
+     */
+    class LoadingQueue {
+    public:
+        /**
+         * @param function The task. It should check the stop token between expensive steps.
+         * @param priority Tasks with a higher priority run first
+         */
+        LoadingTicket push(std::function<void(std::stop_token)> function, float priority);
+
+        /**
+         * @brief Takes the task with the highest priority, skipping cancelled ones.
+         * @returns the task, bound to its stop token, or nothing if the queue is empty or closed
+         */
+        std::optional<std::function<void()>> try_get();
+
+        void close();
+
+    private:
+        friend class LoadingTicket;
+
+        using TaskPtr = std::shared_ptr<LoadingTicket::Task>;
+
+        static constexpr std::size_t NOT_QUEUED = static_cast<std::size_t>(-1);
+
+        // Binary max heap ordered by runs_before()
+        std::vector<TaskPtr> m_heap;
+        std::mutex m_mutex;
+        std::uint64_t m_sequence = 0;
+        bool m_is_open = true;
+
+        void reprioritize(TaskPtr const&, float priority);
+        static bool runs_before(LoadingTicket::Task const&, LoadingTicket::Task const&);
+        void place(std::size_t index, TaskPtr task);
+        void sift_up(std::size_t index);
+        void sift_down(std::size_t index);
+        TaskPtr pop();
+    };
+
+}
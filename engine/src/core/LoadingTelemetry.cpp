@@ -0,0 +1,118 @@
+#include "core/LoadingTelemetry.hpp"
+
+#include <algorithm>
+
+namespace Birdy3d::core {
+
+    float LoadingProgress::fraction() const
+    {
+        auto total = pending + complete + failed;
+        if (total == 0)
+            return 1.0f;
+        return static_cast<float>(complete + failed) / static_cast<float>(total);
+    }
+
+    void LoadingTelemetry::begin(ResourceIdentifier const& id, LoadPhase phase)
+    {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto [it, inserted] = m_records.try_emplace(id);
+        auto& record = it->second;
+        if (inserted || record.stats.complete || record.stats.failed) {
+            // A resource that is loaded again after it was evicted
+            record = Record{};
+            record.stats.id = id;
+        } else {
+            end_phase(record, now);
+        }
+        record.phase = phase;
+        record.phase_start = now;
+    }
+
+    void LoadingTelemetry::complete(ResourceIdentifier const& id, ResourceMemory memory)
+    {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto it = m_records.find(id);
+        if (it == m_records.end() || it->second.stats.complete || it->second.stats.failed)
+            return;
+        end_phase(it->second, now);
+        it->second.stats.memory = memory;
+        it->second.stats.complete = true;
+    }
+
+    void LoadingTelemetry::fail(ResourceIdentifier const& id)
+    {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto it = m_records.find(id);
+        if (it == m_records.end() || it->second.stats.complete || it->second.stats.failed)
+            return;
+        end_phase(it->second, now);
+        it->second.stats.failed = true;
+    }
+
+    void LoadingTelemetry::cancel(ResourceIdentifier const& id)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto it = m_records.find(id);
+        if (it != m_records.end() && !it->second.stats.complete && !it->second.stats.failed)
+            m_records.erase(it);
+    }
+
+    void LoadingTelemetry::reset()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::erase_if(m_records, [](auto const& entry) { return entry.second.stats.complete || entry.second.stats.failed; });
+    }
+
+    LoadingProgress LoadingTelemetry::progress() const
+    {
+        LoadingProgress progress;
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (auto const& [id, record] : m_records) {
+            if (record.stats.complete)
+                progress.complete++;
+            else if (record.stats.failed)
+                progress.failed++;
+            else
+                progress.pending++;
+        }
+        return progress;
+    }
+
+    std::vector<ResourceLoadStats> LoadingTelemetry::slowest(std::size_t count) const
+    {
+        std::vector<ResourceLoadStats> result;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            for (auto const& [id, record] : m_records) {
+                if (record.stats.complete || record.stats.failed)
+                    result.push_back(record.stats);
+            }
+        }
+        auto end = result.begin() + std::min(count, result.size());
+        std::partial_sort(result.begin(), end, result.end(), [](ResourceLoadStats const& a, ResourceLoadStats const& b) {
+            return a.total_time() > b.total_time();
+        });
+        result.erase(end, result.end());
+        return result;
+    }
+
+    void LoadingTelemetry::end_phase(Record& record, Clock::time_point now)
+    {
+        auto duration = now - record.phase_start;
+        switch (record.phase) {
+        case LoadPhase::QUEUED:
+            record.stats.queue_wait += duration;
+            break;
+        case LoadPhase::DECODING:
+            record.stats.decode_time += duration;
+            break;
+        case LoadPhase::UPLOADING:
+            record.stats.upload_time += duration;
+            break;
+        }
+    }
+
+}
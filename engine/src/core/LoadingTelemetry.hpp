@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/ResourceIdentifier.hpp"
+#include "core/ResourceStorage.hpp"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Birdy3d::core {
+
+    enum class LoadPhase {
+        QUEUED,
+        DECODING,
+        UPLOADING,
+    };
+
+    /**
+     * @brief Timings and memory of a single resource load.
+     */
+    struct ResourceLoadStats {
+        ResourceIdentifier id;
+        // Time spent waiting in the loading queue and the main thread queue
+        std::chrono::nanoseconds queue_wait{0};
+        // Time spent reading, decoding or generating the resource
+        std::chrono::nanoseconds decode_time{0};
+        // Time spent creating the OpenGL objects
+        std::chrono::nanoseconds upload_time{0};
+        ResourceMemory memory;
+        bool complete = false;
+        bool failed = false;
+
+        [[nodiscard]] std::chrono::nanoseconds total_time() const { return queue_wait + decode_time + upload_time; }
+    };
+
+    struct LoadingProgress {
+        std::size_t pending = 0;
+        std::size_t complete = 0;
+        std::size_t failed = 0;
+
+        /**
+         * @returns the finished fraction of all loads in [0, 1]. 1 if nothing was loaded.
+         */
+        [[nodiscard]] float fraction() const;
+    };
+
+    /**
+     * @brief Thread-safe record of resource loads.
+     *
+     * A load moves through the phases in any order, the time between two calls is added to the phase that ended.
+     */
+    class LoadingTelemetry {
+    public:
+        /**
+         * @brief Starts a phase of a load. Starts a new record, if the resource isn't being loaded.
+         */
+        void begin(ResourceIdentifier const& id, LoadPhase phase);
+
+        /**
+         * @brief Ends the current phase and marks the load as complete.
+         */
+        void complete(ResourceIdentifier const& id, ResourceMemory memory);
+
+        /**
+         * @brief Ends the current phase and marks the load as failed.
+         */
+        void fail(ResourceIdentifier const& id);
+
+        /**
+         * @brief Forgets a load that was cancelled.
+         */
+        void cancel(ResourceIdentifier const& id);
+
+        /**
+         * @brief Forgets all finished loads. Pending loads are kept.
+         */
+        void reset();
+
+        [[nodiscard]] LoadingProgress progress() const;
+
+        /**
+         * @param count maximum amount of results
+         * @returns the finished loads with the longest total time, slowest first
+         */
+        [[nodiscard]] std::vector<ResourceLoadStats> slowest(std::size_t count) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Record {
+            ResourceLoadStats stats;
+            LoadPhase phase = LoadPhase::QUEUED;
+            Clock::time_point phase_start;
+        };
+
+        std::mutex mutable m_mutex;
+        std::unordered_map<ResourceIdentifier, Record> m_records;
+
+        static void end_phase(Record&, Clock::time_point now);
+    };
+
+}
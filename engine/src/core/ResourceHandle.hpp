@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/Application.hpp"
+#include "core/ResourceIdentifier.hpp"
 #include "events/EventBus.hpp"
 #include "events/ResourceEvents.hpp"
 #include "physics/Forward.hpp"
@@ -9,31 +10,10 @@
 #include "utils/serializer/Adapter.hpp"
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace Birdy3d::core {
 
-    enum class ResourceType {
-        SHADER,
-        TEXTURE,
-        THEME,
-        MODEL,
-        FONT
-    };
-
-    class ResourceIdentifier {
-    public:
-        ResourceType type;
-        std::string source;
-        std::string name;
-        std::map<std::string, std::string> args;
-
-        ResourceIdentifier() = default;
-        ResourceIdentifier(std::string);
-        ResourceIdentifier(char const* str);
-        bool operator==(ResourceIdentifier const&) const;
-        [[nodiscard]] std::string to_string(bool include_args = true) const;
-    };
-
     template <class T>
     class ResourceHandle {
     public:
@@ -43,29 +23,94 @@ namespace Birdy3d::core {
         {
             load(m_resource_id);
         }
+
+        ResourceHandle(ResourceHandle const& other)
+            : m_resource_id(other.m_resource_id)
+            , m_resource_index(other.m_resource_index)
+            , m_new_resource_index(other.m_new_resource_index)
+        {
+            retain(m_resource_index);
+            retain(m_new_resource_index);
+        }
+
+        ResourceHandle(ResourceHandle&& other)
+            : m_resource_id(std::move(other.m_resource_id))
+            , m_resource_index(std::exchange(other.m_resource_index, {}))
+            , m_new_resource_index(std::exchange(other.m_new_resource_index, {}))
+        { }
+
+        ~ResourceHandle()
+        {
+            release(m_resource_index);
+            release(m_new_resource_index);
+        }
+
+        ResourceHandle& operator=(ResourceHandle const& other)
+        {
+            if (this != &other) {
+                retain(other.m_resource_index);
+                retain(other.m_new_resource_index);
+                release(m_resource_index);
+                release(m_new_resource_index);
+                m_resource_id = other.m_resource_id;
+                m_resource_index = other.m_resource_index;
+                m_new_resource_index = other.m_new_resource_index;
+            }
+            return *this;
+        }
+
+        ResourceHandle& operator=(ResourceHandle&& other)
+        {
+            if (this != &other) {
+                release(m_resource_index);
+                release(m_new_resource_index);
+                m_resource_id = std::move(other.m_resource_id);
+                m_resource_index = std::exchange(other.m_resource_index, {});
+                m_new_resource_index = std::exchange(other.m_new_resource_index, {});
+            }
+            return *this;
+        }
+
         T const& operator*() const { return *ptr(); }
         T const* operator->() const { return ptr(); }
         explicit operator std::string() const { return m_resource_id.to_string(); }
         explicit operator bool() const { return static_cast<bool>(ptr()); }
         bool load() { return load(m_resource_id); }
         ResourceIdentifier const& id() { return m_resource_id; }
-        [[nodiscard]] T const* ptr() const { return nullptr; }
+        [[nodiscard]] T const* ptr() const;
+        /**
+         * @brief Like ptr(), but doesn't switch to a reloaded version of the resource, so it never releases the
+         * previous one. Can be used outside of the main thread, as long as the main thread doesn't use the handle.
+         */
+        [[nodiscard]] T const* peek() const;
+        /// @returns whether a resource is being loaded, false once its load failed
+        [[nodiscard]] bool loading() const { return m_new_resource_index.has_value() && !failed(m_new_resource_index.value()); }
+
+        /**
+         * @brief Changes the priority of the background task loading the resource, if there is one.
+         * @param priority Resources with a higher priority are loaded first
+         */
+        void priority(float priority) const
+        {
+            if (m_new_resource_index.has_value())
+                prioritize(m_new_resource_index.value(), priority);
+        }
 
         bool operator=(ResourceIdentifier new_id)
         {
             return load(new_id);
         }
 
-        std::string arg(std::string key)
+        std::string arg(std::string const& key)
         {
-            return m_resource_id.args[key];
+            return m_resource_id.arg(key);
         }
 
         void arg(std::string key, std::string value)
         {
-            auto old = m_resource_id.args[key];
-            m_resource_id.args[key] = value;
-            if (old != value)
+            auto old = m_resource_id;
+            m_resource_id.arg(std::move(key), std::move(value));
+            if (old != m_resource_id)
                 load();
         }
 
@@ -76,28 +121,55 @@ namespace Birdy3d::core {
 
     private:
         ResourceIdentifier m_resource_id;
+        // Both indices hold a reference to their resource.
         std::optional<std::size_t> mutable m_resource_index;
         std::optional<std::size_t> mutable m_new_resource_index;
 
         bool load(ResourceIdentifier const&) { return false; }
 
+        /**
+         * @brief Replaces the resource that is currently being loaded with a new one.
+         * @param index index of the new resource, which already holds a reference
+         */
+        void replace_new_resource(std::size_t index)
+        {
+            if (m_new_resource_index.has_value()) {
+                if (get(m_new_resource_index.value())) {
+                    release(m_resource_index);
+                    m_resource_index = m_new_resource_index;
+                } else {
+                    release(m_new_resource_index);
+                }
+            }
+            m_new_resource_index = index;
+        }
+
+        static T const* get(std::size_t index);
+        static bool failed(std::size_t index);
+        static void retain(std::size_t index);
+        static void release(std::size_t index);
+        static void prioritize(std::size_t index, float priority);
+        // Moves the index to the newest version of a reloaded resource.
+        static void follow_successors(std::optional<std::size_t>& index);
+
+        static void retain(std::optional<std::size_t> const& index)
+        {
+            if (index.has_value())
+                retain(index.value());
+        }
+
+        static void release(std::optional<std::size_t> const& index)
+        {
+            if (index.has_value())
+                release(index.value());
+        }
+
         void notify_load()
         {
             core::Application::event_bus->emit<events::ResourceLoadEvent>();
         }
     };
 
-    template <>
-    [[nodiscard]] render::Shader const* ResourceHandle<render::Shader>::ptr() const;
-    template <>
-    [[nodiscard]] ui::Theme const* ResourceHandle<ui::Theme>::ptr() const;
-    template <>
-    [[nodiscard]] render::Model const* ResourceHandle<render::Model>::ptr() const;
-    template <>
-    [[nodiscard]] render::Texture const* ResourceHandle<render::Texture>::ptr() const;
-    template <>
-    [[nodiscard]] physics::Collider const* ResourceHandle<physics::Collider>::ptr() const;
-
     template <>
     bool ResourceHandle<render::Shader>::load(ResourceIdentifier const& new_id);
     template <>
@@ -109,6 +181,12 @@ namespace Birdy3d::core {
     template <>
     bool ResourceHandle<physics::Collider>::load(ResourceIdentifier const& new_name);
 
+    extern template class ResourceHandle<render::Shader>;
+    extern template class ResourceHandle<ui::Theme>;
+    extern template class ResourceHandle<render::Model>;
+    extern template class ResourceHandle<render::Texture>;
+    extern template class ResourceHandle<physics::Collider>;
+
 }
 
 namespace Birdy3d::serializer {
@@ -0,0 +1,234 @@
+#include "core/ResourceIdentifier.hpp"
+
+#include "core/Logger.hpp"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Birdy3d::core {
+
+    struct ResourceIdentifier::Data {
+        ResourceType type = ResourceType::SHADER;
+        std::string source;
+        std::string name;
+        std::map<std::string, std::string> args;
+
+        // Derived from the fields above by intern()
+        std::uint64_t hash = 0;
+        std::string location;
+        std::string string;
+
+        [[nodiscard]] bool same_identity(Data const& other) const
+        {
+            return type == other.type
+                && source == other.source
+                && name == other.name
+                && args == other.args;
+        }
+    };
+
+    namespace {
+
+        // 64-bit FNV-1a
+        std::uint64_t hash_bytes(std::string_view bytes, std::uint64_t hash = 14695981039346656037ull)
+        {
+            for (unsigned char c : bytes) {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        struct StringViewHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view string) const noexcept
+            {
+                return hash_bytes(string);
+            }
+        };
+
+    }
+
+    ResourceIdentifier::ResourceIdentifier()
+    {
+        static Data const* const EMPTY = intern({});
+        m_data = EMPTY;
+    }
+
+    ResourceIdentifier::ResourceIdentifier(std::string_view full_name)
+        : m_data(parse(full_name))
+    { }
+
+    ResourceIdentifier::ResourceIdentifier(std::string const& full_name)
+        : m_data(parse(full_name))
+    { }
+
+    ResourceIdentifier::ResourceIdentifier(char const* full_name)
+        : m_data(parse(full_name))
+    { }
+
+    ResourceType ResourceIdentifier::type() const
+    {
+        return m_data->type;
+    }
+
+    void ResourceIdentifier::type(ResourceType type)
+    {
+        auto data = *m_data;
+        data.type = type;
+        m_data = intern(std::move(data));
+    }
+
+    std::string const& ResourceIdentifier::source() const
+    {
+        return m_data->source;
+    }
+
+    void ResourceIdentifier::source(std::string source)
+    {
+        auto data = *m_data;
+        data.source = std::move(source);
+        m_data = intern(std::move(data));
+    }
+
+    std::string const& ResourceIdentifier::name() const
+    {
+        return m_data->name;
+    }
+
+    void ResourceIdentifier::name(std::string name)
+    {
+        auto data = *m_data;
+        data.name = std::move(name);
+        m_data = intern(std::move(data));
+    }
+
+    std::map<std::string, std::string> const& ResourceIdentifier::args() const
+    {
+        return m_data->args;
+    }
+
+    std::string ResourceIdentifier::arg(std::string const& key) const
+    {
+        auto it = m_data->args.find(key);
+        if (it == m_data->args.end())
+            return {};
+        return it->second;
+    }
+
+    void ResourceIdentifier::arg(std::string key, std::string value)
+    {
+        auto it = m_data->args.find(key);
+        if (it != m_data->args.end() && it->second == value)
+            return;
+        auto data = *m_data;
+        data.args[std::move(key)] = std::move(value);
+        m_data = intern(std::move(data));
+    }
+
+    void ResourceIdentifier::remove_arg(std::string const& key)
+    {
+        if (!m_data->args.contains(key))
+            return;
+        auto data = *m_data;
+        data.args.erase(key);
+        m_data = intern(std::move(data));
+    }
+
+    std::uint64_t ResourceIdentifier::hash() const
+    {
+        return m_data->hash;
+    }
+
+    bool ResourceIdentifier::operator==(ResourceIdentifier const& other) const
+    {
+        // Interned data is unique
+        return m_data == other.m_data;
+    }
+
+    std::string const& ResourceIdentifier::to_string(bool include_args) const
+    {
+        return include_args ? m_data->string : m_data->location;
+    }
+
+    ResourceIdentifier::Data const* ResourceIdentifier::parse(std::string_view full_name)
+    {
+        // Remembers every spelling that was parsed before, so that e.g. the default textures of a Material are found without allocating.
+        static std::mutex spellings_mutex;
+        static std::unordered_map<std::string, Data const*, StringViewHash, std::equal_to<>> spellings;
+
+        {
+            std::lock_guard<std::mutex> lock{spellings_mutex};
+            if (auto it = spellings.find(full_name); it != spellings.end())
+                return it->second;
+        }
+
+        std::vector<std::string_view> parts;
+        std::size_t last_pos = 0;
+        std::size_t current_pos = full_name.find_first_of(':');
+        while (last_pos != std::string_view::npos) {
+            parts.push_back(full_name.substr(last_pos, current_pos - last_pos));
+            last_pos = current_pos == std::string_view::npos ? current_pos : current_pos + 1;
+            current_pos = full_name.find_first_of(':', current_pos + 1);
+        }
+
+        Data data;
+        std::size_t args_start = std::string_view::npos;
+        if (parts.size() >= 3 && parts[1] == "") {
+            data.source = parts[0];
+            data.name = parts[2];
+            args_start = 3;
+        } else if (parts.size() >= 1) {
+            data.name = parts[0];
+            args_start = 1;
+        }
+
+        if (parts.size() >= args_start) {
+            for (auto it = parts.begin() + args_start; it != parts.end(); it++) {
+                if (it->empty()) {
+                    core::Logger::warn("Invalid ResourceIdentifier: '{}'", full_name);
+                    continue;
+                }
+                auto equalpos = it->find_first_of('=');
+                if (equalpos == std::string_view::npos || equalpos == 0) {
+                    core::Logger::warn("Invalid ResourceIdentifier: '{}'", full_name);
+                    continue;
+                }
+                data.args[std::string{it->substr(0, equalpos)}] = it->substr(equalpos + 1);
+            }
+        }
+
+        auto interned = intern(std::move(data));
+
+        std::lock_guard<std::mutex> lock{spellings_mutex};
+        spellings.emplace(full_name, interned);
+        return interned;
+    }
+
+    ResourceIdentifier::Data const* ResourceIdentifier::intern(Data data)
+    {
+        static std::mutex table_mutex;
+        // Interned data is never freed, so the pointers stay valid for the lifetime of the program.
+        static std::unordered_map<std::uint64_t, std::vector<std::unique_ptr<Data>>> table;
+
+        data.location = data.source + "::" + data.name;
+        data.string = data.location;
+        for (auto const& [key, value] : data.args)
+            data.string += ":" + key + "=" + value;
+
+        auto type = static_cast<unsigned char>(data.type);
+        data.hash = hash_bytes(data.string, hash_bytes({reinterpret_cast<char const*>(&type), 1}));
+
+        std::lock_guard<std::mutex> lock{table_mutex};
+        auto& candidates = table[data.hash];
+        for (auto const& candidate : candidates) {
+            if (candidate->same_identity(data))
+                return candidate.get();
+        }
+        candidates.push_back(std::make_unique<Data>(std::move(data)));
+        return candidates.back().get();
+    }
+
+}
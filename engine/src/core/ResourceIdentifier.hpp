@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace Birdy3d::core {
+
+    enum class ResourceType {
+        SHADER,
+        TEXTURE,
+        THEME,
+        MODEL,
+        FONT,
+        COLLIDER
+    };
+
+    /**
+     * @brief Identifies a resource by source, name and arguments, e.g. "primitive::uv_sphere:resolution=10".
+     *
+     * Identifiers are interned: equal identifiers share the same immutable data, so copying and comparing them doesn't
+     * allocate and the 64-bit hash is only computed once. Parsing a string that was seen before doesn't allocate either.
+     * Modifying an identifier interns a new one.
+     */
+    class ResourceIdentifier {
+    public:
+        ResourceIdentifier();
+        ResourceIdentifier(std::string_view);
+        ResourceIdentifier(std::string const&);
+        ResourceIdentifier(char const* str);
+
+        [[nodiscard]] ResourceType type() const;
+        void type(ResourceType);
+        [[nodiscard]] std::string const& source() const;
+        void source(std::string);
+        [[nodiscard]] std::string const& name() const;
+        void name(std::string);
+        [[nodiscard]] std::map<std::string, std::string> const& args() const;
+        /// @returns the value of the argument or an empty string
+        [[nodiscard]] std::string arg(std::string const& key) const;
+        void arg(std::string key, std::string value);
+        void remove_arg(std::string const& key);
+
+        [[nodiscard]] std::uint64_t hash() const;
+        bool operator==(ResourceIdentifier const&) const;
+        [[nodiscard]] std::string const& to_string(bool include_args = true) const;
+
+    private:
+        struct Data;
+        Data const* m_data;
+
+        static Data const* parse(std::string_view);
+        static Data const* intern(Data);
+    };
+
+}
+
+template <>
+struct std::hash<Birdy3d::core::ResourceIdentifier> {
+    std::size_t operator()(Birdy3d::core::ResourceIdentifier const& id) const noexcept
+    {
+        return id.hash();
+    }
+};
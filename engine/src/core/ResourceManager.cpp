@@ -8,11 +8,13 @@
 #include "render/Shader.hpp"
 #include "render/Texture.hpp"
 #include "ui/Theme.hpp"
+#include "utils/FileWatcher.hpp"
 #include "utils/PrimitiveGenerator.hpp"
+#include "utils/serializer/Json.hpp"
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
-#include <numeric>
 #include <string>
 
 #if defined(BIRDY3D_PLATFORM_LINUX)
@@ -24,105 +26,177 @@
 namespace Birdy3d::core {
 
     template <>
-    [[nodiscard]] render::Shader const* ResourceHandle<render::Shader>::ptr() const
+    ResourceMemory ResourceStorage<render::Shader>::memory_usage(render::Shader const& shader)
     {
-        if (m_new_resource_index.has_value()) {
-            auto resource = ResourceManager::get_shader_ptr(m_new_resource_index.value());
-            if (resource) {
-                m_resource_index = m_new_resource_index.value();
-                m_new_resource_index = {};
-                return resource;
-            }
-        }
+        return {.gpu = shader.memory_size()};
+    }
 
-        if (m_resource_index.has_value())
-            return ResourceManager::get_shader_ptr(m_resource_index.value());
+    template <>
+    ResourceMemory ResourceStorage<ui::Theme>::memory_usage(ui::Theme const&)
+    {
+        return {};
+    }
 
-        return nullptr;
+    template <>
+    ResourceMemory ResourceStorage<render::Model>::memory_usage(render::Model const& model)
+    {
+        // The meshes keep a copy of their vertices and indices in RAM.
+        return {.cpu = model.memory_size(), .gpu = model.memory_size()};
     }
 
     template <>
-    [[nodiscard]] ui::Theme const* ResourceHandle<ui::Theme>::ptr() const
+    ResourceMemory ResourceStorage<render::Texture>::memory_usage(render::Texture const& texture)
     {
-        if (m_new_resource_index.has_value()) {
-            auto resource = ResourceManager::get_theme_ptr(m_new_resource_index.value());
-            if (resource) {
-                m_resource_index = m_new_resource_index.value();
-                m_new_resource_index = {};
-                return resource;
-            }
-        }
+        return {.gpu = texture.memory_size()};
+    }
 
-        if (m_resource_index.has_value())
-            return ResourceManager::get_theme_ptr(m_resource_index.value());
+    template <>
+    ResourceMemory ResourceStorage<physics::Collider>::memory_usage(physics::Collider const& collider)
+    {
+        return {.cpu = collider.memory_size()};
+    }
 
-        return nullptr;
+    template <>
+    ResourceStorage<render::Shader>& ResourceManager::storage()
+    {
+        return m_shaders;
     }
 
     template <>
-    [[nodiscard]] render::Model const* ResourceHandle<render::Model>::ptr() const
+    ResourceStorage<ui::Theme>& ResourceManager::storage()
     {
-        if (m_new_resource_index.has_value()) {
-            auto resource = ResourceManager::get_model_ptr(m_new_resource_index.value());
-            if (resource) {
-                m_resource_index = m_new_resource_index.value();
-                m_new_resource_index = {};
-                return resource;
-            }
-        }
+        return m_themes;
+    }
 
-        if (m_resource_index.has_value())
-            return ResourceManager::get_model_ptr(m_resource_index.value());
+    template <>
+    ResourceStorage<render::Model>& ResourceManager::storage()
+    {
+        return m_models;
+    }
 
-        return nullptr;
+    template <>
+    ResourceStorage<render::Texture>& ResourceManager::storage()
+    {
+        return m_textures;
     }
 
     template <>
-    [[nodiscard]] render::Texture const* ResourceHandle<render::Texture>::ptr() const
+    ResourceStorage<physics::Collider>& ResourceManager::storage()
     {
+        return m_colliders;
+    }
+
+    template <class T>
+    void ResourceManager::release(std::size_t index)
+    {
+        if (m_cleaned_up)
+            return;
+        if (auto cancelled = storage<T>().release(index))
+            m_telemetry.cancel(*cancelled);
+    }
+
+    template <class T>
+    [[nodiscard]] T const* ResourceHandle<T>::ptr() const
+    {
+        follow_successors(m_resource_index);
+        follow_successors(m_new_resource_index);
+
         if (m_new_resource_index.has_value()) {
-            auto resource = ResourceManager::get_texture_ptr(m_new_resource_index.value());
+            auto resource = get(m_new_resource_index.value());
             if (resource) {
+                release(m_resource_index);
                 m_resource_index = m_new_resource_index.value();
                 m_new_resource_index = {};
                 return resource;
             }
+            // A failed slot is never loaded again, the next load() starts over in a new one.
+            if (failed(m_new_resource_index.value())) {
+                release(m_new_resource_index);
+                m_new_resource_index = {};
+            }
         }
 
         if (m_resource_index.has_value())
-            return ResourceManager::get_texture_ptr(m_resource_index.value());
+            return get(m_resource_index.value());
 
         return nullptr;
     }
 
-    template <>
-    [[nodiscard]] physics::Collider const* ResourceHandle<physics::Collider>::ptr() const
+    template <class T>
+    [[nodiscard]] T const* ResourceHandle<T>::peek() const
     {
         if (m_new_resource_index.has_value()) {
-            auto resource = ResourceManager::get_collider_ptr(m_new_resource_index.value());
-            if (resource) {
-                m_resource_index = m_new_resource_index.value();
-                m_new_resource_index = {};
+            if (auto resource = get(m_new_resource_index.value()))
                 return resource;
-            }
         }
-
         if (m_resource_index.has_value())
-            return ResourceManager::get_collider_ptr(m_resource_index.value());
-
+            return get(m_resource_index.value());
         return nullptr;
     }
 
+    template <class T>
+    T const* ResourceHandle<T>::get(std::size_t index)
+    {
+        if (ResourceManager::m_cleaned_up)
+            return nullptr;
+        return ResourceManager::storage<T>().get(index);
+    }
+
+    template <class T>
+    bool ResourceHandle<T>::failed(std::size_t index)
+    {
+        if (ResourceManager::m_cleaned_up)
+            return false;
+        return ResourceManager::storage<T>().failed(index);
+    }
+
+    template <class T>
+    void ResourceHandle<T>::retain(std::size_t index)
+    {
+        if (ResourceManager::m_cleaned_up)
+            return;
+        ResourceManager::storage<T>().retain(index);
+    }
+
+    template <class T>
+    void ResourceHandle<T>::release(std::size_t index)
+    {
+        ResourceManager::release<T>(index);
+    }
+
+    template <class T>
+    void ResourceHandle<T>::prioritize(std::size_t index, float priority)
+    {
+        if (ResourceManager::m_cleaned_up)
+            return;
+        ResourceManager::storage<T>().prioritize(index, priority);
+    }
+
+    template <class T>
+    void ResourceHandle<T>::follow_successors(std::optional<std::size_t>& index)
+    {
+        if (!index.has_value() || ResourceManager::m_cleaned_up)
+            return;
+        auto& storage = ResourceManager::storage<T>();
+        while (auto successor = storage.successor(index.value())) {
+            storage.retain(successor.value());
+            release(index.value());
+            index = successor;
+        }
+    }
+
     template <>
     bool ResourceHandle<render::Shader>::load(ResourceIdentifier const& new_id)
     {
-        auto optional_index = ResourceManager::load_shader_ptr(new_id);
-        if (!optional_index.has_value())
+        // Switching to another variant compiles in the background, the previous program is used until it is linked.
+        auto optional_index = ResourceManager::load_shader_ptr(new_id, ptr() != nullptr);
+        if (!optional_index.has_value()) {
+            ResourceManager::m_telemetry.fail(new_id);
             return false;
+        }
+        ResourceManager::record(ResourceType::SHADER, new_id);
         m_resource_id = new_id;
-        if (m_new_resource_index.has_value() && ResourceManager::get_shader_ptr(m_new_resource_index.value()))
-            m_resource_index = m_new_resource_index.value();
-        m_new_resource_index = optional_index.value();
+        replace_new_resource(optional_index.value());
         notify_load();
         return true;
     }
@@ -131,12 +205,13 @@ namespace Birdy3d::core {
     bool ResourceHandle<ui::Theme>::load(ResourceIdentifier const& new_id)
     {
         auto optional_index = ResourceManager::load_theme_ptr(new_id);
-        if (!optional_index.has_value())
+        if (!optional_index.has_value()) {
+            ResourceManager::m_telemetry.fail(new_id);
             return false;
+        }
+        ResourceManager::record(ResourceType::THEME, new_id);
         m_resource_id = new_id;
-        if (m_new_resource_index.has_value() && ResourceManager::get_theme_ptr(m_new_resource_index.value()))
-            m_resource_index = m_new_resource_index.value();
-        m_new_resource_index = optional_index.value();
+        replace_new_resource(optional_index.value());
         notify_load();
         return true;
     }
@@ -145,12 +220,13 @@ namespace Birdy3d::core {
     bool ResourceHandle<render::Model>::load(ResourceIdentifier const& new_id)
     {
         auto optional_index = ResourceManager::load_model_ptr(new_id);
-        if (!optional_index.has_value())
+        if (!optional_index.has_value()) {
+            ResourceManager::m_telemetry.fail(new_id);
             return false;
+        }
+        ResourceManager::record(ResourceType::MODEL, new_id);
         m_resource_id = new_id;
-        if (m_new_resource_index.has_value() && ResourceManager::get_model_ptr(m_new_resource_index.value()))
-            m_resource_index = m_new_resource_index.value();
-        m_new_resource_index = optional_index.value();
+        replace_new_resource(optional_index.value());
         notify_load();
         return true;
     }
@@ -159,12 +235,13 @@ namespace Birdy3d::core {
     bool ResourceHandle<render::Texture>::load(ResourceIdentifier const& new_id)
     {
         auto optional_index = ResourceManager::load_texture_ptr(new_id);
-        if (!optional_index.has_value())
+        if (!optional_index.has_value()) {
+            ResourceManager::m_telemetry.fail(new_id);
             return false;
+        }
+        ResourceManager::record(ResourceType::TEXTURE, new_id);
         m_resource_id = new_id;
-        if (m_new_resource_index.has_value() && ResourceManager::get_texture_ptr(m_new_resource_index.value()))
-            m_resource_index = m_new_resource_index.value();
-        m_new_resource_index = optional_index.value();
+        replace_new_resource(optional_index.value());
         return true;
     }
 
@@ -172,89 +249,34 @@ namespace Birdy3d::core {
     bool ResourceHandle<physics::Collider>::load(ResourceIdentifier const& new_id)
     {
         auto optional_index = ResourceManager::load_collider_ptr(new_id);
-        if (!optional_index.has_value())
+        if (!optional_index.has_value()) {
+            ResourceManager::m_telemetry.fail(new_id);
             return false;
+        }
+        ResourceManager::record(ResourceType::COLLIDER, new_id);
         m_resource_id = new_id;
-        if (m_new_resource_index.has_value() && ResourceManager::get_collider_ptr(m_new_resource_index.value()))
-            m_resource_index = m_new_resource_index.value();
-        m_new_resource_index = optional_index.value();
+        replace_new_resource(optional_index.value());
         return true;
     }
 
-    ResourceIdentifier::ResourceIdentifier(std::string full_name)
-    {
-        std::vector<std::string> parts;
-        std::size_t last_pos = 0;
-        std::size_t current_pos = full_name.find_first_of(':');
-        while (last_pos != std::string::npos) {
-            parts.push_back(full_name.substr(last_pos, current_pos - last_pos));
-            last_pos = current_pos == std::string::npos ? current_pos : current_pos + 1;
-            current_pos = full_name.find_first_of(':', current_pos + 1);
-        }
-
-        std::size_t args_start = std::string::npos;
-        if (parts.size() >= 3 && parts[1] == "") {
-            source = parts[0];
-            name = parts[2];
-            args_start = 3;
-        } else if (parts.size() >= 1) {
-            name = parts[0];
-            args_start = 1;
-        } else {
-            return;
-        }
-
-        if (parts.size() >= args_start) {
-            for (auto it = parts.begin() + args_start; it != parts.end(); it++) {
-                if (it->empty()) {
-                    core::Logger::warn("Invalid ResourceIdentifier: '{}'", full_name);
-                    continue;
-                }
-                auto equalpos = it->find_first_of('=');
-                if (equalpos == std::string::npos || equalpos == 0) {
-                    core::Logger::warn("Invalid ResourceIdentifier: '{}'", full_name);
-                    continue;
-                }
-                auto key = it->substr(0, equalpos);
-                auto value = it->substr(equalpos + 1);
-                args[key] = value;
-            }
-        }
-    }
-
-    ResourceIdentifier::ResourceIdentifier(char const* full_name)
-        : ResourceIdentifier(std::string{full_name}) {};
-
-    bool ResourceIdentifier::operator==(ResourceIdentifier const& other) const
-    {
-        return type == other.type
-            && source == other.source
-            && name == other.name
-            && args == other.args;
-    }
-
-    std::string ResourceIdentifier::to_string(bool include_args) const
-    {
-        auto location = source + "::" + name;
-        if (!include_args)
-            return location;
-
-        auto data = std::accumulate(args.cbegin(), args.cend(), std::string{}, [](std::string const& sum, std::pair<std::string, std::string> const& element) { return sum + ":" + element.first + "=" + element.second; });
-
-        return location + data;
-    }
-
-    std::unordered_map<std::string, std::size_t> ResourceManager::m_shader_indices;
-    std::unordered_map<std::string, std::size_t> ResourceManager::m_theme_indices;
-    std::unordered_map<std::string, std::size_t> ResourceManager::m_model_indices;
-    std::unordered_map<std::string, std::size_t> ResourceManager::m_texture_indices;
-    std::unordered_map<std::string, std::size_t> ResourceManager::m_collider_indices;
-
-    std::vector<std::unique_ptr<render::Shader>> ResourceManager::m_shaders;
-    std::vector<std::unique_ptr<ui::Theme>> ResourceManager::m_themes;
-    std::vector<std::unique_ptr<render::Model>> ResourceManager::m_models;
-    std::vector<std::unique_ptr<render::Texture>> ResourceManager::m_textures;
-    std::vector<std::unique_ptr<physics::Collider>> ResourceManager::m_colliders;
+    template class ResourceHandle<render::Shader>;
+    template class ResourceHandle<ui::Theme>;
+    template class ResourceHandle<render::Model>;
+    template class ResourceHandle<render::Texture>;
+    template class ResourceHandle<physics::Collider>;
+
+    std::atomic<bool> ResourceManager::m_cleaned_up = false;
+    std::unique_ptr<utils::FileWatcher> ResourceManager::m_file_watcher;
+    LoadingTelemetry ResourceManager::m_telemetry;
+    std::mutex ResourceManager::m_manifest_mutex;
+    bool ResourceManager::m_record_manifest = false;
+    std::unordered_map<ResourceIdentifier, ResourceType> ResourceManager::m_manifest;
+
+    ResourceStorage<render::Shader> ResourceManager::m_shaders;
+    ResourceStorage<ui::Theme> ResourceManager::m_themes;
+    ResourceStorage<render::Model> ResourceManager::m_models;
+    ResourceStorage<render::Texture> ResourceManager::m_textures;
+    ResourceStorage<physics::Collider> ResourceManager::m_colliders;
 
     ResourceHandle<render::Shader> ResourceManager::get_shader(ResourceIdentifier const& id)
     {
@@ -281,41 +303,94 @@ namespace Birdy3d::core {
         return ResourceHandle<physics::Collider>(id);
     }
 
-    std::optional<std::size_t> ResourceManager::load_shader_ptr(ResourceIdentifier const& id)
+    template <class T>
+    std::size_t ResourceManager::insert_loaded(ResourceIdentifier const& id, std::unique_ptr<T> resource)
     {
-        auto name = id.to_string();
+        m_telemetry.complete(id, ResourceStorage<T>::memory_usage(*resource));
+        return storage<T>().insert(id, std::move(resource));
+    }
 
-        if (m_shader_indices.contains(name))
-            return m_shader_indices[name];
+    std::optional<std::size_t> ResourceManager::load_shader_ptr(ResourceIdentifier const& id, bool async)
+    {
+        if (auto index = m_shaders.find(id))
+            return index;
 
-        if (id.source != "file" && id.source != "") {
-            Logger::error("invalid shader source '{}'", id.source);
+        if (id.source() != "file" && id.source() != "") {
+            m_telemetry.begin(id, LoadPhase::DECODING);
+            Logger::error("invalid shader source '{}'", id.source());
             return {};
         }
 
-        std::map<std::string, std::string> shader_parameters;
-        for (auto const& [key, value] : id.args) {
-            shader_parameters[key] = value;
+        if (async) {
+            return m_shaders.insert_pending(id, [&](std::size_t index) {
+                m_telemetry.begin(id, LoadPhase::QUEUED);
+                return core::Application::defer_loading([=](std::stop_token stop_token) {
+                    load_shader_variant(id, index, stop_token).detach();
+                });
+            });
         }
 
-        auto shader = std::make_unique<render::Shader>(id.name, shader_parameters);
+        m_telemetry.begin(id, LoadPhase::DECODING);
+        return create_shader(id, render::Shader::preprocess(id.name(), id.args()));
+    }
 
-        auto index = m_shaders.size();
-        m_shader_indices[name] = index;
-        m_shaders.push_back(std::move(shader));
+    Task<> ResourceManager::load_shader_variant(ResourceIdentifier id, std::size_t index, std::stop_token stop_token)
+    {
+        m_telemetry.begin(id, LoadPhase::DECODING);
+        auto sources = render::Shader::preprocess(id.name(), id.args());
+        if (stop_token.stop_requested())
+            co_return;
+
+        m_telemetry.begin(id, LoadPhase::QUEUED);
+        co_await resume_on_main();
+        if (m_cleaned_up || stop_token.stop_requested())
+            co_return;
+
+        m_telemetry.begin(id, LoadPhase::UPLOADING);
+        auto shader = std::make_unique<render::Shader>(id.name(), std::move(sources), false);
+        // Polled once per frame. Without parallel compilation, finish_linking() blocks instead.
+        while (!shader->link_complete()) {
+            co_await resume_on_main();
+            if (m_cleaned_up)
+                co_return;
+        }
+        shader->finish_linking();
+        if (stop_token.stop_requested())
+            co_return;
+
+        if (!shader->valid()) {
+            m_telemetry.fail(id);
+            core::Logger::warn("keeping the previous variant of shader '{}'", id.name());
+            m_shaders.fail(index);
+            co_return;
+        }
+        m_telemetry.complete(id, ResourceStorage<render::Shader>::memory_usage(*shader));
+        m_shaders.store(index, std::move(shader));
 
-        return index;
+        core::Application::event_bus->emit<events::ResourceLoadEvent>();
+    }
+
+    std::size_t ResourceManager::create_shader(ResourceIdentifier const& id, render::ShaderSources sources)
+    {
+        m_telemetry.begin(id, LoadPhase::UPLOADING);
+        auto shader = std::make_unique<render::Shader>(id.name(), std::move(sources));
+        if (!shader->valid()) {
+            m_telemetry.fail(id);
+            return m_shaders.insert(id, std::move(shader));
+        }
+
+        return insert_loaded(id, std::move(shader));
     }
 
     std::optional<std::size_t> ResourceManager::load_theme_ptr(ResourceIdentifier const& id)
     {
-        std::string name = id.to_string();
+        if (auto index = m_themes.find(id))
+            return index;
 
-        if (m_theme_indices.contains(name))
-            return m_theme_indices[name];
+        m_telemetry.begin(id, LoadPhase::DECODING);
 
-        if (id.source == "file" || id.source == "") {
-            std::string path = get_resource_path(id.name, ResourceType::THEME);
+        if (id.source() == "file" || id.source() == "") {
+            std::string path = get_resource_path(id.name(), ResourceType::THEME);
             if (path.empty())
                 return {};
             std::string file_content = ResourceManager::read_file(path);
@@ -324,16 +399,12 @@ namespace Birdy3d::core {
             try {
                 auto theme = std::make_unique<ui::Theme>(file_content);
 
-                auto index = m_themes.size();
-                m_theme_indices[name] = index;
-                m_themes.push_back(std::move(theme));
-
-                return index;
+                return insert_loaded(id, std::move(theme));
             } catch (std::exception const& e) {
                 return {};
             }
         } else {
-            Logger::error("invalid theme source '{}'", id.source);
+            Logger::error("invalid theme source '{}'", id.source());
         }
 
         return {};
@@ -341,149 +412,254 @@ namespace Birdy3d::core {
 
     std::optional<std::size_t> ResourceManager::load_model_ptr(ResourceIdentifier const& id)
     {
-        std::string name = id.to_string();
+        if (auto index = m_models.find(id))
+            return index;
 
-        if (m_model_indices.contains(name))
-            return m_model_indices[name];
+        if (id.source() == "file" || id.source() == "") {
+            std::string path = get_resource_path(id.name(), ResourceType::MODEL);
+            if (path.empty())
+                return {};
+
+            return m_models.insert_pending(id, [&](std::size_t index) {
+                m_telemetry.begin(id, LoadPhase::QUEUED);
+                return core::Application::defer_loading([=](std::stop_token stop_token) {
+                    load_model_file(id, index, path, stop_token).detach();
+                });
+            });
+        }
 
+        m_telemetry.begin(id, LoadPhase::DECODING);
         std::unique_ptr<render::Model> model;
 
-        if (id.source == "file" || id.source == "") {
-            std::string path = get_resource_path(id.name, ResourceType::MODEL);
-            if (path.empty())
-                return {};
-            model = std::make_unique<render::Model>(path);
-        } else if (id.source == "primitive") {
-            if (id.name == "plane") {
+        if (id.source() == "primitive") {
+            if (id.name() == "plane") {
                 int resolution = 1;
-                if (id.args.contains("resolution")) {
-                    int resolution_arg = std::stoi(id.args.at("resolution"));
+                if (id.args().contains("resolution")) {
+                    int resolution_arg = std::stoi(id.args().at("resolution"));
                     if (resolution_arg > resolution)
                         resolution = resolution_arg;
                 }
                 model = utils::PrimitiveGenerator::generate_plane(resolution);
-            } else if (id.name == "cube") {
+            } else if (id.name() == "cube") {
                 model = utils::PrimitiveGenerator::generate_cube();
-            } else if (id.name == "uv_sphere") {
+            } else if (id.name() == "uv_sphere") {
                 int resolution = 5;
-                if (id.args.contains("resolution")) {
-                    int resolution_arg = std::stoi(id.args.at("resolution"));
+                if (id.args().contains("resolution")) {
+                    int resolution_arg = std::stoi(id.args().at("resolution"));
                     if (resolution_arg > resolution)
                         resolution = resolution_arg;
                 }
                 model = utils::PrimitiveGenerator::generate_uv_sphere(resolution);
-            } else if (id.name == "ico_sphere") {
+            } else if (id.name() == "ico_sphere") {
                 int resolution = 5;
-                if (id.args.contains("resolution")) {
-                    int resolution_arg = std::stoi(id.args.at("resolution"));
+                if (id.args().contains("resolution")) {
+                    int resolution_arg = std::stoi(id.args().at("resolution"));
                     if (resolution_arg > resolution)
                         resolution = resolution_arg;
                 }
                 model = utils::PrimitiveGenerator::generate_ico_sphere(resolution);
             } else {
-                Logger::error("invalid primitive type '{}'", id.name);
+                Logger::error("invalid primitive type '{}'", id.name());
                 return {};
             }
         } else {
-            Logger::error("invalid model source '{}'", id.source);
+            Logger::error("invalid model source '{}'", id.source());
             return {};
         }
 
-        auto index = m_models.size();
-        m_model_indices[name] = index;
-        m_models.push_back(std::move(model));
-
-        return index;
+        return insert_loaded(id, std::move(model));
     }
 
     std::optional<std::size_t> ResourceManager::load_texture_ptr(ResourceIdentifier const& id)
     {
-        std::string name = id.to_string();
-
-        if (m_texture_indices.contains(name))
-            return m_texture_indices[name];
+        if (auto index = m_textures.find(id))
+            return index;
 
-        if (id.source == "file" || id.source == "") {
-            std::string path = get_resource_path(id.name, ResourceType::TEXTURE);
+        if (id.source() == "file" || id.source() == "") {
+            std::string path = get_resource_path(id.name(), ResourceType::TEXTURE);
             if (path.empty())
                 return {};
 
-            auto index = m_textures.size();
-            m_texture_indices[name] = index;
-            m_textures.push_back(nullptr);
+            // The load is cancelled if every handle is gone before it starts.
+            return m_textures.insert_pending(id, [&](std::size_t index) {
+                m_telemetry.begin(id, LoadPhase::QUEUED);
+                return core::Application::defer_loading([=](std::stop_token stop_token) {
+                    load_texture_file(id, index, path, stop_token).detach();
+                });
+            });
+        } else if (id.source() == "color") {
+            m_telemetry.begin(id, LoadPhase::UPLOADING);
+            utils::Color color = id.name();
+            return insert_loaded(id, std::make_unique<render::Texture>(color));
+        } else {
+            Logger::error("invalid texture source '{}'", id.source());
+        }
+
+        return {};
+    }
 
-            core::Application::defer_loading([=]() {
-                auto optional_image = utils::TextureLoader::from_file(path);
+    Task<> ResourceManager::load_texture_file(ResourceIdentifier id, std::size_t index, std::string path, std::stop_token stop_token)
+    {
+        m_telemetry.begin(id, LoadPhase::DECODING);
+        auto optional_image = utils::TextureLoader::from_file(path);
+
+        if (!optional_image.has_value()) {
+            m_telemetry.fail(id);
+            core::Logger::warn("Failed to load texture at {}", path);
+            // Continuations expect to run on the main thread.
+            co_await resume_on_main();
+            if (!m_cleaned_up)
+                m_textures.fail(index);
+            co_return;
+        }
 
-                if (!optional_image.has_value()) {
-                    core::Logger::warn("Failed to load texture at {}", path);
-                    return;
-                }
+        if (stop_token.stop_requested())
+            co_return;
 
-                core::Application::defer_main([index, image = optional_image.value()]() {
-                    auto texture = std::make_unique<render::Texture>(image);
+        m_telemetry.begin(id, LoadPhase::QUEUED);
+        co_await resume_on_main();
+        if (m_cleaned_up || stop_token.stop_requested())
+            co_return;
 
-                    if (!m_textures[index])
-                        m_textures[index] = std::move(texture);
+        m_telemetry.begin(id, LoadPhase::UPLOADING);
+        auto texture = std::make_unique<render::Texture>(optional_image.value());
+        m_telemetry.complete(id, ResourceStorage<render::Texture>::memory_usage(*texture));
+        m_textures.store(index, std::move(texture));
 
-                    core::Application::event_bus->emit<events::ResourceLoadEvent>();
-                });
-            });
+        core::Application::event_bus->emit<events::ResourceLoadEvent>();
+    }
 
-            return index;
-        } else if (id.source == "color") {
-            utils::Color color = id.name;
-            auto texture = std::make_unique<render::Texture>(color);
+    Task<> ResourceManager::load_model_file(ResourceIdentifier id, std::size_t index, std::string path, std::stop_token stop_token)
+    {
+        m_telemetry.begin(id, LoadPhase::DECODING);
+        core::Logger::debug("Loading model: {}", path);
+        auto importer = render::Model::import(path);
+        if (!importer) {
+            m_telemetry.fail(id);
+            core::Logger::error("Failed to load model '{}'", path);
+            co_await resume_on_main();
+            if (!m_cleaned_up)
+                m_models.fail(index);
+            co_return;
+        }
 
-            auto index = m_textures.size();
-            m_texture_indices[name] = index;
-            m_textures.push_back(std::move(texture));
+        if (stop_token.stop_requested())
+            co_return;
+
+        // The textures are decoded on other workers while the meshes are created.
+        // These references keep them cached until the material of the model holds its own.
+        std::vector<std::size_t> textures;
+        for (auto const& texture_path : render::Model::texture_paths(path, *importer)) {
+            ResourceIdentifier texture_id = texture_path;
+            if (texture_id.source() != "file" && texture_id.source() != "")
+                continue;
+            if (auto texture_index = load_texture_ptr(texture_id))
+                textures.push_back(texture_index.value());
+        }
 
-            return index;
-        } else {
-            Logger::error("invalid texture source '{}'", id.source);
+        m_telemetry.begin(id, LoadPhase::QUEUED);
+        co_await resume_on_main();
+        if (m_cleaned_up)
+            co_return;
+
+        if (!stop_token.stop_requested()) {
+            m_telemetry.begin(id, LoadPhase::UPLOADING);
+            auto model = std::make_unique<render::Model>(path, *importer);
+            m_telemetry.complete(id, ResourceStorage<render::Model>::memory_usage(*model));
+            m_models.store(index, std::move(model));
+            core::Application::event_bus->emit<events::ResourceLoadEvent>();
         }
 
-        return {};
+        for (auto texture_index : textures)
+            release<render::Texture>(texture_index);
     }
 
-    std::optional<std::size_t> ResourceManager::load_collider_ptr(ResourceIdentifier const& id)
+    namespace {
+
+        // Suspends until a slot was stored or its load failed. Whichever side comes second resumes the coroutine.
+        template <class T>
+        struct SlotAwaiter {
+            ResourceStorage<T>& storage;
+            std::size_t index;
+            T const* resource = nullptr;
+            std::coroutine_handle<> handle;
+            std::atomic<bool> ready = false;
+
+            SlotAwaiter(ResourceStorage<T>& storage, std::size_t index)
+                : storage(storage)
+                , index(index)
+            { }
+
+            bool await_ready() { return false; }
+
+            bool await_suspend(std::coroutine_handle<> awaiting)
+            {
+                handle = awaiting;
+                storage.then(index, [this](T const* loaded) {
+                    resource = loaded;
+                    if (ready.exchange(true, std::memory_order_acq_rel))
+                        handle.resume();
+                });
+                return !ready.exchange(true, std::memory_order_acq_rel);
+            }
+
+            T const* await_resume() { return resource; }
+        };
+
+    }
+
+    template <class T>
+    Task<ResourceHandle<T>> ResourceManager::when_loaded(ResourceIdentifier id, std::optional<std::size_t> index)
     {
-        std::string name = id.to_string(false);
+        if (!index.has_value())
+            co_return ResourceHandle<T>{};
+        auto resource = co_await SlotAwaiter<T>{storage<T>(), index.value()};
+        // The slot is cached now, so this only takes another reference.
+        auto handle = resource ? ResourceHandle<T>(id) : ResourceHandle<T>{};
+        release<T>(index.value());
+        co_return handle;
+    }
 
-        if (m_collider_indices.contains(name))
-            return m_collider_indices[name];
+    Task<ResourceHandle<render::Model>> ResourceManager::load_model_async(ResourceIdentifier id)
+    {
+        // Primitives are created right away, which requires the OpenGL context.
+        if (!Application::is_main_thread())
+            co_await resume_on_main();
+        co_return co_await when_loaded<render::Model>(id, load_model_ptr(id));
+    }
 
-        auto model_index = load_model_ptr(id);
-        if (!model_index.has_value())
-            return {};
+    Task<ResourceHandle<render::Texture>> ResourceManager::load_texture_async(ResourceIdentifier id)
+    {
+        if (!Application::is_main_thread())
+            co_await resume_on_main();
+        co_return co_await when_loaded<render::Texture>(id, load_texture_ptr(id));
+    }
 
-        // FIXME: Wait for model to be available
-        auto model = get_model_ptr(model_index.value());
-        if (!model)
-            return {};
+    std::optional<std::size_t> ResourceManager::load_collider_ptr(ResourceIdentifier const& id)
+    {
+        if (auto index = m_colliders.find(id))
+            return index;
+
+        m_telemetry.begin(id, LoadPhase::DECODING);
 
-        if (id.source == "primitive") {
-            if (id.name == "plane") {
+        if (id.source() == "primitive") {
+            if (id.name() == "plane") {
                 Logger::error("Can't generate a Collider for the plane primitive.");
                 return {};
-            } else if (id.name == "uv_sphere" || id.name == " ico_sphere") {
+            } else if (id.name() == "uv_sphere" || id.name() == " ico_sphere") {
                 auto shapes = std::vector<std::unique_ptr<physics::CollisionShape>>();
                 shapes.push_back(std::make_unique<physics::CollisionSphere>(1.0f));
                 auto collider = std::make_unique<physics::Collider>(std::move(shapes));
 
-                auto index = m_colliders.size();
-                m_collider_indices[name] = index;
-                m_colliders.push_back(std::move(collider));
-                return index;
+                return insert_loaded(id, std::move(collider));
             }
         }
 
         physics::GenerationMode generation_mode = physics::GenerationMode::NONE;
-        if (!id.args.contains("generation_mode"))
+        if (!id.args().contains("generation_mode"))
             return {};
 
-        auto mode_string = id.args.at("generation_mode");
+        auto mode_string = id.args().at("generation_mode");
         if (mode_string == "NONE") {
             generation_mode = physics::GenerationMode::NONE;
         } else if (mode_string == "COPY") {
@@ -501,56 +677,388 @@ namespace Birdy3d::core {
             return {};
         }
 
-        auto index = m_colliders.size();
-        m_collider_indices[name] = index;
-        m_colliders.push_back(nullptr);
+        // The generation mode isn't a property of the model, so it must not create a separate copy of it.
+        auto model_id = id;
+        model_id.remove_arg("generation_mode");
+        auto model_index = load_model_ptr(model_id);
+        if (!model_index.has_value()) {
+            m_telemetry.fail(model_id);
+            return {};
+        }
 
-        core::Application::defer_loading([=]() {
-            auto collider = physics::ConvexMeshGenerators::generate_collider(generation_mode, *model);
+        bool created = false;
+        auto index = m_colliders.insert_pending(id, [&](std::size_t) {
+            created = true;
+            m_telemetry.begin(id, LoadPhase::QUEUED);
+            // Nothing is queued before the model is loaded.
+            return LoadingTicket{};
+        });
+        if (!created) {
+            release<render::Model>(model_index.value());
+            return index;
+        }
 
-            // FIXME: Possible race condition. Use a mutex?
-            if (!m_colliders[index])
-                m_colliders[index] = std::move(collider);
+        // The model reference is held until the collider is generated, so that the model can't be evicted in the meantime.
+        // Models are stored on the main thread, so the continuation runs there.
+        m_models.then(model_index.value(), [=](render::Model const* model) {
+            if (!model) {
+                m_telemetry.fail(id);
+                m_colliders.fail(index);
+                release<render::Model>(model_index.value());
+                return;
+            }
 
-            core::Application::event_bus->emit<events::ResourceLoadEvent>();
+            // The task must run to release the model, so it is not cancellable. A collider dropped in the meantime is discarded by store().
+            core::Application::defer_loading([=]() {
+                m_telemetry.begin(id, LoadPhase::DECODING);
+                auto collider = physics::ConvexMeshGenerators::generate_collider(generation_mode, *model);
+                if (collider) {
+                    m_telemetry.complete(id, ResourceStorage<physics::Collider>::memory_usage(*collider));
+                    m_colliders.store(index, std::move(collider));
+                } else {
+                    m_telemetry.fail(id);
+                    m_colliders.fail(index);
+                }
+
+                // Releasing the model may destroy it, which requires the OpenGL context.
+                core::Application::defer_main([model_index]() {
+                    if (m_cleaned_up)
+                        return;
+
+                    release<render::Model>(model_index.value());
+
+                    core::Application::event_bus->emit<events::ResourceLoadEvent>();
+                });
+            });
         });
 
         return index;
     }
 
-    render::Shader const* ResourceManager::get_shader_ptr(std::size_t const& index)
+    ResourceMemory ResourceManager::memory_usage(ResourceType type)
     {
-        if (index >= m_shaders.size())
-            return nullptr;
-        return m_shaders[index].get();
+        switch (type) {
+        case ResourceType::SHADER:
+            return m_shaders.memory();
+        case ResourceType::TEXTURE:
+            return m_textures.memory();
+        case ResourceType::THEME:
+            return m_themes.memory();
+        case ResourceType::MODEL:
+            return m_models.memory();
+        case ResourceType::COLLIDER:
+            return m_colliders.memory();
+        default:
+            return {};
+        }
     }
 
-    ui::Theme const* ResourceManager::get_theme_ptr(std::size_t const& index)
+    LoadingProgress ResourceManager::loading_progress()
     {
-        if (index >= m_themes.size())
-            return nullptr;
-        return m_themes[index].get();
+        return m_telemetry.progress();
     }
 
-    render::Model const* ResourceManager::get_model_ptr(std::size_t const& index)
+    void ResourceManager::reset_loading_progress()
     {
-        if (index >= m_models.size())
-            return nullptr;
-        return m_models[index].get();
+        m_telemetry.reset();
     }
 
-    render::Texture const* ResourceManager::get_texture_ptr(std::size_t const& index)
+    std::vector<ResourceLoadStats> ResourceManager::slowest_loads(std::size_t count)
     {
-        if (index >= m_textures.size())
-            return nullptr;
-        return m_textures[index].get();
+        return m_telemetry.slowest(count);
     }
 
-    physics::Collider const* ResourceManager::get_collider_ptr(std::size_t const& index)
+    void ResourceManager::enforce_memory_budget()
     {
-        if (index >= m_colliders.size())
-            return nullptr;
-        return m_colliders[index].get();
+        std::size_t constexpr MEBIBYTE = 1024 * 1024;
+        // A budget of 0 or less means unlimited
+        auto cpu_budget = Application::option_int(IntOption::RESOURCE_CPU_BUDGET);
+        auto gpu_budget = Application::option_int(IntOption::RESOURCE_GPU_BUDGET);
+
+        auto evict_least_recently_used = [](bool cpu, bool gpu, auto&... storages) {
+            std::optional<std::chrono::steady_clock::time_point> oldest;
+            std::function<void()> evict;
+            (
+                [&] {
+                    auto released = storages.oldest_unused(cpu, gpu);
+                    if (released.has_value() && (!oldest.has_value() || released.value() < oldest.value())) {
+                        oldest = released;
+                        evict = [&storages, cpu, gpu] { storages.evict_oldest_unused(cpu, gpu); };
+                    }
+                }(),
+                ...);
+            if (!evict)
+                return false;
+            evict();
+            return true;
+        };
+
+        while (true) {
+            ResourceMemory total;
+            total += m_shaders.memory();
+            total += m_themes.memory();
+            total += m_models.memory();
+            total += m_textures.memory();
+            total += m_colliders.memory();
+
+            bool cpu_exceeded = cpu_budget > 0 && total.cpu > static_cast<std::size_t>(cpu_budget) * MEBIBYTE;
+            bool gpu_exceeded = gpu_budget > 0 && total.gpu > static_cast<std::size_t>(gpu_budget) * MEBIBYTE;
+            if (!cpu_exceeded && !gpu_exceeded)
+                return;
+
+            if (!evict_least_recently_used(cpu_exceeded, gpu_exceeded, m_shaders, m_themes, m_models, m_textures, m_colliders))
+                return;
+        }
+    }
+
+    void ResourceManager::record_manifest(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock{m_manifest_mutex};
+        m_record_manifest = enabled;
+    }
+
+    void ResourceManager::record(ResourceType type, ResourceIdentifier const& id)
+    {
+        std::lock_guard<std::mutex> lock{m_manifest_mutex};
+        if (m_record_manifest)
+            m_manifest.try_emplace(id, type);
+    }
+
+    bool ResourceManager::save_manifest(std::string const& path)
+    {
+        serializer::Array resources;
+        {
+            std::lock_guard<std::mutex> lock{m_manifest_mutex};
+            for (auto const& [id, type] : m_manifest) {
+                std::string type_name;
+                switch (type) {
+                case ResourceType::SHADER:
+                    type_name = "shader";
+                    break;
+                case ResourceType::THEME:
+                    type_name = "theme";
+                    break;
+                case ResourceType::MODEL:
+                    type_name = "model";
+                    break;
+                case ResourceType::TEXTURE:
+                    type_name = "texture";
+                    break;
+                case ResourceType::COLLIDER:
+                    type_name = "collider";
+                    break;
+                default:
+                    continue;
+                }
+                serializer::Object resource;
+                resource["type"] = serializer::String(type_name);
+                resource["id"] = serializer::String(id.to_string());
+                resources.value.push_back(std::move(resource));
+            }
+        }
+
+        std::ofstream file(path);
+        if (!file) {
+            Logger::error("Can't write resource manifest '{}'", path);
+            return false;
+        }
+        serializer::Object manifest;
+        manifest["resources"] = std::move(resources);
+        serializer::PrettyJsonGenerator generator(file);
+        generator.generate(manifest);
+        return true;
+    }
+
+    ResourcePreload ResourceManager::preload_manifest(std::string const& path)
+    {
+        ResourcePreload preload;
+        if (!std::filesystem::exists(path))
+            return preload;
+
+        serializer::Value manifest;
+        try {
+            serializer::JsonParser parser(read_file(path));
+            manifest = parser.parse();
+        } catch (serializer::ParseError const& e) {
+            Logger::error("Invalid resource manifest '{}': {}", path, e.what());
+            return preload;
+        }
+
+        auto* object = std::get_if<serializer::Object>(&manifest);
+        auto* resources = object && object->value.contains("resources") ? std::get_if<serializer::Array>(&object->value["resources"]) : nullptr;
+        if (!resources) {
+            Logger::error("Invalid resource manifest '{}'", path);
+            return preload;
+        }
+
+        // The preload itself must not end up in the next manifest.
+        bool recording;
+        {
+            std::lock_guard<std::mutex> lock{m_manifest_mutex};
+            recording = std::exchange(m_record_manifest, false);
+        }
+
+        std::vector<ResourceIdentifier> shaders, themes, colliders;
+        for (auto& value : resources->value) {
+            auto* resource = std::get_if<serializer::Object>(&value);
+            if (!resource || !resource->value.contains("type") || !resource->value.contains("id"))
+                continue;
+            auto* type = std::get_if<serializer::String>(&resource->value["type"]);
+            auto* id = std::get_if<serializer::String>(&resource->value["id"]);
+            if (!type || !id)
+                continue;
+
+            // Models and textures are loaded on the loading threads, so they are started first.
+            if (type->value == "model")
+                preload.models.emplace_back(id->value);
+            else if (type->value == "texture")
+                preload.textures.emplace_back(id->value);
+            else if (type->value == "collider")
+                colliders.emplace_back(id->value);
+            else if (type->value == "shader")
+                shaders.emplace_back(id->value);
+            else if (type->value == "theme")
+                themes.emplace_back(id->value);
+        }
+        // Colliders are generated once their model is loaded.
+        for (auto const& id : colliders)
+            preload.colliders.emplace_back(id);
+        // Compiling shaders requires the OpenGL context, so this overlaps with the background loads. Only the
+        // preprocessing is spread over the workers.
+        // Cached shaders and shaders that don't come from files are left to the handles.
+        std::vector<ResourceIdentifier> compiled_shaders;
+        for (auto const& id : shaders) {
+            if (!m_shaders.contains(id) && (id.source() == "file" || id.source() == ""))
+                compiled_shaders.push_back(id);
+        }
+        for (auto const& id : compiled_shaders)
+            m_telemetry.begin(id, LoadPhase::DECODING);
+        std::vector<render::ShaderSources> shader_sources(compiled_shaders.size());
+        JobSystem::parallel_for(compiled_shaders.size(), [&compiled_shaders, &shader_sources](std::size_t i) {
+            shader_sources[i] = render::Shader::preprocess(compiled_shaders[i].name(), compiled_shaders[i].args());
+        });
+        std::vector<std::size_t> compiled_indices;
+        for (std::size_t i = 0; i < compiled_shaders.size(); ++i)
+            compiled_indices.push_back(create_shader(compiled_shaders[i], std::move(shader_sources[i])));
+        for (auto const& id : shaders)
+            preload.shaders.emplace_back(id);
+        // The handles hold their own references now.
+        for (auto index : compiled_indices)
+            release<render::Shader>(index);
+        for (auto const& id : themes)
+            preload.themes.emplace_back(id);
+
+        {
+            std::lock_guard<std::mutex> lock{m_manifest_mutex};
+            m_record_manifest = recording;
+        }
+        return preload;
+    }
+
+    std::string ResourceManager::manifest_path(std::string const& scene_path)
+    {
+        return std::filesystem::path(scene_path).replace_extension(".manifest.json").string();
+    }
+
+    void ResourceManager::hot_reload(bool enabled)
+    {
+        if (!enabled) {
+            m_file_watcher.reset();
+            return;
+        }
+        if (m_file_watcher)
+            return;
+
+        // The watcher thread only forwards the path, reloading starts on the main thread where the storages live.
+        m_file_watcher = std::make_unique<utils::FileWatcher>(
+            std::vector<std::filesystem::path>{get_resource_dir(), get_resource_dir() + "../shaders/"},
+            [](std::filesystem::path const& path) {
+                core::Application::defer_main([path]() { reload_file(path); });
+            });
+    }
+
+    void ResourceManager::reload_file(std::filesystem::path const& path)
+    {
+        if (m_cleaned_up)
+            return;
+
+        std::error_code error;
+        auto changed_path = std::filesystem::weakly_canonical(path, error);
+        auto matches = [&](ResourceIdentifier const& id, ResourceType type) {
+            if (id.source() != "file" && id.source() != "")
+                return false;
+            auto resource_path = get_resource_path(id.name(), type);
+            return !resource_path.empty() && std::filesystem::weakly_canonical(resource_path, error) == changed_path;
+        };
+
+        // Shaders can include each other, so every shader is rebuilt when one of them changes. Only the changed file is
+        // parsed again. Compiling requires the OpenGL context, so only the preprocessing is moved to the workers.
+        if (changed_path.extension() == ".glsl") {
+            auto ids = m_shaders.ids();
+            std::erase_if(ids, [](ResourceIdentifier const& id) { return id.source() != "file" && id.source() != ""; });
+            std::vector<render::ShaderSources> shader_sources(ids.size());
+            JobSystem::parallel_for(ids.size(), [&ids, &shader_sources](std::size_t i) {
+                shader_sources[i] = render::Shader::preprocess(ids[i].name(), ids[i].args());
+            });
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                auto shader = std::make_unique<render::Shader>(ids[i].name(), std::move(shader_sources[i]));
+                if (!shader->valid()) {
+                    Logger::warn("Failed to reload shader '{}', keeping the previous version", ids[i].to_string());
+                    continue;
+                }
+                m_shaders.replace(ids[i], std::move(shader));
+            }
+            core::Application::event_bus->emit<events::ResourceLoadEvent>();
+            return;
+        }
+
+        for (auto const& id : m_textures.ids()) {
+            if (!matches(id, ResourceType::TEXTURE))
+                continue;
+            core::Application::defer_loading([id, path = changed_path.string()]() {
+                auto optional_image = utils::TextureLoader::from_file(path);
+                if (!optional_image.has_value()) {
+                    core::Logger::warn("Failed to reload texture at {}", path);
+                    return;
+                }
+
+                core::Application::defer_main([id, image = optional_image.value()]() {
+                    if (m_cleaned_up)
+                        return;
+                    m_textures.replace(id, std::make_unique<render::Texture>(image));
+                    core::Application::event_bus->emit<events::ResourceLoadEvent>();
+                });
+            });
+        }
+
+        for (auto const& id : m_models.ids()) {
+            if (!matches(id, ResourceType::MODEL))
+                continue;
+            core::Application::defer_loading([id, path = changed_path.string()]() {
+                auto importer = render::Model::import(path);
+                if (!importer)
+                    return;
+
+                // Creating the meshes and material textures requires the main thread.
+                core::Application::defer_main([id, path, importer]() {
+                    if (m_cleaned_up)
+                        return;
+                    m_models.replace(id, std::make_unique<render::Model>(path, *importer));
+                    core::Application::event_bus->emit<events::ResourceLoadEvent>();
+                });
+            });
+        }
+    }
+
+    void ResourceManager::cleanup()
+    {
+        m_file_watcher.reset();
+        m_colliders.clear();
+        m_models.clear();
+        m_textures.clear();
+        m_themes.clear();
+        m_shaders.clear();
+        m_cleaned_up = true;
     }
 
     std::string ResourceManager::get_resource_path(std::string name, ResourceType type)
@@ -1,12 +1,33 @@
 #pragma once
 
 #include "core/Base.hpp"
+#include "core/LoadingTelemetry.hpp"
 #include "core/ResourceHandle.hpp"
+#include "core/ResourceStorage.hpp"
+#include "core/Task.hpp"
+#include "physics/Forward.hpp"
 #include "render/Forward.hpp"
 #include "ui/Forward.hpp"
+#include "utils/Forward.hpp"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace Birdy3d::core {
 
+    /**
+     * @brief Keeps the resources of a manifest cached while it exists. See ResourceManager::preload_manifest().
+     */
+    struct ResourcePreload {
+        std::vector<ResourceHandle<render::Shader>> shaders;
+        std::vector<ResourceHandle<ui::Theme>> themes;
+        std::vector<ResourceHandle<render::Model>> models;
+        std::vector<ResourceHandle<render::Texture>> textures;
+        std::vector<ResourceHandle<physics::Collider>> colliders;
+    };
+
     class ResourceManager {
     public:
         static ResourceHandle<render::Shader> get_shader(ResourceIdentifier const& id);
@@ -15,6 +36,16 @@ namespace Birdy3d::core {
         static ResourceHandle<render::Texture> get_texture(ResourceIdentifier const& id);
         static ResourceHandle<physics::Collider> get_collider(ResourceIdentifier const& id);
 
+        /**
+         * @brief Loads a model and waits until it is ready: `auto model = co_await ResourceManager::load_model_async(id);`
+         * @returns the handle, which is empty if the model couldn't be loaded. Resumes the awaiting coroutine on the main thread.
+         */
+        static Task<ResourceHandle<render::Model>> load_model_async(ResourceIdentifier id);
+        /**
+         * @brief Loads a texture and waits until it is ready. See load_model_async().
+         */
+        static Task<ResourceHandle<render::Texture>> load_texture_async(ResourceIdentifier id);
+
         /**
          * @brief Finds the path of a Resource.
          * @param name resource name
@@ -33,6 +64,76 @@ namespace Birdy3d::core {
 
         static std::string get_resource_dir();
 
+        /**
+         * @brief Returns the memory used by all loaded resources of a type.
+         * @param type resource type
+         */
+        static ResourceMemory memory_usage(ResourceType type);
+
+        /**
+         * @brief Evicts unreferenced resources in least recently used order until the memory budget is met.
+         *
+         * The budget is configured with IntOption::RESOURCE_CPU_BUDGET and IntOption::RESOURCE_GPU_BUDGET.
+         * This has to be called on the main thread.
+         */
+        static void enforce_memory_budget();
+
+        /**
+         * @brief Counts the resource loads since the last call to reset_loading_progress(), e.g. for a loading screen.
+         */
+        static LoadingProgress loading_progress();
+
+        /**
+         * @brief Forgets all finished loads, so that loading_progress() only counts loads that are started afterwards.
+         */
+        static void reset_loading_progress();
+
+        /**
+         * @param count maximum amount of results
+         * @returns timings and memory of the finished loads with the longest total time, slowest first
+         */
+        static std::vector<ResourceLoadStats> slowest_loads(std::size_t count);
+
+        /**
+         * @brief Starts or stops recording the identifiers of all requested resources for save_manifest().
+         */
+        static void record_manifest(bool enabled);
+
+        /**
+         * @brief Writes the identifiers of all resources that were requested while recording to a JSON file.
+         * @param path manifest path, see manifest_path()
+         * @returns false if the file couldn't be written
+         */
+        static bool save_manifest(std::string const& path);
+
+        /**
+         * @brief Starts loading all resources listed in a manifest.
+         *
+         * Textures, models and colliders load in parallel on the loading threads. Resources that are requested while
+         * the preload exists are shared with it, so a scene can be deserialized right after calling this.
+         * @param path manifest path, see manifest_path()
+         * @returns handles to the preloaded resources. Loads that nothing else requested are cancelled when it is destroyed.
+         */
+        static ResourcePreload preload_manifest(std::string const& path);
+
+        /**
+         * @returns the path of the manifest that belongs to a scene file, e.g. "scene.manifest.json" for "scene.json"
+         */
+        static std::string manifest_path(std::string const& scene_path);
+
+        /**
+         * @brief Starts or stops watching the resource directories for changes.
+         *
+         * Changed shaders, textures and models are rebuilt in the background and existing handles switch to the new version.
+         * Controlled by BoolOption::HOT_RELOAD.
+         */
+        static void hot_reload(bool enabled);
+
+        /**
+         * @brief Destroys all resources. Handles that still exist afterwards will not return any resource.
+         */
+        static void cleanup();
+
     private:
         friend class ResourceHandle<render::Shader>;
         friend class ResourceHandle<ui::Theme>;
@@ -40,31 +141,52 @@ namespace Birdy3d::core {
         friend class ResourceHandle<render::Texture>;
         friend class ResourceHandle<physics::Collider>;
 
-        static std::unordered_map<std::string, std::size_t> m_shader_indices;
-        static std::unordered_map<std::string, std::size_t> m_theme_indices;
-        static std::unordered_map<std::string, std::size_t> m_model_indices;
-        static std::unordered_map<std::string, std::size_t> m_texture_indices;
-        static std::unordered_map<std::string, std::size_t> m_collider_indices;
+        // Read by workers and coroutines, which may still run while the main thread cleans up
+        static std::atomic<bool> m_cleaned_up;
+        static std::unique_ptr<utils::FileWatcher> m_file_watcher;
+        static LoadingTelemetry m_telemetry;
+
+        // Guards the manifest recording
+        static std::mutex m_manifest_mutex;
+        static bool m_record_manifest;
+        static std::unordered_map<ResourceIdentifier, ResourceType> m_manifest;
+
+        static ResourceStorage<render::Shader> m_shaders;
+        static ResourceStorage<ui::Theme> m_themes;
+        static ResourceStorage<render::Model> m_models;
+        static ResourceStorage<render::Texture> m_textures;
+        static ResourceStorage<physics::Collider> m_colliders;
+
+        template <class T>
+        static ResourceStorage<T>& storage();
+        // Releases a reference and records the cancellation if it was the last one to a resource that was still loading.
+        template <class T>
+        static void release(std::size_t index);
 
-        static std::vector<std::unique_ptr<render::Shader>> m_shaders;
-        static std::vector<std::unique_ptr<ui::Theme>> m_themes;
-        static std::vector<std::unique_ptr<render::Model>> m_models;
-        static std::vector<std::unique_ptr<render::Texture>> m_textures;
-        static std::vector<std::unique_ptr<physics::Collider>> m_colliders;
+        // Records the completed load and caches the resource.
+        template <class T>
+        static std::size_t insert_loaded(ResourceIdentifier const& id, std::unique_ptr<T> resource);
 
-        static std::optional<std::size_t> load_shader_ptr(ResourceIdentifier const&);
+        // The returned index already holds a reference.
+        // Asynchronous loads leave the slot pending until the program is linked.
+        static std::optional<std::size_t> load_shader_ptr(ResourceIdentifier const&, bool async = false);
+        static std::size_t create_shader(ResourceIdentifier const&, render::ShaderSources);
         static std::optional<std::size_t> load_theme_ptr(ResourceIdentifier const&);
         static std::optional<std::size_t> load_model_ptr(ResourceIdentifier const&);
         static std::optional<std::size_t> load_texture_ptr(ResourceIdentifier const&);
         static std::optional<std::size_t> load_collider_ptr(ResourceIdentifier const&);
 
-        static render::Shader const* get_shader_ptr(std::size_t const&);
-        static ui::Theme const* get_theme_ptr(std::size_t const&);
-        static render::Model const* get_model_ptr(std::size_t const&);
-        static render::Texture const* get_texture_ptr(std::size_t const&);
-        static physics::Collider const* get_collider_ptr(std::size_t const&);
+        // Loading pipelines that start on a worker and finish on the main thread
+        static Task<> load_texture_file(ResourceIdentifier id, std::size_t index, std::string path, std::stop_token stop_token);
+        static Task<> load_model_file(ResourceIdentifier id, std::size_t index, std::string path, std::stop_token stop_token);
+        static Task<> load_shader_variant(ResourceIdentifier id, std::size_t index, std::stop_token stop_token);
+        // Waits for a slot whose reference the caller passes on and returns a handle to it
+        template <class T>
+        static Task<ResourceHandle<T>> when_loaded(ResourceIdentifier id, std::optional<std::size_t> index);
 
+        static void record(ResourceType, ResourceIdentifier const&);
         static std::string get_executable_dir();
+        static void reload_file(std::filesystem::path const& path);
     };
 
 }
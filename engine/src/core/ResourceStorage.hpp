@@ -0,0 +1,643 @@
+#pragma once
+
+#include "core/LoadingQueue.hpp"
+#include "core/Logger.hpp"
+#include "core/ResourceIdentifier.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Birdy3d::core {
+
+    struct ResourceMemory {
+        std::size_t cpu = 0;
+        std::size_t gpu = 0;
+
+        ResourceMemory& operator+=(ResourceMemory const& other)
+        {
+            cpu += other.cpu;
+            gpu += other.gpu;
+            return *this;
+        }
+
+        ResourceMemory& operator-=(ResourceMemory const& other)
+        {
+            cpu -= other.cpu;
+            gpu -= other.gpu;
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Thread-safe, reference counted storage for one resource type.
+     *
+     * Slots live in fixed-size chunks that are never reallocated, so get() can resolve an index without locking. Slots
+     * that were dropped and aren't referenced anymore are reused. An index contains the generation of its slot, so an
+     * index of a previous use of the slot, e.g. the one of a cancelled load, doesn't resolve to the new resource.
+     * Resources whose reference count drops to zero stay cached until they are evicted in least recently used order.
+     *
+     * Resources are keyed by the interned ResourceIdentifier, so lookups only hash and compare a pointer.
+     * Locks are always taken in the order identifier shard, then storage mutex.
+     */
+    template <class T>
+    class ResourceStorage {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Continuation = std::function<void(T const*)>;
+
+        ResourceStorage() = default;
+        ~ResourceStorage() { clear(); }
+        ResourceStorage(ResourceStorage const&) = delete;
+        ResourceStorage& operator=(ResourceStorage const&) = delete;
+
+        /**
+         * @brief Looks up a cached resource and takes a reference to it.
+         * @returns index of the resource or nothing if it isn't cached
+         */
+        std::optional<std::size_t> find(ResourceIdentifier const& id)
+        {
+            auto& shard = shard_for(id);
+            std::lock_guard<std::mutex> shard_lock{shard.mutex};
+            auto it = shard.indices.find(id);
+            if (it == shard.indices.end())
+                return {};
+            // Eviction checks the reference count while holding the shard lock, so the resource stays alive from here on.
+            slot(it->second).references.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+
+        /**
+         * @returns whether a resource with the identifier is cached or being loaded. Doesn't take a reference.
+         */
+        [[nodiscard]] bool contains(ResourceIdentifier const& id) const
+        {
+            auto const& shard = m_shards[id.hash() % SHARD_COUNT];
+            std::lock_guard<std::mutex> shard_lock{shard.mutex};
+            return shard.indices.contains(id);
+        }
+
+        /**
+         * @brief Creates a new slot holding one reference.
+         *
+         * If another thread inserted a resource with the same identifier in the meantime, a reference to that slot is returned
+         * and the given resource is discarded.
+         * @param resource The resource or nullptr, if it will be stored later
+         * @returns index of the slot
+         */
+        std::size_t insert(ResourceIdentifier const& id, std::unique_ptr<T> resource)
+        {
+            auto& shard = shard_for(id);
+            std::size_t index;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                if (auto it = shard.indices.find(id); it != shard.indices.end()) {
+                    slot(it->second).references.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+                std::lock_guard<std::mutex> lock{m_mutex};
+                index = allocate(id);
+                slot(index).references.store(1, std::memory_order_relaxed);
+                shard.indices[id] = index;
+            }
+            store(index, std::move(resource));
+            return index;
+        }
+
+        /**
+         * @brief Creates a new slot holding one reference, whose resource is loaded asynchronously.
+         *
+         * If the identifier is already cached or being loaded, a reference to that slot is returned instead.
+         * The load is cancelled when the last reference is released before the resource was stored.
+         * @param start_loading Called only for a new slot, with its index. Returns the ticket of the loading task.
+         * @returns index of the slot
+         */
+        std::size_t insert_pending(ResourceIdentifier const& id, std::function<LoadingTicket(std::size_t index)> const& start_loading)
+        {
+            auto& shard = shard_for(id);
+            std::size_t index;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                if (auto it = shard.indices.find(id); it != shard.indices.end()) {
+                    slot(it->second).references.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+                std::lock_guard<std::mutex> lock{m_mutex};
+                index = allocate(id);
+                slot(index).references.store(1, std::memory_order_relaxed);
+                shard.indices[id] = index;
+            }
+
+            // The caller's reference keeps the slot pending until the ticket is set.
+            auto ticket = start_loading(index);
+            std::lock_guard<std::mutex> lock{m_mutex};
+            slot(index).ticket = std::move(ticket);
+            return index;
+        }
+
+        /**
+         * @brief Changes the loading priority of a resource that is still being loaded.
+         */
+        void prioritize(std::size_t index, float priority)
+        {
+            if (get(index))
+                return;
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (current(index))
+                slot(index).ticket.priority(priority);
+        }
+
+        /**
+         * @brief Stores an asynchronously loaded resource in its slot. Can be called from any thread.
+         *
+         * The resource is discarded, if the slot was evicted or already filled in the meantime.
+         * Storing nullptr is a no-op. The continuations of the slot run on the calling thread.
+         */
+        void store(std::size_t index, std::unique_ptr<T> resource)
+        {
+            if (!resource)
+                return;
+            std::vector<Continuation> continuations;
+            T const* stored;
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                stored = resource.get();
+                if (!store_locked(index, resource))
+                    return;
+                continuations = std::move(slot(index).continuations);
+            }
+            for (auto const& continuation : continuations)
+                continuation(stored);
+        }
+
+        /**
+         * @brief Marks the asynchronous load of a slot as failed. Its continuations run with nullptr on the calling thread.
+         *
+         * The slot can't be found anymore, so the next request for the identifier loads it again. Handles drop the
+         * failed slot once they notice.
+         */
+        void fail(std::size_t index)
+        {
+            ResourceIdentifier id;
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                if (!current(index))
+                    return;
+                id = slot(index).id;
+            }
+            auto& shard = shard_for(id);
+            std::vector<Continuation> continuations;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                std::lock_guard<std::mutex> lock{m_mutex};
+                auto& slot = this->slot(index);
+                if (!current(index) || slot.resource.load(std::memory_order_relaxed))
+                    return;
+                if (auto it = shard.indices.find(id); it != shard.indices.end() && it->second == index)
+                    shard.indices.erase(it);
+                slot.failed.store(true, std::memory_order_release);
+                slot.ticket = {};
+                continuations = std::move(slot.continuations);
+            }
+            for (auto const& continuation : continuations)
+                continuation(nullptr);
+        }
+
+        /**
+         * @brief Runs a continuation once the resource of a slot is stored or its load failed.
+         *
+         * Finished slots run the continuation immediately. Otherwise it runs on the thread that calls store() or fail().
+         * The caller must hold a reference to the slot until the continuation ran, so that the load can't be cancelled.
+         * @param continuation Receives the resource or nullptr if the load failed
+         */
+        void then(std::size_t index, Continuation continuation)
+        {
+            T const* resource;
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                auto& slot = this->slot(index);
+                resource = slot.resource.load(std::memory_order_relaxed);
+                if (!resource && !slot.failed.load(std::memory_order_relaxed)) {
+                    slot.continuations.push_back(std::move(continuation));
+                    return;
+                }
+            }
+            continuation(resource);
+        }
+
+        /**
+         * @brief Resolves an index without locking.
+         * @returns the resource or nullptr if it isn't loaded (yet)
+         */
+        [[nodiscard]] T const* get(std::size_t index) const
+        {
+            if (position(index) >= m_size.load(std::memory_order_acquire))
+                return nullptr;
+            auto& slot = this->slot(index);
+            auto resource = slot.resource.load(std::memory_order_acquire);
+            if (slot.generation.load(std::memory_order_acquire) != generation(index))
+                return nullptr;
+            return resource;
+        }
+
+        /**
+         * @returns whether the load of the slot failed. Doesn't lock.
+         */
+        [[nodiscard]] bool failed(std::size_t index) const
+        {
+            if (position(index) >= m_size.load(std::memory_order_acquire))
+                return false;
+            return current(index) && slot(index).failed.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Takes another reference. The caller must already hold a reference to the slot.
+         */
+        void retain(std::size_t index)
+        {
+            slot(index).references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Releases a reference. Unreferenced resources stay cached until they are evicted.
+         * @returns identifier of the resource, if the last reference to it was released while it was still being loaded,
+         * which cancels the load
+         */
+        std::optional<ResourceIdentifier> release(std::size_t index)
+        {
+            auto& slot = this->slot(index);
+            // The slot may be reused as soon as the reference is gone, so the identifier is copied before. Successors
+            // share it, so one shard lock covers them.
+            auto id = slot.id;
+            if (slot.references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return {};
+            auto& shard = shard_for(id);
+            // Destroyed after the locks are released
+            std::vector<std::unique_ptr<T>> dropped;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                std::lock_guard<std::mutex> lock{m_mutex};
+                if (released_locked(index, shard, dropped))
+                    return id;
+                return {};
+            }
+        }
+
+        /**
+         * @returns the identifier the slot was created for. It doesn't change while the slot is referenced.
+         */
+        [[nodiscard]] ResourceIdentifier const& id(std::size_t index) const
+        {
+            return slot(index).id;
+        }
+
+        /**
+         * @brief Replaces a cached resource with a newer version.
+         *
+         * Handles to the old version switch to the new one the next time they follow successor().
+         * The resource is discarded, if no resource with that identifier is cached anymore.
+         */
+        void replace(ResourceIdentifier const& id, std::unique_ptr<T> resource)
+        {
+            if (!resource)
+                return;
+            auto& shard = shard_for(id);
+            std::unique_ptr<T> dropped;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                auto it = shard.indices.find(id);
+                if (it == shard.indices.end())
+                    return;
+                std::lock_guard<std::mutex> lock{m_mutex};
+                auto old_index = it->second;
+                auto new_index = allocate(id);
+                it->second = new_index;
+                store_locked(new_index, resource);
+
+                auto& old_slot = slot(old_index);
+                if (old_slot.references.load(std::memory_order_acquire) > 0) {
+                    // The old slot keeps the new one alive until the last handle switched over.
+                    slot(new_index).references.fetch_add(1, std::memory_order_relaxed);
+                    unmark_unused(new_index);
+                    old_slot.successor.store(new_index, std::memory_order_release);
+                } else {
+                    dropped = drop_locked(old_index);
+                    recycle_locked(old_index);
+                }
+            }
+        }
+
+        /**
+         * @returns index of the resource that replaced the resource at index or nothing
+         */
+        [[nodiscard]] std::optional<std::size_t> successor(std::size_t index) const
+        {
+            if (position(index) >= m_size.load(std::memory_order_acquire))
+                return {};
+            auto successor = slot(index).successor.load(std::memory_order_acquire);
+            if (successor == NO_SUCCESSOR || !current(index))
+                return {};
+            return successor;
+        }
+
+        /**
+         * @returns identifiers of all cached resources
+         */
+        [[nodiscard]] std::vector<ResourceIdentifier> ids() const
+        {
+            std::vector<ResourceIdentifier> ids;
+            for (auto const& shard : m_shards) {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                for (auto const& [id, index] : shard.indices) {
+                    if (get(index))
+                        ids.push_back(id);
+                }
+            }
+            return ids;
+        }
+
+        [[nodiscard]] ResourceMemory memory() const
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            return m_memory;
+        }
+
+        /**
+         * @brief Finds the least recently used unreferenced resource which occupies memory of the given kind.
+         * @returns the time the resource was released
+         */
+        [[nodiscard]] std::optional<Clock::time_point> oldest_unused(bool cpu, bool gpu)
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (auto index = find_oldest_unused(cpu, gpu))
+                return slot(index.value()).released;
+            return {};
+        }
+
+        /**
+         * @brief Evicts the least recently used unreferenced resource which occupies memory of the given kind.
+         *
+         * The resource is destroyed on the calling thread.
+         * @returns false if there was nothing to evict
+         */
+        bool evict_oldest_unused(bool cpu, bool gpu)
+        {
+            std::size_t index;
+            ResourceIdentifier id;
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                auto candidate = find_oldest_unused(cpu, gpu);
+                if (!candidate.has_value())
+                    return false;
+                index = candidate.value();
+                id = slot(index).id;
+            }
+
+            auto& shard = shard_for(id);
+            std::unique_ptr<T> dropped;
+            {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                std::lock_guard<std::mutex> lock{m_mutex};
+                auto& candidate = slot(index);
+                // Another thread may have taken a reference or evicted the resource while no lock was held.
+                if (!current(index) || candidate.evicted || !candidate.unused_position.has_value() || candidate.references.load(std::memory_order_acquire) != 0)
+                    return true;
+                if (auto it = shard.indices.find(id); it != shard.indices.end() && it->second == index)
+                    shard.indices.erase(it);
+                dropped = drop_locked(index);
+                recycle_locked(index);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Destroys all resources, including the referenced ones.
+         */
+        void clear()
+        {
+            for (auto& shard : m_shards) {
+                std::lock_guard<std::mutex> shard_lock{shard.mutex};
+                shard.indices.clear();
+            }
+            std::lock_guard<std::mutex> lock{m_mutex};
+            auto size = m_size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i)
+                delete slot(i).resource.exchange(nullptr, std::memory_order_acq_rel);
+            m_size.store(0, std::memory_order_release);
+            for (auto& chunk : m_chunks)
+                delete chunk.exchange(nullptr, std::memory_order_acq_rel);
+            m_unused.clear();
+            m_free_positions.clear();
+            m_memory = {};
+        }
+
+        /// @returns amount of slots, including the unused ones
+        [[nodiscard]] std::size_t capacity() const { return m_size.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Measures the memory used by a resource. Specialized for each resource type.
+         */
+        static ResourceMemory memory_usage(T const&);
+
+    private:
+        static std::size_t constexpr CHUNK_SIZE = 256;
+        static std::size_t constexpr MAX_CHUNKS = 4096;
+        static std::size_t constexpr SHARD_COUNT = 16;
+        static std::size_t constexpr NO_SUCCESSOR = static_cast<std::size_t>(-1);
+        // An index is the generation of the slot in the upper and its position in the lower bits.
+        static std::size_t constexpr POSITION_BITS = 32;
+        static std::size_t constexpr POSITION_MASK = (std::size_t(1) << POSITION_BITS) - 1;
+
+        struct Slot {
+            // Accessed without locking
+            std::atomic<T*> resource = nullptr;
+            std::atomic<std::size_t> references = 0;
+            std::atomic<std::size_t> successor = NO_SUCCESSOR;
+            // Incremented whenever the slot is freed
+            std::atomic<std::uint32_t> generation = 0;
+            std::atomic<bool> failed = false;
+
+            // Guarded by m_mutex
+            ResourceIdentifier id;
+            ResourceMemory memory;
+            Clock::time_point released;
+            std::optional<std::list<std::size_t>::iterator> unused_position;
+            LoadingTicket ticket;
+            std::vector<Continuation> continuations;
+            bool evicted = false;
+        };
+
+        struct Chunk {
+            std::array<Slot, CHUNK_SIZE> slots;
+        };
+
+        struct Shard {
+            std::mutex mutable mutex;
+            std::unordered_map<ResourceIdentifier, std::size_t> indices;
+        };
+
+        std::array<std::atomic<Chunk*>, MAX_CHUNKS> m_chunks{};
+        std::atomic<std::size_t> m_size = 0;
+        std::array<Shard, SHARD_COUNT> m_shards;
+
+        // Guards everything below and the slot fields marked above
+        std::mutex mutable m_mutex;
+        // Unreferenced resources, least recently used first. May contain slots that were retained again by find().
+        std::list<std::size_t> m_unused;
+        // Positions of slots that can be reused
+        std::vector<std::size_t> m_free_positions;
+        ResourceMemory m_memory;
+
+        static std::size_t position(std::size_t index) { return index & POSITION_MASK; }
+        static std::uint32_t generation(std::size_t index) { return static_cast<std::uint32_t>(index >> POSITION_BITS); }
+
+        [[nodiscard]] Slot& slot(std::size_t index) const
+        {
+            auto position = this->position(index);
+            return m_chunks[position / CHUNK_SIZE].load(std::memory_order_acquire)->slots[position % CHUNK_SIZE];
+        }
+
+        /// @returns whether the index refers to the current use of its slot
+        [[nodiscard]] bool current(std::size_t index) const
+        {
+            return slot(index).generation.load(std::memory_order_acquire) == generation(index);
+        }
+
+        Shard& shard_for(ResourceIdentifier const& id)
+        {
+            return m_shards[id.hash() % SHARD_COUNT];
+        }
+
+        std::size_t allocate(ResourceIdentifier const& id)
+        {
+            if (!m_free_positions.empty()) {
+                auto position = m_free_positions.back();
+                m_free_positions.pop_back();
+                auto& slot = this->slot(position);
+                slot.id = id;
+                return (std::size_t(slot.generation.load(std::memory_order_relaxed)) << POSITION_BITS) | position;
+            }
+            auto position = m_size.load(std::memory_order_relaxed);
+            auto chunk_index = position / CHUNK_SIZE;
+            if (chunk_index >= MAX_CHUNKS)
+                Logger::critical("Too many resources");
+            if (!m_chunks[chunk_index].load(std::memory_order_relaxed))
+                m_chunks[chunk_index].store(new Chunk, std::memory_order_release);
+            slot(position).id = id;
+            m_size.store(position + 1, std::memory_order_release);
+            return position;
+        }
+
+        /**
+         * @brief Makes a dropped slot available to allocate(). Nothing may reference it or find it anymore.
+         */
+        void recycle_locked(std::size_t index)
+        {
+            auto& slot = this->slot(index);
+            // Indices of the previous use stop resolving from here on.
+            slot.generation.fetch_add(1, std::memory_order_acq_rel);
+            slot.successor.store(NO_SUCCESSOR, std::memory_order_relaxed);
+            slot.references.store(0, std::memory_order_relaxed);
+            slot.released = {};
+            slot.ticket = {};
+            slot.continuations.clear();
+            slot.failed.store(false, std::memory_order_relaxed);
+            slot.evicted = false;
+            m_free_positions.push_back(position(index));
+        }
+
+        bool store_locked(std::size_t index, std::unique_ptr<T>& resource)
+        {
+            auto& slot = this->slot(index);
+            if (!current(index) || slot.evicted || slot.resource.load(std::memory_order_relaxed))
+                return false;
+            slot.memory = memory_usage(*resource);
+            m_memory += slot.memory;
+            slot.ticket = {};
+            slot.resource.store(resource.release(), std::memory_order_release);
+            if (slot.references.load(std::memory_order_acquire) == 0)
+                mark_unused(index);
+            return true;
+        }
+
+        bool released_locked(std::size_t index, Shard& shard, std::vector<std::unique_ptr<T>>& dropped)
+        {
+            auto& slot = this->slot(index);
+            // The slot may have been reused since the reference count dropped to zero.
+            if (!current(index) || slot.evicted || slot.references.load(std::memory_order_acquire) != 0)
+                return false;
+            auto successor = slot.successor.load(std::memory_order_acquire);
+            if (successor != NO_SUCCESSOR) {
+                // Replaced resources can't be found anymore, so there is no reason to cache them.
+                dropped.push_back(drop_locked(index));
+                recycle_locked(index);
+                if (this->slot(successor).references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    released_locked(successor, shard, dropped);
+            } else if (slot.resource.load(std::memory_order_relaxed)) {
+                mark_unused(index);
+            } else {
+                // Nobody is waiting for the resource anymore
+                slot.ticket.cancel();
+                if (auto it = shard.indices.find(slot.id); it != shard.indices.end() && it->second == index)
+                    shard.indices.erase(it);
+                dropped.push_back(drop_locked(index));
+                recycle_locked(index);
+                return true;
+            }
+            return false;
+        }
+
+        void mark_unused(std::size_t index)
+        {
+            unmark_unused(index);
+            auto& slot = this->slot(index);
+            slot.released = Clock::now();
+            slot.unused_position = m_unused.insert(m_unused.end(), index);
+        }
+
+        void unmark_unused(std::size_t index)
+        {
+            auto& slot = this->slot(index);
+            if (slot.unused_position.has_value()) {
+                m_unused.erase(slot.unused_position.value());
+                slot.unused_position = {};
+            }
+        }
+
+        std::unique_ptr<T> drop_locked(std::size_t index)
+        {
+            auto& slot = this->slot(index);
+            unmark_unused(index);
+            m_memory -= slot.memory;
+            slot.memory = {};
+            slot.evicted = true;
+            return std::unique_ptr<T>(slot.resource.exchange(nullptr, std::memory_order_acq_rel));
+        }
+
+        std::optional<std::size_t> find_oldest_unused(bool cpu, bool gpu)
+        {
+            for (auto it = m_unused.begin(); it != m_unused.end();) {
+                auto index = *it;
+                auto& slot = this->slot(index);
+                if (slot.references.load(std::memory_order_acquire) != 0) {
+                    // Retained again by find() since it was marked unused
+                    slot.unused_position = {};
+                    it = m_unused.erase(it);
+                    continue;
+                }
+                if ((cpu && slot.memory.cpu > 0) || (gpu && slot.memory.gpu > 0))
+                    return index;
+                ++it;
+            }
+            return {};
+        }
+    };
+
+}
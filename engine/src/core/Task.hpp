@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/Application.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace Birdy3d::core {
+
+    template <typename T>
+    class Task;
+
+    namespace detail {
+
+        struct TaskPromiseBase {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            bool detached = false;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    auto& promise = handle.promise();
+                    if (promise.detached) {
+                        if (promise.exception) {
+                            try {
+                                std::rethrow_exception(promise.exception);
+                            } catch (std::exception const& e) {
+                                Logger::error("Unhandled exception in detached task: {}", e.what());
+                            } catch (...) {
+                                Logger::error("Unhandled exception in detached task");
+                            }
+                        }
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (promise.continuation)
+                        return promise.continuation;
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept { }
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        template <typename T>
+        struct TaskPromise : TaskPromiseBase {
+            std::optional<T> value;
+
+            Task<T> get_return_object();
+            void return_value(T v) { value.emplace(std::move(v)); }
+
+            T result()
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+                return std::move(value.value());
+            }
+        };
+
+        template <>
+        struct TaskPromise<void> : TaskPromiseBase {
+            Task<void> get_return_object();
+            void return_void() { }
+
+            void result()
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+
+    }
+
+    /**
+     * @brief Lazily started coroutine, e.g. for loading pipelines that switch between worker and main thread.
+     *
+     * The coroutine starts when it is awaited or detached and continues on whichever thread resumes it, see
+     * resume_on_main() and resume_on_worker(). Awaiting a task returns its result or rethrows its exception.
+     */
+    template <typename T = void>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task(Task&& other) noexcept
+            : m_handle(std::exchange(other.m_handle, {}))
+        { }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other) {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        /**
+         * @brief Starts the coroutine on the calling thread without waiting for it.
+         *
+         * The coroutine frame is destroyed when the coroutine finishes. Exceptions are logged.
+         */
+        void detach() &&
+        {
+            auto handle = std::exchange(m_handle, {});
+            handle.promise().detached = true;
+            handle.resume();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().result(); }
+            };
+            return Awaiter{m_handle};
+        }
+
+    private:
+        friend promise_type;
+
+        std::coroutine_handle<promise_type> m_handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle)
+            : m_handle(handle)
+        { }
+    };
+
+    template <typename T>
+    Task<T> detail::TaskPromise<T>::get_return_object()
+    {
+        return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+    }
+
+    inline Task<void> detail::TaskPromise<void>::get_return_object()
+    {
+        return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+    }
+
+    /**
+     * @brief Continues the awaiting coroutine on the main thread, during the next iteration of the mainloop.
+     */
+    inline auto resume_on_main()
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { Application::defer_main([handle]() { handle.resume(); }); }
+            void await_resume() noexcept { }
+        };
+        return Awaiter{};
+    }
+
+    /**
+     * @brief Continues the awaiting coroutine as a job on a worker of the JobSystem.
+     */
+    inline auto resume_on_worker()
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { JobSystem::run([handle]() { handle.resume(); }); }
+            void await_resume() noexcept { }
+        };
+        return Awaiter{};
+    }
+
+}
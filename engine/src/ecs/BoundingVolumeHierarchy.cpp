@@ -0,0 +1,372 @@
+#include "ecs/BoundingVolumeHierarchy.hpp"
+
+namespace Birdy3d::ecs {
+
+    BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+    {
+        // The job writes into the shared result, which outlives the tree, but waiting keeps workers from doing useless work
+        // after the scene is gone. Once the JobSystem was cleaned up the job either finished or was discarded and never
+        // finishes.
+        if (m_rebuild_job && core::JobSystem::running())
+            core::JobSystem::wait(m_rebuild_job);
+    }
+
+    BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::insert(Component* component, BoundsLayer layer, render::BoundingBox const& box)
+    {
+        ProxyId proxy;
+        if (!m_free_proxies.empty()) {
+            proxy = m_free_proxies.back();
+            m_free_proxies.pop_back();
+        } else {
+            proxy = m_proxies.size();
+            m_proxies.emplace_back();
+        }
+        m_proxies[proxy] = {component, layer, Aabb::from(box), NONE};
+        m_proxies[proxy].leaf = create_leaf(proxy);
+        insert_leaf(m_proxies[proxy].leaf);
+        mark_changed(proxy);
+        return proxy;
+    }
+
+    void BoundingVolumeHierarchy::remove(ProxyId proxy)
+    {
+        auto& entry = m_proxies[proxy];
+        remove_leaf(entry.leaf);
+        free_node(entry.leaf);
+        entry = {};
+        m_free_proxies.push_back(proxy);
+        mark_changed(proxy);
+    }
+
+    void BoundingVolumeHierarchy::move(ProxyId proxy, render::BoundingBox const& box)
+    {
+        auto& entry = m_proxies[proxy];
+        entry.box = Aabb::from(box);
+        // The leaf in a running rebuild was enlarged around the old box, which might not contain the new one.
+        mark_changed(proxy);
+        if (m_nodes[entry.leaf].box.contains(entry.box))
+            return;
+        remove_leaf(entry.leaf);
+        m_nodes[entry.leaf].box = enlarged(entry.box);
+        insert_leaf(entry.leaf);
+        ++m_reinsertions;
+    }
+
+    void BoundingVolumeHierarchy::rebuild()
+    {
+        // A running asynchronous rebuild is older than this one. The job keeps its own reference to the result, so it can
+        // be discarded without waiting.
+        m_rebuild_job.reset();
+        m_rebuild_result.reset();
+        auto leaves = build_leaves();
+        BuildResult result;
+        result.nodes.reserve(leaves.size() * 2);
+        result.root = build(result.nodes, leaves, NONE);
+        m_changed_during_rebuild.clear();
+        adopt(std::move(result));
+    }
+
+    void BoundingVolumeHierarchy::rebuild_async()
+    {
+        if (m_rebuild_job)
+            return;
+        // The worker only sees a copy of the leaves, the tree itself keeps changing in the meantime.
+        auto result = std::make_shared<BuildResult>();
+        m_rebuild_result = result;
+        m_changed_during_rebuild.clear();
+        m_rebuild_job = core::JobSystem::run([result, leaves = build_leaves()]() mutable {
+            result->nodes.reserve(leaves.size() * 2);
+            result->root = build(result->nodes, leaves, NONE);
+        });
+    }
+
+    void BoundingVolumeHierarchy::poll_rebuild()
+    {
+        if (!m_rebuild_job || !m_rebuild_job->finished())
+            return;
+        m_rebuild_job.reset();
+        auto result = std::move(m_rebuild_result);
+        adopt(std::move(*result));
+    }
+
+    bool BoundingVolumeHierarchy::degraded() const
+    {
+        return m_reinsertions > std::max<std::size_t>(64, size());
+    }
+
+    BoundingVolumeHierarchy::Aabb BoundingVolumeHierarchy::enlarged(Aabb const& box)
+    {
+        glm::vec3 margin = (box.high - box.low) * 0.1f + 0.05f;
+        return {box.low - margin, box.high + margin};
+    }
+
+    BoundingVolumeHierarchy::NodeIndex BoundingVolumeHierarchy::allocate_node()
+    {
+        if (!m_free_nodes.empty()) {
+            auto index = m_free_nodes.back();
+            m_free_nodes.pop_back();
+            m_nodes[index] = {};
+            return index;
+        }
+        m_nodes.emplace_back();
+        return m_nodes.size() - 1;
+    }
+
+    void BoundingVolumeHierarchy::free_node(NodeIndex index)
+    {
+        m_nodes[index] = {};
+        m_free_nodes.push_back(index);
+    }
+
+    BoundingVolumeHierarchy::NodeIndex BoundingVolumeHierarchy::create_leaf(ProxyId proxy)
+    {
+        auto leaf = allocate_node();
+        m_nodes[leaf].box = enlarged(m_proxies[proxy].box);
+        m_nodes[leaf].proxy = proxy;
+        m_nodes[leaf].layers = static_cast<std::uint8_t>(m_proxies[proxy].layer);
+        return leaf;
+    }
+
+    void BoundingVolumeHierarchy::insert_leaf(NodeIndex leaf)
+    {
+        if (m_root == NONE) {
+            m_root = leaf;
+            m_nodes[leaf].parent = NONE;
+            return;
+        }
+
+        // Descends to the sibling that increases the surface area of the tree the least.
+        Aabb leaf_box = m_nodes[leaf].box;
+        NodeIndex sibling = m_root;
+        while (!m_nodes[sibling].leaf()) {
+            auto const& node = m_nodes[sibling];
+            float area = node.box.area();
+            float combined_area = node.box.merged(leaf_box).area();
+            // Cost of making the leaf and the node siblings under a new parent
+            float cost = 2.0f * combined_area;
+            // Every ancestor of a deeper sibling grows as well
+            float inheritance_cost = 2.0f * (combined_area - area);
+            auto descend_cost = [&](NodeIndex child) {
+                auto const& child_node = m_nodes[child];
+                float merged_area = child_node.box.merged(leaf_box).area();
+                if (child_node.leaf())
+                    return merged_area + inheritance_cost;
+                return merged_area - child_node.box.area() + inheritance_cost;
+            };
+            float left_cost = descend_cost(node.left);
+            float right_cost = descend_cost(node.right);
+            if (cost < left_cost && cost < right_cost)
+                break;
+            sibling = left_cost < right_cost ? node.left : node.right;
+        }
+
+        NodeIndex old_parent = m_nodes[sibling].parent;
+        NodeIndex new_parent = allocate_node();
+        m_nodes[new_parent].parent = old_parent;
+        m_nodes[new_parent].left = sibling;
+        m_nodes[new_parent].right = leaf;
+        m_nodes[sibling].parent = new_parent;
+        m_nodes[leaf].parent = new_parent;
+        if (old_parent == NONE)
+            m_root = new_parent;
+        else
+            replace_child(old_parent, sibling, new_parent);
+
+        for (NodeIndex index = new_parent; index != NONE; index = m_nodes[index].parent) {
+            index = balance(index);
+            refit(index);
+        }
+    }
+
+    void BoundingVolumeHierarchy::remove_leaf(NodeIndex leaf)
+    {
+        if (leaf == m_root) {
+            m_root = NONE;
+            return;
+        }
+
+        NodeIndex parent = m_nodes[leaf].parent;
+        NodeIndex grandparent = m_nodes[parent].parent;
+        NodeIndex sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+        free_node(parent);
+        m_nodes[leaf].parent = NONE;
+        m_nodes[sibling].parent = grandparent;
+        if (grandparent == NONE) {
+            m_root = sibling;
+            return;
+        }
+        replace_child(grandparent, parent, sibling);
+        for (NodeIndex index = grandparent; index != NONE; index = m_nodes[index].parent) {
+            index = balance(index);
+            refit(index);
+        }
+    }
+
+    void BoundingVolumeHierarchy::refit(NodeIndex index)
+    {
+        auto& node = m_nodes[index];
+        auto const& left = m_nodes[node.left];
+        auto const& right = m_nodes[node.right];
+        node.box = left.box.merged(right.box);
+        node.height = 1 + std::max(left.height, right.height);
+        node.layers = left.layers | right.layers;
+    }
+
+    BoundingVolumeHierarchy::NodeIndex BoundingVolumeHierarchy::balance(NodeIndex a)
+    {
+        // AVL rotation: the higher child of A takes its place, and A takes the lower grandchild below it.
+        if (m_nodes[a].leaf() || m_nodes[a].height < 2)
+            return a;
+        NodeIndex b = m_nodes[a].left;
+        NodeIndex c = m_nodes[a].right;
+        int difference = m_nodes[c].height - m_nodes[b].height;
+        if (difference > 1) {
+            NodeIndex f = m_nodes[c].left;
+            NodeIndex g = m_nodes[c].right;
+            m_nodes[c].left = a;
+            m_nodes[c].parent = m_nodes[a].parent;
+            m_nodes[a].parent = c;
+            if (m_nodes[c].parent == NONE)
+                m_root = c;
+            else
+                replace_child(m_nodes[c].parent, a, c);
+            if (m_nodes[f].height > m_nodes[g].height) {
+                m_nodes[c].right = f;
+                m_nodes[a].right = g;
+                m_nodes[g].parent = a;
+            } else {
+                m_nodes[c].right = g;
+                m_nodes[a].right = f;
+                m_nodes[f].parent = a;
+            }
+            refit(a);
+            refit(c);
+            return c;
+        }
+        if (difference < -1) {
+            NodeIndex d = m_nodes[b].left;
+            NodeIndex e = m_nodes[b].right;
+            m_nodes[b].left = a;
+            m_nodes[b].parent = m_nodes[a].parent;
+            m_nodes[a].parent = b;
+            if (m_nodes[b].parent == NONE)
+                m_root = b;
+            else
+                replace_child(m_nodes[b].parent, a, b);
+            if (m_nodes[d].height > m_nodes[e].height) {
+                m_nodes[b].right = d;
+                m_nodes[a].left = e;
+                m_nodes[e].parent = a;
+            } else {
+                m_nodes[b].right = e;
+                m_nodes[a].left = d;
+                m_nodes[d].parent = a;
+            }
+            refit(a);
+            refit(b);
+            return b;
+        }
+        return a;
+    }
+
+    void BoundingVolumeHierarchy::replace_child(NodeIndex parent, NodeIndex old_child, NodeIndex new_child)
+    {
+        if (m_nodes[parent].left == old_child)
+            m_nodes[parent].left = new_child;
+        else
+            m_nodes[parent].right = new_child;
+    }
+
+    void BoundingVolumeHierarchy::mark_changed(ProxyId proxy)
+    {
+        if (m_rebuild_job)
+            m_changed_during_rebuild.push_back(proxy);
+    }
+
+    std::vector<BoundingVolumeHierarchy::BuildLeaf> BoundingVolumeHierarchy::build_leaves() const
+    {
+        std::vector<BuildLeaf> leaves;
+        leaves.reserve(size());
+        for (ProxyId proxy = 0; proxy < m_proxies.size(); ++proxy) {
+            auto const& entry = m_proxies[proxy];
+            if (entry.component)
+                leaves.push_back({proxy, enlarged(entry.box), static_cast<std::uint8_t>(entry.layer)});
+        }
+        return leaves;
+    }
+
+    void BoundingVolumeHierarchy::adopt(BuildResult&& result)
+    {
+        m_nodes = std::move(result.nodes);
+        m_free_nodes.clear();
+        m_root = result.root;
+        m_reinsertions = 0;
+
+        std::vector<NodeIndex> new_leaves(m_proxies.size(), NONE);
+        for (NodeIndex index = 0; index < m_nodes.size(); ++index) {
+            if (m_nodes[index].leaf())
+                new_leaves[m_nodes[index].proxy] = index;
+        }
+        for (ProxyId proxy = 0; proxy < m_proxies.size(); ++proxy)
+            m_proxies[proxy].leaf = new_leaves[proxy];
+
+        // The leaves of proxies that changed during an asynchronous rebuild are out of date.
+        std::sort(m_changed_during_rebuild.begin(), m_changed_during_rebuild.end());
+        auto last = std::unique(m_changed_during_rebuild.begin(), m_changed_during_rebuild.end());
+        for (auto it = m_changed_during_rebuild.begin(); it != last; ++it) {
+            auto& entry = m_proxies[*it];
+            if (entry.leaf != NONE) {
+                remove_leaf(entry.leaf);
+                free_node(entry.leaf);
+                entry.leaf = NONE;
+            }
+            if (entry.component) {
+                entry.leaf = create_leaf(*it);
+                insert_leaf(entry.leaf);
+            }
+        }
+        m_changed_during_rebuild.clear();
+    }
+
+    BoundingVolumeHierarchy::NodeIndex BoundingVolumeHierarchy::build(std::vector<Node>& nodes, std::span<BuildLeaf> leaves, NodeIndex parent)
+    {
+        if (leaves.empty())
+            return NONE;
+
+        NodeIndex index = nodes.size();
+        nodes.emplace_back();
+        nodes[index].parent = parent;
+        if (leaves.size() == 1) {
+            nodes[index].box = leaves[0].box;
+            nodes[index].proxy = leaves[0].proxy;
+            nodes[index].layers = leaves[0].layers;
+            return index;
+        }
+
+        // Splits at the median of the centers along the axis in which the centers are spread the most.
+        glm::vec3 low(std::numeric_limits<float>::infinity());
+        glm::vec3 high(-std::numeric_limits<float>::infinity());
+        for (auto const& leaf : leaves) {
+            glm::vec3 center = leaf.box.low + leaf.box.high;
+            low = glm::min(low, center);
+            high = glm::max(high, center);
+        }
+        glm::vec3 spread = high - low;
+        int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+        auto middle = leaves.begin() + leaves.size() / 2;
+        std::nth_element(leaves.begin(), middle, leaves.end(), [axis](BuildLeaf const& a, BuildLeaf const& b) {
+            return a.box.low[axis] + a.box.high[axis] < b.box.low[axis] + b.box.high[axis];
+        });
+
+        // The vector may reallocate while the children are built, so the node is only accessed by index.
+        NodeIndex left = build(nodes, leaves.first(leaves.size() / 2), index);
+        NodeIndex right = build(nodes, leaves.subspan(leaves.size() / 2), index);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        nodes[index].box = nodes[left].box.merged(nodes[right].box);
+        nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+        nodes[index].layers = nodes[left].layers | nodes[right].layers;
+        return index;
+    }
+
+}
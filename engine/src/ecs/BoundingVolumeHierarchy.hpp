@@ -0,0 +1,261 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include "core/JobSystem.hpp"
+#include "ecs/Forward.hpp"
+#include "render/Frustum.hpp"
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace Birdy3d::ecs {
+
+    enum class BoundsLayer : std::uint8_t {
+        MODELS = 1 << 0,
+        COLLIDERS = 1 << 1,
+    };
+
+    struct Ray {
+        glm::vec3 origin;
+        // Doesn't have to be normalized, distances are measured in multiples of it.
+        glm::vec3 direction;
+        float max_distance = std::numeric_limits<float>::infinity();
+    };
+
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+    };
+
+    /**
+     * @brief Dynamic AABB tree over the world space bounds of the models and colliders of a scene.
+     *
+     * Leaves are enlarged by a margin, so that small movements don't change the tree. Inserting keeps the tree balanced
+     * with rotations. After many reinsertions a top down rebuild restores the quality of the tree, optionally on a
+     * worker while the current tree is still queried and updated.
+     *
+     * Not thread safe, the scene updates and queries it from the thread that simulates it.
+     */
+    class BoundingVolumeHierarchy {
+    public:
+        using ProxyId = std::uint32_t;
+
+        BoundingVolumeHierarchy() = default;
+        BoundingVolumeHierarchy(BoundingVolumeHierarchy const&) = delete;
+        BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy const&) = delete;
+        ~BoundingVolumeHierarchy();
+
+        ProxyId insert(Component* component, BoundsLayer layer, render::BoundingBox const& box);
+        void remove(ProxyId proxy);
+        /**
+         * @brief Updates the box of the proxy. The tree only changes if the box left the enlarged box of its leaf.
+         */
+        void move(ProxyId proxy, render::BoundingBox const& box);
+
+        /**
+         * @brief Calls callback(Component*) for every proxy of the layer whose box intersects the frustum.
+         */
+        template <typename F>
+        void query(render::Frustum const& frustum, BoundsLayer layer, F const& callback) const
+        {
+            traverse(
+                layer, [&](Aabb const& box) { return frustum.visible(box.bounding_box()); }, [&](Proxy const& proxy) {
+                    if (frustum.visible(proxy.box.bounding_box()))
+                        callback(proxy.component);
+                });
+        }
+
+        /**
+         * @brief Calls callback(Component*) for every proxy of the layer whose box overlaps the box.
+         */
+        template <typename F>
+        void query(render::BoundingBox const& box, BoundsLayer layer, F const& callback) const
+        {
+            auto query_box = Aabb::from(box);
+            traverse(
+                layer, [&](Aabb const& node_box) { return node_box.overlaps(query_box); }, [&](Proxy const& proxy) {
+                    if (proxy.box.overlaps(query_box))
+                        callback(proxy.component);
+                });
+        }
+
+        /**
+         * @brief Calls callback(Component*) for every proxy of the layer whose box overlaps the sphere.
+         */
+        template <typename F>
+        void query(Sphere const& sphere, BoundsLayer layer, F const& callback) const
+        {
+            traverse(
+                layer, [&](Aabb const& box) { return box.overlaps(sphere); }, [&](Proxy const& proxy) {
+                    if (proxy.box.overlaps(sphere))
+                        callback(proxy.component);
+                });
+        }
+
+        /**
+         * @brief Calls callback(Component*, float distance) for every proxy of the layer whose box the ray hits.
+         *
+         * The distance is where the ray enters the box, 0 if it starts inside. The hits aren't sorted.
+         */
+        template <typename F>
+        void query(Ray const& ray, BoundsLayer layer, F const& callback) const
+        {
+            glm::vec3 inverse_direction = 1.0f / ray.direction;
+            traverse(
+                layer, [&](Aabb const& box) { return box.intersect(ray, inverse_direction).has_value(); }, [&](Proxy const& proxy) {
+                    if (auto distance = proxy.box.intersect(ray, inverse_direction))
+                        callback(proxy.component, *distance);
+                });
+        }
+
+        /**
+         * @brief Rebuilds the whole tree top down. Discards the result of a running rebuild_async().
+         */
+        void rebuild();
+        /**
+         * @brief Starts rebuilding the tree on a worker. The result is used by the first poll_rebuild() after it finished.
+         */
+        void rebuild_async();
+        /**
+         * @brief Replaces the tree with the result of rebuild_async() if it finished. Changes that were made in the
+         * meantime are applied to the new tree.
+         */
+        void poll_rebuild();
+        /// @returns whether so many leaves were reinserted since the last rebuild that a rebuild is worthwhile
+        [[nodiscard]] bool degraded() const;
+
+        /// @returns amount of proxies in the tree
+        [[nodiscard]] std::size_t size() const { return m_proxies.size() - m_free_proxies.size(); }
+        [[nodiscard]] int height() const { return m_root == NONE ? 0 : m_nodes[m_root].height; }
+
+    private:
+        using NodeIndex = std::uint32_t;
+        static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+        // Enough for any balanced tree, whose height grows with the logarithm of the leaf count
+        static constexpr std::size_t MAX_STACK_SIZE = 128;
+
+        struct Aabb {
+            glm::vec3 low{0};
+            glm::vec3 high{0};
+
+            static Aabb from(render::BoundingBox const& box) { return {box.center - box.extent, box.center + box.extent}; }
+            [[nodiscard]] render::BoundingBox bounding_box() const { return {(low + high) * 0.5f, (high - low) * 0.5f}; }
+            [[nodiscard]] Aabb merged(Aabb const& other) const { return {glm::min(low, other.low), glm::max(high, other.high)}; }
+            [[nodiscard]] bool contains(Aabb const& other) const { return glm::all(glm::lessThanEqual(low, other.low)) && glm::all(glm::greaterThanEqual(high, other.high)); }
+            [[nodiscard]] bool overlaps(Aabb const& other) const { return glm::all(glm::lessThanEqual(low, other.high)) && glm::all(glm::greaterThanEqual(high, other.low)); }
+            [[nodiscard]] bool overlaps(Sphere const& sphere) const
+            {
+                glm::vec3 closest = glm::clamp(sphere.center, low, high);
+                glm::vec3 offset = sphere.center - closest;
+                return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+            }
+            [[nodiscard]] std::optional<float> intersect(Ray const& ray, glm::vec3 inverse_direction) const
+            {
+                // Slab test, a zero component of the direction makes the distances of its axis infinite.
+                glm::vec3 t1 = (low - ray.origin) * inverse_direction;
+                glm::vec3 t2 = (high - ray.origin) * inverse_direction;
+                glm::vec3 near = glm::min(t1, t2);
+                glm::vec3 far = glm::max(t1, t2);
+                float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+                float exit = std::min(std::min(far.x, far.y), std::min(far.z, ray.max_distance));
+                if (enter > exit)
+                    return {};
+                return enter;
+            }
+            // Cost of a node in the surface area heuristic
+            [[nodiscard]] float area() const
+            {
+                glm::vec3 size = high - low;
+                return size.x * size.y + size.y * size.z + size.z * size.x;
+            }
+        };
+
+        struct Node {
+            // Enlarged box for leaves
+            Aabb box;
+            NodeIndex parent = NONE;
+            // Both are NONE for leaves
+            NodeIndex left = NONE;
+            NodeIndex right = NONE;
+            ProxyId proxy = NONE;
+            // 0 for leaves
+            int height = 0;
+            // Layers of the leaves below the node
+            std::uint8_t layers = 0;
+
+            [[nodiscard]] bool leaf() const { return left == NONE; }
+        };
+
+        struct Proxy {
+            // nullptr if the proxy is free
+            Component* component = nullptr;
+            BoundsLayer layer = BoundsLayer::MODELS;
+            Aabb box;
+            NodeIndex leaf = NONE;
+        };
+
+        struct BuildLeaf {
+            ProxyId proxy;
+            Aabb box;
+            std::uint8_t layers;
+        };
+
+        struct BuildResult {
+            std::vector<Node> nodes;
+            NodeIndex root = NONE;
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<NodeIndex> m_free_nodes;
+        NodeIndex m_root = NONE;
+        std::vector<Proxy> m_proxies;
+        std::vector<ProxyId> m_free_proxies;
+        std::size_t m_reinsertions = 0;
+
+        core::JobHandle m_rebuild_job;
+        std::shared_ptr<BuildResult> m_rebuild_result;
+        // Proxies that were inserted, moved or removed since the snapshot of the running rebuild was taken
+        std::vector<ProxyId> m_changed_during_rebuild;
+
+        template <typename Test, typename Visit>
+        void traverse(BoundsLayer layer, Test const& test, Visit const& visit) const
+        {
+            if (m_root == NONE)
+                return;
+            auto layer_bit = static_cast<std::uint8_t>(layer);
+            std::array<NodeIndex, MAX_STACK_SIZE> stack;
+            std::size_t stack_size = 0;
+            stack[stack_size++] = m_root;
+            while (stack_size > 0) {
+                auto const& node = m_nodes[stack[--stack_size]];
+                if (!(node.layers & layer_bit) || !test(node.box))
+                    continue;
+                if (node.leaf()) {
+                    visit(m_proxies[node.proxy]);
+                    continue;
+                }
+                assert(stack_size + 2 <= MAX_STACK_SIZE);
+                stack[stack_size++] = node.left;
+                stack[stack_size++] = node.right;
+            }
+        }
+
+        static Aabb enlarged(Aabb const& box);
+        NodeIndex allocate_node();
+        void free_node(NodeIndex);
+        void insert_leaf(NodeIndex leaf);
+        void remove_leaf(NodeIndex leaf);
+        NodeIndex create_leaf(ProxyId proxy);
+        void refit(NodeIndex);
+        NodeIndex balance(NodeIndex);
+        void replace_child(NodeIndex parent, NodeIndex old_child, NodeIndex new_child);
+        void mark_changed(ProxyId proxy);
+        std::vector<BuildLeaf> build_leaves() const;
+        void adopt(BuildResult&& result);
+
+        static NodeIndex build(std::vector<Node>& nodes, std::span<BuildLeaf> leaves, NodeIndex parent);
+    };
+
+}
@@ -123,6 +123,9 @@ namespace Birdy3d::ecs {
         for (auto const& c : m_components) {
             c->external_cleanup();
         }
+        // The components of descendants have to be cleaned up as well, e.g. to remove their bounds from the scene.
+        for (auto const& o : m_children)
+            o->cleanup();
     }
 
     glm::vec3 Entity::world_forward()
@@ -1,7 +1,10 @@
 #include "ecs/Scene.hpp"
 
+#include "core/Application.hpp"
+#include "physics/ColliderComponent.hpp"
 #include "physics/PhysicsWorld.hpp"
 #include "render/Camera.hpp"
+#include "render/ModelComponent.hpp"
 
 namespace Birdy3d::ecs {
 
@@ -19,13 +22,49 @@ namespace Birdy3d::ecs {
     }
 
     void Scene::update()
+    {
+        update_components();
+        simulate();
+    }
+
+    void Scene::update_components()
     {
         Entity::update();
+        // Options must only be read on the main thread, the simulation may run on a worker.
+        m_background_bvh_rebuild = core::Application::option_bool(core::BoolOption::BACKGROUND_BVH_REBUILD);
+    }
+
+    void Scene::simulate()
+    {
         transform.update();
         m_physics_world->update();
         transform.update();
     }
 
+    void Scene::refit_bounds(std::vector<Entity*> const& moved)
+    {
+        for (auto moved_entity : moved) {
+            m_moved_models.clear();
+            m_moved_colliders.clear();
+            moved_entity->get_components(m_moved_models);
+            moved_entity->get_components(m_moved_colliders);
+            for (auto const& model : m_moved_models)
+                model->update_bounds();
+            for (auto const& collider : m_moved_colliders)
+                collider->update_bounds();
+        }
+        m_moved_models.clear();
+        m_moved_colliders.clear();
+
+        m_bounding_volumes.poll_rebuild();
+        if (m_bounding_volumes.degraded()) {
+            if (m_background_bvh_rebuild)
+                m_bounding_volumes.rebuild_async();
+            else
+                m_bounding_volumes.rebuild();
+        }
+    }
+
     void Scene::serialize(serializer::Adapter& adapter)
     {
         Entity::serialize(adapter);
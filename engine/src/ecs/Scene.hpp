@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/Base.hpp"
+#include "ecs/BoundingVolumeHierarchy.hpp"
 #include "ecs/Entity.hpp"
 #include "physics/Forward.hpp"
 #include "render/Forward.hpp"
@@ -15,10 +16,35 @@ namespace Birdy3d::ecs {
         Scene(std::string name = "Scene");
         void start() override;
         void update() override;
+        /**
+         * @brief Runs the update of all components, without the simulation.
+         */
+        void update_components();
+        /**
+         * @brief Updates the transforms and the physics. Doesn't call any component updates, so it can run on a worker.
+         */
+        void simulate();
         void serialize(serializer::Adapter&) override;
 
+        /**
+         * @brief Bounds of all models and colliders of the scene for spatial queries.
+         */
+        [[nodiscard]] BoundingVolumeHierarchy& bounding_volumes() { return m_bounding_volumes; }
+        [[nodiscard]] BoundingVolumeHierarchy const& bounding_volumes() const { return m_bounding_volumes; }
+        /**
+         * @brief Updates the bounds of the components of entities whose global matrix changed and rebuilds the
+         * hierarchy if it degraded.
+         */
+        void refit_bounds(std::vector<Entity*> const& moved);
+
     private:
         std::unique_ptr<physics::PhysicsWorld> m_physics_world;
+        BoundingVolumeHierarchy m_bounding_volumes;
+        // Reused by refit_bounds
+        std::vector<std::shared_ptr<render::ModelComponent>> m_moved_models;
+        std::vector<std::shared_ptr<physics::ColliderComponent>> m_moved_colliders;
+        // BoolOption::BACKGROUND_BVH_REBUILD as of the last update_components()
+        bool m_background_bvh_rebuild = false;
 
         BIRDY3D_REGISTER_TYPE_DEC(Scene);
     };
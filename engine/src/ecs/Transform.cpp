@@ -1,7 +1,9 @@
 #include "ecs/Transform.hpp"
 
 #include "core/Application.hpp"
+#include "core/JobSystem.hpp"
 #include "ecs/Entity.hpp"
+#include "ecs/Scene.hpp"
 #include "events/EventBus.hpp"
 #include "events/TransformChangedEvent.hpp"
 #include <glm/gtc/matrix_transform.hpp>
@@ -20,6 +22,17 @@ namespace Birdy3d::ecs {
     { }
 
     void Transform3d::update(bool changed)
+    {
+        // Events are emitted afterwards, because the subtrees are updated on multiple threads.
+        Changes changes;
+        update_matrices(changed, changes);
+        for (auto entity : changes.changed)
+            core::Application::event_bus->emit<events::TransformChangedEvent>(entity);
+        if (m_entity->scene && !changes.moved.empty())
+            m_entity->scene->refit_bounds(changes.moved);
+    }
+
+    void Transform3d::update_matrices(bool changed, Changes& changes)
     {
         if (position != m_old_position || orientation != m_old_orientation || scale != m_old_scale) {
             changed = true;
@@ -34,8 +47,7 @@ namespace Birdy3d::ecs {
             m_local_matrix = glm::rotate(m_local_matrix, this->orientation.y, glm::vec3(0, 1, 0));
             m_local_matrix = glm::rotate(m_local_matrix, this->orientation.z, glm::vec3(0, 0, 1));
             m_local_matrix = glm::scale(m_local_matrix, this->scale);
-            // Send event
-            core::Application::event_bus->emit<events::TransformChangedEvent>(m_entity);
+            changes.changed.push_back(m_entity);
         }
         if (changed) {
             // Update matrix
@@ -44,9 +56,23 @@ namespace Birdy3d::ecs {
             else
                 m_global_matrix = m_local_matrix;
             m_inverse_global_matrix = {};
+            changes.moved.push_back(m_entity);
+        }
+        auto const& children = m_entity->children();
+        if (children.size() < PARALLEL_CHILDREN) {
+            for (auto const& child_entity : children)
+                child_entity->transform.update_matrices(changed, changes);
+            return;
+        }
+
+        std::vector<Changes> child_changes(children.size());
+        core::JobSystem::parallel_for(children.size(), [&](std::size_t i) {
+            children[i]->transform.update_matrices(changed, child_changes[i]);
+        });
+        for (auto const& child_change : child_changes) {
+            changes.changed.insert(changes.changed.end(), child_change.changed.begin(), child_change.changed.end());
+            changes.moved.insert(changes.moved.end(), child_change.moved.begin(), child_change.moved.end());
         }
-        for (auto child_entity : m_entity->children())
-            child_entity->transform.update(changed);
     }
 
     glm::mat4 Transform3d::global_matrix() const
@@ -27,15 +27,27 @@ namespace Birdy3d::ecs {
         void serialize(serializer::Adapter&);
 
     private:
+        // Minimum amount of children to update them in parallel
+        static std::size_t constexpr PARALLEL_CHILDREN = 16;
+
         glm::mat4 m_global_matrix;
         glm::mat4 m_local_matrix;
         mutable std::optional<glm::mat4> m_inverse_global_matrix;
         Entity* m_entity = nullptr;
 
+        struct Changes {
+            // Entities whose own transform changed, they get a TransformChangedEvent
+            std::vector<Entity*> changed;
+            // Entities whose global matrix changed, including the descendants of changed entities
+            std::vector<Entity*> moved;
+        };
+
         // Copies for change detection
         glm::vec3 m_old_position = glm::vec3(0);
         glm::vec3 m_old_orientation = glm::vec3(0);
         glm::vec3 m_old_scale = glm::vec3(0);
+
+        void update_matrices(bool changed, Changes& changes);
     };
 
 }
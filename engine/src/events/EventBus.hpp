@@ -7,6 +7,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <typeindex>
@@ -83,13 +84,16 @@ namespace Birdy3d::events {
         template <typename EventType, typename... Args>
         void emit(Args... args)
         {
-            m_event_queue.push(std::make_unique<EventType>(args...));
+            auto event = std::make_unique<EventType>(args...);
+            std::lock_guard<std::mutex> lock{m_event_queue_mutex};
+            m_event_queue.push(std::move(event));
         }
 
         void flush(int amount = -1)
         {
-            for (int i = 0; (amount <= -1 || i < amount) && !m_event_queue.empty(); i++) {
-                exec_first();
+            for (int i = 0; amount <= -1 || i < amount; i++) {
+                if (!exec_first())
+                    break;
             }
         }
 
@@ -164,24 +168,31 @@ namespace Birdy3d::events {
     private:
         std::map<std::type_index, std::unique_ptr<HandlerList>> m_subscribers;
         std::queue<std::unique_ptr<Event>> m_event_queue;
+        // Events may be emitted from jobs, e.g. by the physics simulation.
+        std::mutex m_event_queue_mutex;
 
-        void exec_first()
+        bool exec_first()
         {
-            if (m_event_queue.empty())
-                return;
-            Event* event = m_event_queue.front().get();
+            std::unique_ptr<Event> event;
+            {
+                std::lock_guard<std::mutex> lock{m_event_queue_mutex};
+                if (m_event_queue.empty())
+                    return false;
+                event = std::move(m_event_queue.front());
+                m_event_queue.pop();
+            }
             HandlerList* handlers = m_subscribers[typeid(*event)].get();
 
             if (handlers == nullptr) {
-                return;
+                return true;
             }
 
             for (auto& handler : *handlers) {
                 if (handler != nullptr) {
-                    handler->exec(event);
+                    handler->exec(event.get());
                 }
             }
-            m_event_queue.pop();
+            return true;
         }
 
         bool any_equals(std::any a, std::any b)
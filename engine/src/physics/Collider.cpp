@@ -7,22 +7,199 @@
 #include "physics/CollisionSphere.hpp"
 #include "render/Mesh.hpp"
 #include "render/Shader.hpp"
+#include <limits>
 
 namespace Birdy3d::physics {
 
+    namespace {
+
+        namespace uniforms {
+            render::UniformHandle const model{"model"};
+        }
+
+        glm::vec3 support(CollisionShape const& mesh_a, CollisionShape const& mesh_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b, glm::vec3 direction)
+        {
+            glm::vec3 local_direction_a = transform_a.global_to_local(direction) - transform_a.global_to_local(glm::vec3(0.0f));
+            glm::vec3 local_direction_b = transform_b.global_to_local(direction) - transform_b.global_to_local(glm::vec3(0.0f));
+
+            glm::vec3 local_furthest_a = mesh_a.find_furthest_point(local_direction_a);
+            glm::vec3 local_furthest_b = mesh_b.find_furthest_point(-local_direction_b);
+
+            glm::vec3 world_furthest_a = transform_a.local_to_global(local_furthest_a);
+            glm::vec3 world_furthest_b = transform_b.local_to_global(local_furthest_b);
+
+            return world_furthest_a - world_furthest_b;
+        }
+
+        bool same_direction(glm::vec3 a, glm::vec3 b)
+        {
+            return glm::dot(a, b) > 0;
+        }
+
+        struct Simplex {
+            glm::vec3 points[4];
+            int point_count = 0;
+
+            void push_front(glm::vec3 point)
+            {
+                if (point_count >= 4 || point_count < 0)
+                    core::Logger::critical("Simplex has a maximum size of 4");
+
+                for (int i = point_count; i > 0; i--) {
+                    points[i] = points[i - 1];
+                }
+
+                points[0] = point;
+                point_count++;
+            }
+
+            bool next(glm::vec3& direction)
+            {
+                switch (point_count) {
+                case 2:
+                    return line(direction);
+                case 3:
+                    return triangle(direction);
+                case 4:
+                    return tetrahedron(direction);
+                }
+
+                return false;
+            }
+
+            bool line(glm::vec3& direction)
+            {
+                glm::vec3 a = points[0];
+                glm::vec3 b = points[1];
+
+                glm::vec3 ab = b - a;
+                glm::vec3 ao = -a;
+
+                if (same_direction(ab, ao)) {
+                    direction = glm::cross(glm::cross(ab, ao), ab);
+                } else {
+                    point_count--;
+                    direction = ao;
+                }
+
+                return false;
+            }
+
+            bool triangle(glm::vec3& direction)
+            {
+                glm::vec3 a = points[0];
+                glm::vec3 b = points[1];
+                glm::vec3 c = points[2];
+
+                glm::vec3 ab = b - a;
+                glm::vec3 ac = c - a;
+                glm::vec3 ao = -a;
+
+                glm::vec3 abc = glm::cross(ab, ac);
+
+                if (same_direction(glm::cross(abc, ac), ao)) {
+                    if (same_direction(ac, ao)) {
+                        points[1] = c;
+                        point_count--;
+                        direction = glm::cross(glm::cross(ac, ao), ac);
+                    } else {
+                        point_count--;
+                        return line(direction);
+                    }
+                } else {
+                    if (same_direction(glm::cross(ab, abc), ao)) {
+                        point_count--;
+                        return line(direction);
+                    } else {
+                        // Origin is inside of triangle
+                        if (same_direction(abc, ao)) {
+                            direction = abc;
+                        } else {
+                            points[1] = c;
+                            points[2] = b;
+                            direction = -abc;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            bool tetrahedron(glm::vec3& direction)
+            {
+                glm::vec3 a = points[0];
+                glm::vec3 b = points[1];
+                glm::vec3 c = points[2];
+                glm::vec3 d = points[3];
+
+                glm::vec3 ab = b - a;
+                glm::vec3 ac = c - a;
+                glm::vec3 ad = d - a;
+                glm::vec3 ao = -a;
+
+                glm::vec3 abc = glm::cross(ab, ac);
+                glm::vec3 acd = glm::cross(ac, ad);
+                glm::vec3 adb = glm::cross(ad, ab);
+
+                if (same_direction(abc, ao)) {
+                    point_count--;
+                    return triangle(direction);
+                }
+
+                if (same_direction(acd, ao)) {
+                    points[1] = c;
+                    points[2] = d;
+                    point_count--;
+                    return triangle(direction);
+                }
+
+                if (same_direction(adb, ao)) {
+                    points[1] = d;
+                    points[2] = b;
+                    point_count--;
+                    return triangle(direction);
+                }
+
+                return true;
+            }
+        };
+
+    }
+
     Collider::Collider()
         : m_generation_mode(GenerationMode::NONE)
     { }
 
     Collider::Collider(std::vector<std::unique_ptr<CollisionShape>> shapes)
         : m_collision_shapes(std::move(shapes))
-    { }
+    {
+        if (m_collision_shapes.empty())
+            return;
+        // The furthest points along the axes span the box of a convex shape.
+        glm::vec3 low(std::numeric_limits<float>::infinity());
+        glm::vec3 high(-std::numeric_limits<float>::infinity());
+        for (auto const& shape : m_collision_shapes) {
+            for (int axis = 0; axis < 3; ++axis) {
+                glm::vec3 direction(0);
+                direction[axis] = 1;
+                high[axis] = std::max(high[axis], shape->find_furthest_point(direction)[axis]);
+                low[axis] = std::min(low[axis], shape->find_furthest_point(-direction)[axis]);
+            }
+        }
+        m_bounding_box = {low, high};
+    }
 
-    void Collider::render_wireframe(ecs::Entity const& entity, render::Shader const& shader) const
+    std::size_t Collider::memory_size() const
+    {
+        std::size_t size = sizeof(Collider);
+        for (auto const& shape : m_collision_shapes)
+            size += shape->memory_size();
+        return size;
+    }
+
+    void Collider::render_wireframe(glm::mat4 const& model, render::Shader const& shader) const
     {
-        glm::mat4 model = entity.transform.global_matrix();
         shader.use();
-        shader.set_mat4("model", model);
+        shader.set_mat4(uniforms::model, model);
         for (auto const& collision_shape : m_collision_shapes) {
             auto render_mesh = collision_shape->get_render_mesh();
             if (render_mesh)
@@ -52,32 +229,32 @@ namespace Birdy3d::physics {
         return {};
     }
 
-    std::optional<CollisionPoints> Collider::compute_shape_collision_gjk(CollisionShape const& shape_a, CollisionShape const& shape_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b) const
+    std::optional<CollisionPoints> Collider::compute_shape_collision_gjk(CollisionShape const& shape_a, CollisionShape const& shape_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b)
     {
         // FIXME: stop if one of the matrices scales to 0
-        m_point_count = 0;
+        Simplex simplex;
         glm::vec3 s = support(shape_a, shape_b, transform_a, transform_b, glm::vec3(1.0f, 0.0f, 0.0f));
-        push_front(s);
+        simplex.push_front(s);
         glm::vec3 direction = -s;
 
         while (true) {
             if (direction == glm::vec3(0))
-                core::Logger::critical("direction ist 0 in loop. point_count: {}", m_point_count);
+                core::Logger::critical("direction ist 0 in loop. point_count: {}", simplex.point_count);
             s = support(shape_a, shape_b, transform_a, transform_b, direction);
 
             if (glm::dot(s, direction) <= 0)
                 return {};
 
-            if (m_points[0] == s)
-                core::Logger::critical("points are the same collides 1 nr: {}", m_point_count);
-            push_front(s);
+            if (simplex.points[0] == s)
+                core::Logger::critical("points are the same collides 1 nr: {}", simplex.point_count);
+            simplex.push_front(s);
 
-            if (next_simplex(direction))
+            if (simplex.next(direction))
                 return CollisionPoints{};
         }
     }
 
-    std::optional<CollisionPoints> Collider::compute_shape_collision_spheres(CollisionSphere const& shape_a, CollisionSphere const& shape_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b) const
+    std::optional<CollisionPoints> Collider::compute_shape_collision_spheres(CollisionSphere const& shape_a, CollisionSphere const& shape_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b)
     {
         auto shape_a_center = transform_a.world_position();
         auto shape_b_center = transform_b.world_position();
@@ -102,145 +279,4 @@ namespace Birdy3d::physics {
             .depth = radius_sum - center_distance};
     }
 
-    glm::vec3 Collider::support(CollisionShape const& mesh_a, CollisionShape const& mesh_b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b, glm::vec3 direction) const
-    {
-        glm::vec3 local_direction_a = transform_a.global_to_local(direction) - transform_a.global_to_local(glm::vec3(0.0f));
-        glm::vec3 local_direction_b = transform_b.global_to_local(direction) - transform_b.global_to_local(glm::vec3(0.0f));
-
-        glm::vec3 local_furthest_a = mesh_a.find_furthest_point(local_direction_a);
-        glm::vec3 local_furthest_b = mesh_b.find_furthest_point(-local_direction_b);
-
-        glm::vec3 world_furthest_a = transform_a.local_to_global(local_furthest_a);
-        glm::vec3 world_furthest_b = transform_b.local_to_global(local_furthest_b);
-
-        return world_furthest_a - world_furthest_b;
-    }
-
-    void Collider::push_front(glm::vec3 point) const
-    {
-        if (m_point_count >= 4 || m_point_count < 0)
-            core::Logger::critical("Simplex has a maximum size of 4");
-
-        for (int i = m_point_count; i > 0; i--) {
-            m_points[i] = m_points[i - 1];
-        }
-
-        m_points[0] = point;
-        m_point_count++;
-    }
-
-    bool Collider::next_simplex(glm::vec3& direction) const
-    {
-        switch (m_point_count) {
-        case 2:
-            return line(direction);
-        case 3:
-            return triangle(direction);
-        case 4:
-            return tetrahedron(direction);
-        }
-
-        return false;
-    }
-
-    bool Collider::line(glm::vec3& direction) const
-    {
-        glm::vec3 a = m_points[0];
-        glm::vec3 b = m_points[1];
-
-        glm::vec3 ab = b - a;
-        glm::vec3 ao = -a;
-
-        if (same_direction(ab, ao)) {
-            direction = glm::cross(glm::cross(ab, ao), ab);
-        } else {
-            m_point_count--;
-            direction = ao;
-        }
-
-        return false;
-    }
-
-    bool Collider::triangle(glm::vec3& direction) const
-    {
-        glm::vec3 a = m_points[0];
-        glm::vec3 b = m_points[1];
-        glm::vec3 c = m_points[2];
-
-        glm::vec3 ab = b - a;
-        glm::vec3 ac = c - a;
-        glm::vec3 ao = -a;
-
-        glm::vec3 abc = glm::cross(ab, ac);
-
-        if (same_direction(glm::cross(abc, ac), ao)) {
-            if (same_direction(ac, ao)) {
-                m_points[1] = c;
-                m_point_count--;
-                direction = glm::cross(glm::cross(ac, ao), ac);
-            } else {
-                m_point_count--;
-                return line(direction);
-            }
-        } else {
-            if (same_direction(glm::cross(ab, abc), ao)) {
-                m_point_count--;
-                return line(direction);
-            } else {
-                // Origin is inside of triangle
-                if (same_direction(abc, ao)) {
-                    direction = abc;
-                } else {
-                    m_points[1] = c;
-                    m_points[2] = b;
-                    direction = -abc;
-                }
-            }
-        }
-        return false;
-    }
-
-    bool Collider::tetrahedron(glm::vec3& direction) const
-    {
-        glm::vec3 a = m_points[0];
-        glm::vec3 b = m_points[1];
-        glm::vec3 c = m_points[2];
-        glm::vec3 d = m_points[3];
-
-        glm::vec3 ab = b - a;
-        glm::vec3 ac = c - a;
-        glm::vec3 ad = d - a;
-        glm::vec3 ao = -a;
-
-        glm::vec3 abc = glm::cross(ab, ac);
-        glm::vec3 acd = glm::cross(ac, ad);
-        glm::vec3 adb = glm::cross(ad, ab);
-
-        if (same_direction(abc, ao)) {
-            m_point_count--;
-            return triangle(direction);
-        }
-
-        if (same_direction(acd, ao)) {
-            m_points[1] = c;
-            m_points[2] = d;
-            m_point_count--;
-            return triangle(direction);
-        }
-
-        if (same_direction(adb, ao)) {
-            m_points[1] = d;
-            m_points[2] = b;
-            m_point_count--;
-            return triangle(direction);
-        }
-
-        return true;
-    }
-
-    bool Collider::same_direction(glm::vec3 a, glm::vec3 b) const
-    {
-        return glm::dot(a, b) > 0;
-    }
-
 }
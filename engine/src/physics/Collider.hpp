@@ -16,25 +16,21 @@ namespace Birdy3d::physics {
         Collider();
         Collider(std::vector<std::unique_ptr<CollisionShape>>);
         std::optional<CollisionPoints> compute_collision(Collider const& collider_a, Collider const& collider_b, ecs::Transform3d const&, ecs::Transform3d const&) const;
-        void render_wireframe(ecs::Entity const&, render::Shader const&) const;
+        void render_wireframe(glm::mat4 const& model, render::Shader const&) const;
+        /// @returns approximate size of the collision shapes in main memory in bytes
+        [[nodiscard]] std::size_t memory_size() const;
+        /// @returns lowest and highest corner of the box around all shapes in local space
+        [[nodiscard]] std::pair<glm::vec3, glm::vec3> bounding_box() const { return m_bounding_box; }
 
     private:
         std::string m_model_name;
         std::vector<std::unique_ptr<CollisionShape>> m_collision_shapes;
+        std::pair<glm::vec3, glm::vec3> m_bounding_box{glm::vec3(0), glm::vec3(0)};
         GenerationMode mutable m_generation_mode;
-        glm::vec3 mutable m_points[4];
-        int mutable m_point_count;
 
-        [[nodiscard]] std::optional<CollisionPoints> compute_shape_collision_gjk(CollisionShape const&, CollisionShape const&, ecs::Transform3d const&, ecs::Transform3d const&) const;
-        [[nodiscard]] std::optional<CollisionPoints> compute_shape_collision_spheres(CollisionSphere const&, CollisionSphere const&, ecs::Transform3d const&, ecs::Transform3d const&) const;
-        // FIXME: Move GJK stuff to separate class where it doesn't need to be const
-        glm::vec3 support(CollisionShape const& a, CollisionShape const& b, ecs::Transform3d const& transform_a, ecs::Transform3d const& transform_b, glm::vec3 direction) const;
-        bool line(glm::vec3& direction) const;
-        bool triangle(glm::vec3& direction) const;
-        bool tetrahedron(glm::vec3& direction) const;
-        bool same_direction(glm::vec3 a, glm::vec3 b) const;
-        void push_front(glm::vec3 point) const;
-        bool next_simplex(glm::vec3& direction) const;
+        // The simplex of GJK is local to each call, so that pairs which share a collider can be tested in parallel.
+        [[nodiscard]] static std::optional<CollisionPoints> compute_shape_collision_gjk(CollisionShape const&, CollisionShape const&, ecs::Transform3d const&, ecs::Transform3d const&);
+        [[nodiscard]] static std::optional<CollisionPoints> compute_shape_collision_spheres(CollisionSphere const&, CollisionSphere const&, ecs::Transform3d const&, ecs::Transform3d const&);
     };
 
 }
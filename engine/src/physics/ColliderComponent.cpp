@@ -1,6 +1,7 @@
 #include "physics/ColliderComponent.hpp"
 
 #include "ecs/Entity.hpp"
+#include "ecs/Scene.hpp"
 #include "events/ResourceEvents.hpp"
 #include "render/ModelComponent.hpp"
 
@@ -16,16 +17,46 @@ namespace Birdy3d::physics {
     {
         core::Application::event_bus->subscribe(this, &ColliderComponent::on_resource_loaded);
         reload_collider();
+        if (entity->scene)
+            m_bounds_proxy = entity->scene->bounding_volumes().insert(this, ecs::BoundsLayer::COLLIDERS, world_bounding_box());
+    }
+
+    void ColliderComponent::update()
+    {
+        // Switching to a reloaded collider may destroy the old one with its render meshes, so it only happens here on
+        // the main thread.
+        auto previous = m_collider.peek();
+        if (m_collider.ptr() != previous)
+            update_bounds();
     }
 
     void ColliderComponent::cleanup()
     {
         core::Application::event_bus->unsubscribe(this, &ColliderComponent::on_resource_loaded);
+        if (m_bounds_proxy && entity->scene)
+            entity->scene->bounding_volumes().remove(*m_bounds_proxy);
+        m_bounds_proxy.reset();
     }
 
     void ColliderComponent::on_resource_loaded(events::ResourceLoadEvent const&)
     {
         reload_collider();
+        update_bounds();
+    }
+
+    render::BoundingBox ColliderComponent::world_bounding_box() const
+    {
+        auto matrix = entity->transform.global_matrix();
+        auto collider = m_collider.peek();
+        if (!collider)
+            return {glm::vec3(matrix[3]), glm::vec3(0)};
+        return render::BoundingBox::transformed(collider->bounding_box(), matrix);
+    }
+
+    void ColliderComponent::update_bounds()
+    {
+        if (m_bounds_proxy && entity->scene)
+            entity->scene->bounding_volumes().move(*m_bounds_proxy, world_bounding_box());
     }
 
     void ColliderComponent::reload_collider()
@@ -36,8 +67,9 @@ namespace Birdy3d::physics {
             return;
         }
 
+        // The collider is generated once the model finished loading.
         auto model = model_component->model();
-        if (!model) {
+        if (!model && !model.loading()) {
             core::Logger::warn("Entity '{}' doesn't have any model", entity->name);
             return;
         }
@@ -45,22 +77,22 @@ namespace Birdy3d::physics {
         auto collider_id = model.id();
         switch (m_generation_mode) {
         case GenerationMode::NONE:
-            collider_id.args["generation_mode"] = "NONE";
+            collider_id.arg("generation_mode", "NONE");
             break;
         case GenerationMode::COPY:
-            collider_id.args["generation_mode"] = "COPY";
+            collider_id.arg("generation_mode", "COPY");
             break;
         case GenerationMode::HULL_MODEL:
-            collider_id.args["generation_mode"] = "HULL_MODEL";
+            collider_id.arg("generation_mode", "HULL_MODEL");
             break;
         case GenerationMode::HULL_MESHES:
-            collider_id.args["generation_mode"] = "HULL_MESHES";
+            collider_id.arg("generation_mode", "HULL_MESHES");
             break;
         case GenerationMode::DECOMPOSITION_MODEL:
-            collider_id.args["generation_mode"] = "DECOMPOSITION_MODEL";
+            collider_id.arg("generation_mode", "DECOMPOSITION_MODEL");
             break;
         case GenerationMode::DECOMPOSITION_MESHES:
-            collider_id.args["generation_mode"] = "DECOMPOSITION_MESHES";
+            collider_id.arg("generation_mode", "DECOMPOSITION_MESHES");
             break;
         }
 
@@ -70,11 +102,11 @@ namespace Birdy3d::physics {
         m_collider = core::ResourceManager::get_collider(collider_id);
     }
 
-    void ColliderComponent::render_wireframe(render::Shader const& shader) const
+    void ColliderComponent::render_wireframe(glm::mat4 const& model, render::Shader const& shader) const
     {
         if (!m_collider)
             return;
-        m_collider->render_wireframe(*entity, shader);
+        m_collider->render_wireframe(model, shader);
     }
 
     void ColliderComponent::serialize(serializer::Adapter& adapter)
@@ -3,7 +3,9 @@
 #include "ecs/Component.hpp"
 
 #include "core/ResourceHandle.hpp"
+#include "ecs/BoundingVolumeHierarchy.hpp"
 #include "physics/Collider.hpp"
+#include <optional>
 
 namespace Birdy3d::physics {
 
@@ -13,16 +15,31 @@ namespace Birdy3d::physics {
         ColliderComponent(GenerationMode);
 
         void start() override;
+        void update() override;
         void cleanup() override;
         void serialize(serializer::Adapter&) override;
         int priority() override { return 10; }
-        void render_wireframe(render::Shader const&) const;
-
-        [[nodiscard]] Collider const* collider() const { return m_collider.ptr(); }
+        void render_wireframe(glm::mat4 const& model, render::Shader const&) const;
+
+        /**
+         * @brief Used by the physics, which may run on the simulation worker. Doesn't switch to a reloaded collider,
+         * update() does that on the main thread.
+         */
+        [[nodiscard]] Collider const* collider() const { return m_collider.peek(); }
+        /**
+         * @returns the box around the collider in world space or an empty box at the origin of the entity if the
+         * collider isn't loaded
+         */
+        [[nodiscard]] render::BoundingBox world_bounding_box() const;
+        /**
+         * @brief Moves the bounds in the BoundingVolumeHierarchy of the scene to the current transform and collider.
+         */
+        void update_bounds();
 
     private:
         GenerationMode m_generation_mode = GenerationMode::NONE;
         core::ResourceHandle<Collider> m_collider;
+        std::optional<ecs::BoundingVolumeHierarchy::ProxyId> m_bounds_proxy;
 
         void on_resource_loaded(events::ResourceLoadEvent const& event);
         void reload_collider();
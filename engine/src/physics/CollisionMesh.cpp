@@ -38,4 +38,12 @@ namespace Birdy3d::physics {
         return &m_render_mesh.value();
     }
 
+    std::size_t CollisionMesh::memory_size() const
+    {
+        return sizeof(CollisionMesh)
+            + m_vertices.size() * sizeof(glm::vec3)
+            + m_mesh.vertices.size() * sizeof(decltype(m_mesh.vertices)::value_type)
+            + m_mesh.indices.size() * sizeof(decltype(m_mesh.indices)::value_type);
+    }
+
 }
@@ -16,6 +16,8 @@ namespace Birdy3d::physics {
 
         [[nodiscard]] virtual render::Mesh const* get_render_mesh() const override;
 
+        [[nodiscard]] virtual std::size_t memory_size() const override;
+
     private:
         std::vector<glm::vec3> m_vertices;
         Mesh const m_mesh;
@@ -14,6 +14,8 @@ namespace Birdy3d::physics {
         virtual ~CollisionShape() = default;
         [[nodiscard]] virtual glm::vec3 find_furthest_point(const glm::vec3 direction) const = 0;
         [[nodiscard]] virtual render::Mesh const* get_render_mesh() const = 0;
+        /// @returns approximate size of the shape in main memory in bytes
+        [[nodiscard]] virtual std::size_t memory_size() const = 0;
     };
 
 }
@@ -24,4 +24,9 @@ namespace Birdy3d::physics {
         return &m_render_model->get_meshes()[0];
     }
 
+    std::size_t CollisionSphere::memory_size() const
+    {
+        return sizeof(CollisionSphere);
+    }
+
 }
@@ -14,6 +14,8 @@ namespace Birdy3d::physics {
 
         [[nodiscard]] virtual render::Mesh const* get_render_mesh() const override;
 
+        [[nodiscard]] virtual std::size_t memory_size() const override;
+
     private:
         float m_radius;
         std::unique_ptr<render::Model> mutable m_render_model;
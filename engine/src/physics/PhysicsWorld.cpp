@@ -1,33 +1,43 @@
 #include "physics/PhysicsWorld.hpp"
 
 #include "core/Application.hpp"
-#include "ecs/Entity.hpp"
+#include "core/JobSystem.hpp"
+#include "ecs/Scene.hpp"
 #include "events/CollisionEvent.hpp"
 #include "events/EventBus.hpp"
 #include "physics/ColliderComponent.hpp"
 #include "physics/Collision.hpp"
+#include <unordered_set>
 
 namespace Birdy3d::physics {
 
-    PhysicsWorld::PhysicsWorld(ecs::Entity* scene)
+    PhysicsWorld::PhysicsWorld(ecs::Scene* scene)
         : m_scene(scene)
     { }
 
     PhysicsWorld::~PhysicsWorld() { }
 
-    void for_each_combination_of(std::vector<std::shared_ptr<ColliderComponent>> const& items, auto callback)
-    {
-        for (auto i = items.cbegin(); i != items.cend(); ++i) {
-            for (auto j = i + 1; j != items.cend(); ++j) {
-                callback(*i->get(), *j->get());
-            }
-        }
-    }
-
     void PhysicsWorld::update()
     {
+        struct Pair {
+            ColliderComponent const* component_1;
+            ColliderComponent const* component_2;
+            Collider const* collider_1;
+            Collider const* collider_2;
+            std::size_t collision_index;
+            std::optional<CollisionPoints> points;
+        };
+
+        // The collision state of every pair is looked up first, so that the collision tests can run in parallel.
         auto collider_components = m_scene->get_components<ColliderComponent>(false, true);
-        for_each_combination_of(collider_components, [&](ColliderComponent const& collider_component_1, ColliderComponent const& collider_component_2) {
+        // Colliders of hidden entities are in the bounding volume hierarchy as well, but don't collide.
+        std::unordered_set<ColliderComponent const*> active_components;
+        for (auto const& collider_component : collider_components)
+            active_components.insert(collider_component.get());
+        std::vector<Pair> pairs;
+        // Indexed like m_collisions, prevents testing a pair twice
+        std::vector<bool> tested;
+        auto add_pair = [&](ColliderComponent const& collider_component_1, ColliderComponent const& collider_component_2) {
             auto collider_1 = collider_component_1.collider();
             auto collider_2 = collider_component_2.collider();
 
@@ -38,28 +48,62 @@ namespace Birdy3d::physics {
                 return collision.contains(collider_component_1) && collision.contains(collider_component_2);
             });
 
-            Collision* collision = {};
-
+            std::size_t collision_index;
             if (collision_iterator != m_collisions.end()) {
-                collision = &*collision_iterator;
+                collision_index = collision_iterator - m_collisions.begin();
             } else {
-                collision = &m_collisions.emplace_back(collider_component_1, collider_component_2);
+                collision_index = m_collisions.size();
+                m_collisions.emplace_back(collider_component_1, collider_component_2);
             }
 
-            bool collided_last_frame = collision->points.has_value();
-            auto optional_points = collider_1->compute_collision(*collider_1, *collider_2, collider_component_1.entity->transform, collider_component_2.entity->transform);
-            collision->points = optional_points;
-            if (optional_points.has_value()) {
+            tested.resize(m_collisions.size());
+            if (tested[collision_index])
+                return;
+            tested[collision_index] = true;
+            pairs.push_back({&collider_component_1, &collider_component_2, collider_1, collider_2, collision_index, {}});
+        };
+
+        // Broad phase: only colliders whose bounding boxes overlap can collide.
+        auto const& bounding_volumes = m_scene->bounding_volumes();
+        for (auto const& collider_component : collider_components) {
+            bounding_volumes.query(collider_component->world_bounding_box(), ecs::BoundsLayer::COLLIDERS, [&](ecs::Component* other) {
+                auto other_component = static_cast<ColliderComponent const*>(other);
+                if (other_component != collider_component.get() && active_components.contains(other_component))
+                    add_pair(*collider_component, *other_component);
+            });
+        }
+        // Pairs that collided in the last frame are tested again, so that they get their EXIT event.
+        for (std::size_t i = 0; i < m_collisions.size(); ++i) {
+            auto const& component_a = m_collisions[i].collider_component_a;
+            auto const& component_b = m_collisions[i].collider_component_b;
+            if (m_collisions[i].points && (i >= tested.size() || !tested[i]) && active_components.contains(&component_a) && active_components.contains(&component_b))
+                add_pair(component_a, component_b);
+        }
+
+        // The inverse matrices are computed lazily, which must not happen on multiple threads at once.
+        for (auto const& collider_component : collider_components)
+            (void)collider_component->entity->transform.inverse_global_matrix();
+
+        core::JobSystem::parallel_for(pairs.size(), [&](std::size_t i) {
+            auto& pair = pairs[i];
+            pair.points = pair.collider_1->compute_collision(*pair.collider_1, *pair.collider_2, pair.component_1->entity->transform, pair.component_2->entity->transform);
+        });
+
+        for (auto& pair : pairs) {
+            auto& collision = m_collisions[pair.collision_index];
+            bool collided_last_frame = collision.points.has_value();
+            collision.points = pair.points;
+            if (pair.points.has_value()) {
                 if (collided_last_frame)
-                    core::Application::event_bus->emit<events::CollisionEvent>(collider_1, collider_2, events::CollisionEvent::COLLIDING);
+                    core::Application::event_bus->emit<events::CollisionEvent>(pair.collider_1, pair.collider_2, events::CollisionEvent::COLLIDING);
                 else
-                    core::Application::event_bus->emit<events::CollisionEvent>(collider_1, collider_2, events::CollisionEvent::ENTER);
+                    core::Application::event_bus->emit<events::CollisionEvent>(pair.collider_1, pair.collider_2, events::CollisionEvent::ENTER);
             } else {
                 if (collided_last_frame) {
-                    core::Application::event_bus->emit<events::CollisionEvent>(collider_1, collider_2, events::CollisionEvent::EXIT);
+                    core::Application::event_bus->emit<events::CollisionEvent>(pair.collider_1, pair.collider_2, events::CollisionEvent::EXIT);
                 }
             }
-        });
+        }
     }
 
 }
@@ -9,12 +9,12 @@ namespace Birdy3d::physics {
 
     class PhysicsWorld {
     public:
-        PhysicsWorld(ecs::Entity* scene);
+        PhysicsWorld(ecs::Scene* scene);
         ~PhysicsWorld();
         void update();
 
     private:
-        ecs::Entity* m_scene;
+        ecs::Scene* m_scene;
         std::vector<Collision> m_collisions;
     };
 
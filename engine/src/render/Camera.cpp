@@ -7,19 +7,42 @@
 #include "ecs/Scene.hpp"
 #include "physics/ColliderComponent.hpp"
 #include "render/DirectionalLight.hpp"
+#include "render/Material.hpp"
+#include "render/MaterialTable.hpp"
+#include "render/Model.hpp"
 #include "render/ModelComponent.hpp"
 #include "render/PointLight.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
+#include "render/ShaderData.hpp"
 #include "render/Spotlight.hpp"
 #include "ui/Theme.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <map>
 #include <random>
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        namespace uniforms {
+            UniformHandle const color{"color"};
+            UniformHandle const gbuffer_albedo_spec{"gbuffer_albedo_spec"};
+            UniformHandle const gbuffer_normal{"gbuffer_normal"};
+            UniformHandle const gbuffer_position{"gbuffer_position"};
+            UniformHandle const model{"model"};
+            UniformHandle const ssao{"ssao"};
+            UniformArray samples{"samples"};
+        }
+
+        SnapshotTransform snapshot_transform(ecs::Entity& entity)
+        {
+            return {entity.transform.global_matrix(), entity.transform.world_position(), entity.world_forward(), entity.world_up()};
+        }
+
+    }
+
     Camera::Camera()
         : deferred_enabled(false)
         , target(Rendertarget::DEFAULT)
@@ -82,8 +105,8 @@ namespace Birdy3d::render {
             glm::vec3 noise(random_floats(generator) * 2.0 - 1.0, random_floats(generator) * 2.0 - 1.0, 0.0f); // rotate around z-axis (in tangent space)
             ssao_noise[i] = glm::normalize(noise);
         }
-        glGenTextures(1, &m_ssao_noise);
-        glBindTexture(GL_TEXTURE_2D, m_ssao_noise);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_ssao_noise);
+        RenderState::bind_texture(0, m_ssao_noise);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 4, 4, 0, GL_RGB, GL_FLOAT, &ssao_noise[0]);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -94,13 +117,57 @@ namespace Birdy3d::render {
     void Camera::cleanup()
     {
         if (m_outline_vao != 0) {
-            glDeleteVertexArrays(1, &m_outline_vao);
+            RenderState::delete_vertex_array(m_outline_vao);
             glDeleteBuffers(1, &m_outline_vbo);
             m_outline_vao = 0;
             m_outline_vbo = 0;
         }
     }
 
+    void Camera::capture(ecs::Entity* selected_entity)
+    {
+        m_snapshot.clear();
+        if (!target)
+            return;
+
+        m_snapshot.camera = snapshot_transform(*entity);
+        m_snapshot.fov = fov;
+        m_snapshot.near = near;
+        m_snapshot.far = far;
+        m_snapshot.aspect = (float)target->width() / (float)target->height();
+        glm::vec3 world_pos = m_snapshot.camera.position;
+        m_view = glm::lookAt(world_pos, world_pos + m_snapshot.camera.forward, m_snapshot.camera.up);
+        m_projection = glm::perspective(fov, m_snapshot.aspect, near, far);
+        m_snapshot.view = m_view;
+        m_snapshot.projection = m_projection;
+
+        m_models.clear();
+        entity->scene->get_components<ModelComponent>(m_models, false, true);
+        for (auto const& m : m_models) {
+            glm::mat4 matrix = m->entity->transform.global_matrix();
+            float distance = glm::distance(world_pos, glm::vec3(matrix[3]));
+            // Textures of closer models are loaded first.
+            if (m->material && m->material->loading())
+                m->material->loading_priority(-distance);
+            m_snapshot.models.push_back({m->model(), m->material, matrix, distance, m->world_bounding_box()});
+        }
+
+        for (auto const& light : entity->scene->get_components<DirectionalLight>(false, true))
+            m_snapshot.directional_lights.push_back({light, snapshot_transform(*light->entity)});
+        for (auto const& light : entity->scene->get_components<PointLight>(false, true))
+            m_snapshot.point_lights.push_back({light, snapshot_transform(*light->entity)});
+        for (auto const& light : entity->scene->get_components<Spotlight>(false, true))
+            m_snapshot.spotlights.push_back({light, snapshot_transform(*light->entity)});
+
+        if (core::Application::option_bool(core::BoolOption::SHOW_COLLIDERS)) {
+            for (auto const& collider : entity->scene->get_components<physics::ColliderComponent>(false, true))
+                m_snapshot.colliders.push_back({collider, collider->entity->transform.global_matrix()});
+        }
+
+        if (selected_entity)
+            capture_outline(*selected_entity);
+    }
+
     void Camera::render()
     {
         if (!target) {
@@ -114,38 +181,36 @@ namespace Birdy3d::render {
         if (m_old_target_width != target->width() || m_old_target_height != target->height()) {
             m_old_target_width = target->width();
             m_old_target_height = target->height();
-            m_projection = glm::perspective(fov, (float)target->width() / (float)target->height(), near, far);
             m_gbuffer.resize(target->width(), target->height());
             m_ssao_target.resize(target->width(), target->height());
             m_ssao_blur_target.resize(target->width(), target->height());
         }
 
-        glm::vec3 world_pos = entity->transform.world_position();
-        glm::vec3 world_forward = entity->world_forward();
-        glm::vec3 up = entity->world_up();
-        m_view = glm::lookAt(world_pos, world_pos + world_forward, up);
-
-        m_models.clear();
-        entity->scene->get_components<ModelComponent>(m_models, false, true);
-
-        m_dirlights.clear();
-        m_pointlights.clear();
-        m_spotlights.clear();
-        entity->scene->get_components<DirectionalLight>(m_dirlights, false, true);
-        entity->scene->get_components<PointLight>(m_pointlights, false, true);
-        entity->scene->get_components<Spotlight>(m_spotlights, false, true);
-        if (m_dirlights.size() != m_dirlight_amount || m_pointlights.size() != m_pointlight_amount || m_spotlights.size() != m_spotlight_amount) {
-            m_deferred_light_shader.arg("DIRECTIONAL_LIGHTS_AMOUNT", m_dirlights.size());
-            m_deferred_light_shader.arg("POINTLIGHTS_AMOUNT", m_pointlights.size());
-            m_deferred_light_shader.arg("SPOTLIGHTS_AMOUNT", m_spotlights.size());
-            m_forward_shader.arg("DIRECTIONAL_LIGHTS_AMOUNT", m_dirlights.size());
-            m_forward_shader.arg("POINTLIGHTS_AMOUNT", m_pointlights.size());
-            m_forward_shader.arg("SPOTLIGHTS_AMOUNT", m_spotlights.size());
-            m_dirlight_amount = m_dirlights.size();
-            m_pointlight_amount = m_pointlights.size();
-            m_spotlight_amount = m_spotlights.size();
+        auto dirlight_amount = m_snapshot.directional_lights.size();
+        auto pointlight_amount = m_snapshot.point_lights.size();
+        auto spotlight_amount = m_snapshot.spotlights.size();
+        int shadow_cascade_size = core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE);
+        if (dirlight_amount != m_dirlight_amount || pointlight_amount != m_pointlight_amount || spotlight_amount != m_spotlight_amount || shadow_cascade_size != m_shadow_cascade_size) {
+            // All parameters change at once, so that no intermediate variant is compiled. Until the new variant is
+            // linked, the previous one renders with the new light buffers, which never shrink.
+            for (auto shader : {&m_deferred_light_shader, &m_forward_shader}) {
+                auto variant = shader->id();
+                variant.arg("DIRECTIONAL_LIGHTS_AMOUNT", std::to_string(dirlight_amount));
+                variant.arg("POINTLIGHTS_AMOUNT", std::to_string(pointlight_amount));
+                variant.arg("SPOTLIGHTS_AMOUNT", std::to_string(spotlight_amount));
+                variant.arg("SHADOW_CASCADE_SIZE", std::to_string(shadow_cascade_size));
+                if (variant != shader->id())
+                    *shader = variant;
+            }
+            m_dirlight_amount = dirlight_amount;
+            m_pointlight_amount = pointlight_amount;
+            m_spotlight_amount = spotlight_amount;
+            m_shadow_cascade_size = shadow_cascade_size;
         }
 
+        update_shader_buffers();
+        cull_models();
+
         if (deferred_enabled) {
             render_deferred();
             render_forward(false);
@@ -172,7 +237,7 @@ namespace Birdy3d::render {
             // setup plane VAO
             glGenVertexArrays(1, &m_quad_vao);
             glGenBuffers(1, &m_quad_vbo);
-            glBindVertexArray(m_quad_vao);
+            RenderState::bind_vertex_array(m_quad_vao);
             glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
             glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertices), &quad_vertices, GL_STATIC_DRAW);
             glEnableVertexAttribArray(0);
@@ -180,9 +245,8 @@ namespace Birdy3d::render {
             glEnableVertexAttribArray(1);
             glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
         }
-        glBindVertexArray(m_quad_vao);
+        RenderState::bind_vertex_array(m_quad_vao);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
     }
 
     void Camera::render_deferred()
@@ -209,29 +273,22 @@ namespace Birdy3d::render {
         }
 
         // 1. geometry pass: render all geometric/color data to g-buffer
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
+        RenderState::enable(GL_DEPTH_TEST);
+        RenderState::disable(GL_BLEND);
         m_gbuffer.bind();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         m_deferred_geometry_shader->use();
-        m_deferred_geometry_shader->set_mat4("projection", m_projection);
-        m_deferred_geometry_shader->set_mat4("view", m_view);
-        for (auto m : m_models) {
-            m->render(*m_deferred_geometry_shader, false);
-        }
+        m_instances.render(false);
 
         // 2. SSAO
         m_ssao_target.bind();
         glClear(GL_COLOR_BUFFER_BIT);
         m_gbuffer_position->bind(0);
         m_gbuffer_normal->bind(1);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, m_ssao_noise);
+        RenderState::bind_texture(2, m_ssao_noise);
         m_ssao_shader->use();
         for (unsigned int i = 0; i < ssao_kernel.size(); i++)
-            m_ssao_shader->set_vec3("samples[" + std::to_string(i) + "]", ssao_kernel[i]);
-        m_ssao_shader->set_mat4("projection", m_projection);
-        m_ssao_shader->set_mat4("view", m_view);
+            m_ssao_shader->set_vec3(uniforms::samples[i], ssao_kernel[i]);
         render_quad();
 
         // 3. blur SSAO
@@ -246,113 +303,64 @@ namespace Birdy3d::render {
         m_gbuffer_normal->bind(1);
         m_gbuffer_albedo_spec->bind(2);
         m_ssao_blur_texture->bind(3);
-        m_deferred_light_shader.arg("SHADOW_CASCADE_SIZE", core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE));
-        for (size_t i = 0; i < m_dirlights.size(); i++)
-            m_dirlights[i]->use(*m_deferred_light_shader, i, 4 + i);
-        for (size_t i = 0; i < m_pointlights.size(); i++)
-            m_pointlights[i]->use(*m_deferred_light_shader, i, 4 + m_dirlights.size() + i);
-        for (size_t i = 0; i < m_spotlights.size(); i++)
-            m_spotlights[i]->use(*m_deferred_light_shader, i, 4 + m_dirlights.size() + m_pointlights.size() + i);
 
         target->bind();
         glClear(GL_COLOR_BUFFER_BIT);
-        glEnable(GL_FRAMEBUFFER_SRGB);
-        m_deferred_light_shader->set_int("gbuffer_position", 0);
-        m_deferred_light_shader->set_int("gbuffer_normal", 1);
-        m_deferred_light_shader->set_int("gbuffer_albedo_spec", 2);
-        m_deferred_light_shader->set_int("ssao", 3);
-        m_deferred_light_shader->set_mat4("view", m_view);
-        m_deferred_light_shader->set_vec3("view_pos", entity->transform.world_position());
+        RenderState::enable(GL_FRAMEBUFFER_SRGB);
+        m_deferred_light_shader->use();
+        m_deferred_light_shader->set_int(uniforms::gbuffer_position, 0);
+        m_deferred_light_shader->set_int(uniforms::gbuffer_normal, 1);
+        m_deferred_light_shader->set_int(uniforms::gbuffer_albedo_spec, 2);
+        m_deferred_light_shader->set_int(uniforms::ssao, 3);
         render_quad();
-        glDisable(GL_FRAMEBUFFER_SRGB);
+        RenderState::disable(GL_FRAMEBUFFER_SRGB);
     }
 
     void Camera::render_forward(bool render_opaque)
     {
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        m_forward_shader.arg("SHADOW_CASCADE_SIZE", core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE));
-        for (size_t i = 0; i < m_dirlights.size(); i++)
-            m_dirlights[i]->use(*m_forward_shader, i, 4 + i);
-        for (size_t i = 0; i < m_pointlights.size(); i++)
-            m_pointlights[i]->use(*m_forward_shader, i, 4 + m_dirlights.size() + i);
-        for (size_t i = 0; i < m_spotlights.size(); i++)
-            m_spotlights[i]->use(*m_forward_shader, i, 4 + m_dirlights.size() + m_pointlights.size() + i);
+        RenderState::enable(GL_DEPTH_TEST);
+        RenderState::enable(GL_BLEND);
+        RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         target->bind();
         if (render_opaque) {
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         } else {
-            glBindFramebuffer(GL_READ_FRAMEBUFFER, m_gbuffer.id());
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->id());
-            glBlitFramebuffer(0, 0, target->width() - 1, target->height() - 1, 0, 0, target->width() - 1, target->height() - 1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+            glBlitNamedFramebuffer(m_gbuffer.id(), target->id(), 0, 0, target->width() - 1, target->height() - 1, 0, 0, target->width() - 1, target->height() - 1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
         }
 
-        glEnable(GL_FRAMEBUFFER_SRGB);
+        RenderState::enable(GL_FRAMEBUFFER_SRGB);
         m_forward_shader->use();
-        m_forward_shader->set_mat4("projection", m_projection);
-        m_forward_shader->set_mat4("view", m_view);
-        m_forward_shader->set_vec3("view_pos", entity->transform.world_position());
-        if (render_opaque) {
-            for (auto m : m_models) {
-                m->render(*m_forward_shader, false);
-            }
-        }
-
-        // Transparency
-        std::map<float, ModelComponent*> sorted;
-        for (auto m : m_models) {
-            float distance = glm::length(entity->transform.position - m->entity->transform.position);
-            sorted[distance] = m.get();
-        }
+        if (render_opaque)
+            m_instances.render(false);
 
-        for (auto it = sorted.rbegin(); it != sorted.rend(); it++) {
-            it->second->render(*m_forward_shader, true);
-        }
-        glDisable(GL_FRAMEBUFFER_SRGB);
+        // Transparency, sorted back to front in cull_models()
+        m_transparent_instances.render(true);
+        RenderState::disable(GL_FRAMEBUFFER_SRGB);
     }
 
     void Camera::render_normals()
     {
-        glEnable(GL_DEPTH_TEST);
+        RenderState::enable(GL_DEPTH_TEST);
 
         target->bind();
 
         m_normal_shader->use();
-        m_normal_shader->set_mat4("projection", m_projection);
-        m_normal_shader->set_mat4("view", m_view);
-        for (auto m : m_models) {
-            m->render(*m_normal_shader, false);
-            m->render(*m_normal_shader, true);
-        }
+        m_instances.render(false);
+        m_instances.render(true);
     }
 
-    void Camera::render_outline(ecs::Entity* selected_entity)
+    void Camera::capture_outline(ecs::Entity& selected_entity)
     {
-        if (selected_entity == nullptr)
-            return;
-
-        if (m_outline_vao == 0) {
-            glGenVertexArrays(1, &m_outline_vao);
-            glGenBuffers(1, &m_outline_vbo);
-
-            glBindVertexArray(m_outline_vao);
-            glBindBuffer(GL_ARRAY_BUFFER, m_outline_vbo);
-
-            glm::vec3 vertices[24];
-            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices[0], GL_DYNAMIC_DRAW);
-
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-        }
-
         glm::vec3 low(std::numeric_limits<float>::infinity());
         glm::vec3 high(-std::numeric_limits<float>::infinity());
 
         std::function<void(ecs::Entity*, glm::mat4)> compute_matrix = [&low, &high, &compute_matrix](ecs::Entity* entity, glm::mat4 model) {
             for (auto model_component : entity->get_components<ModelComponent>(false, false)) {
-                auto bounding_box = model_component->model()->bounding_box();
+                auto model_handle = model_component->model();
+                if (!model_handle)
+                    continue;
+                auto bounding_box = model_handle->bounding_box();
                 glm::vec3 model_low = model * glm::vec4(bounding_box.first, 1.0f);
                 glm::vec3 model_high = model * glm::vec4(bounding_box.second, 1.0f);
                 if (model_low.x < low.x)
@@ -373,7 +381,105 @@ namespace Birdy3d::render {
             }
         };
 
-        compute_matrix(selected_entity, glm::mat4{1});
+        compute_matrix(&selected_entity, glm::mat4{1});
+
+        m_snapshot.outline = {low, high};
+        m_snapshot.outline_matrix = selected_entity.transform.global_matrix();
+    }
+
+    void Camera::cull_models()
+    {
+        m_bounding_boxes.clear();
+        for (auto const& m : m_snapshot.models)
+            m_bounding_boxes.push_back(m.bounds);
+        Frustum frustum{m_projection * m_view};
+        frustum.cull(m_bounding_boxes, m_visibility);
+
+        m_visible_models.clear();
+        for (std::size_t i = 0; i < m_snapshot.models.size(); ++i) {
+            if (m_visibility[i] && m_snapshot.models[i].model)
+                m_visible_models.push_back(&m_snapshot.models[i]);
+        }
+        m_culling_stats.visible = m_visible_models.size();
+        m_culling_stats.culled = std::count(m_visibility.begin(), m_visibility.end(), 0);
+
+        m_instances.clear();
+        for (auto m : m_visible_models)
+            m_instances.add(*m->model, m->material.get(), m->matrix);
+        m_instances.upload();
+
+        // Sorted transparent models can only share a draw call with the previous one.
+        m_sorted_models = m_visible_models;
+        std::sort(m_sorted_models.begin(), m_sorted_models.end(), [](SnapshotModel const* a, SnapshotModel const* b) { return a->distance > b->distance; });
+        m_transparent_instances.clear();
+        for (auto m : m_sorted_models) {
+            auto const& material = m->material ? *m->material : m->model->embedded_material();
+            if (material.transparent())
+                m_transparent_instances.add_ordered(*m->model, &material, m->matrix);
+        }
+        m_transparent_instances.upload();
+    }
+
+    void Camera::update_shader_buffers()
+    {
+        CameraData camera_data{m_view, m_projection, m_snapshot.camera.position};
+        m_camera_buffer.upload(&camera_data, sizeof(camera_data));
+        m_camera_buffer.bind();
+        MaterialTable::bind();
+
+        // Every light draws the same shadow casters, so they are only batched once.
+        m_shadow_casters.clear();
+        for (auto const& m : m_snapshot.models) {
+            if (m.model)
+                m_shadow_casters.add(*m.model, m.material.get(), m.matrix);
+        }
+        m_shadow_casters.upload();
+
+        // The shadow maps use the texture units after the ones of the material.
+        auto const& dirlights = m_snapshot.directional_lights;
+        auto const& pointlights = m_snapshot.point_lights;
+        auto const& spotlights = m_snapshot.spotlights;
+        std::vector<DirectionalLightData> directional_light_data;
+        std::vector<ShadowCascadeData> shadow_cascade_data;
+        std::vector<PointLightData> point_light_data;
+        std::vector<SpotlightData> spotlight_data;
+        for (std::size_t i = 0; i < dirlights.size(); i++)
+            directional_light_data.push_back(dirlights[i].light->use(4 + i, m_snapshot, dirlights[i].transform, m_shadow_casters, shadow_cascade_data));
+        for (std::size_t i = 0; i < pointlights.size(); i++)
+            point_light_data.push_back(pointlights[i].light->use(4 + dirlights.size() + i, pointlights[i].transform, m_shadow_casters));
+        for (std::size_t i = 0; i < spotlights.size(); i++)
+            spotlight_data.push_back(spotlights[i].light->use(4 + dirlights.size() + pointlights.size() + i, spotlights[i].transform, m_shadow_casters));
+
+        m_directional_light_buffer.upload(directional_light_data);
+        m_directional_light_buffer.bind();
+        m_shadow_cascade_buffer.upload(shadow_cascade_data);
+        m_shadow_cascade_buffer.bind();
+        m_point_light_buffer.upload(point_light_data);
+        m_point_light_buffer.bind();
+        m_spotlight_buffer.upload(spotlight_data);
+        m_spotlight_buffer.bind();
+    }
+
+    void Camera::render_outline()
+    {
+        if (!m_snapshot.outline)
+            return;
+
+        if (m_outline_vao == 0) {
+            glGenVertexArrays(1, &m_outline_vao);
+            glGenBuffers(1, &m_outline_vbo);
+
+            RenderState::bind_vertex_array(m_outline_vao);
+            glBindBuffer(GL_ARRAY_BUFFER, m_outline_vbo);
+
+            glm::vec3 vertices[24];
+            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices[0], GL_DYNAMIC_DRAW);
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        }
+
+        auto [low, high] = m_snapshot.outline.value();
 
         // clang-format off
         glm::vec3 vertices[24] = {
@@ -394,40 +500,35 @@ namespace Birdy3d::render {
             glm::vec3(low.x, low.y, high.z), glm::vec3(low.x, high.y, high.z),
         };
         // clang-format on
-        glBindVertexArray(m_outline_vao);
+        RenderState::bind_vertex_array(m_outline_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_outline_vbo);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), &vertices[0]);
 
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RenderState::enable(GL_DEPTH_TEST);
+        RenderState::enable(GL_BLEND);
+        RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         target->bind();
         glClear(GL_DEPTH_BUFFER_BIT);
 
         m_simple_color_shader->use();
-        m_simple_color_shader->set_mat4("projection", m_projection);
-        m_simple_color_shader->set_mat4("view", m_view);
-        m_simple_color_shader->set_vec4("color", core::Application::theme().color(utils::Color::Name::OBJECT_SELECTION));
-        m_simple_color_shader->set_mat4("model", selected_entity->transform.global_matrix());
-        glBindVertexArray(m_outline_vao);
+        m_simple_color_shader->set_vec4(uniforms::color, core::Application::theme().color(utils::Color::Name::OBJECT_SELECTION));
+        m_simple_color_shader->set_mat4(uniforms::model, m_snapshot.outline_matrix);
+        RenderState::bind_vertex_array(m_outline_vao);
         glDrawArrays(GL_LINES, 0, 24);
     }
 
     void Camera::render_collider_wireframe()
     {
-        glEnable(GL_DEPTH_TEST);
+        RenderState::enable(GL_DEPTH_TEST);
         target->bind();
         glClear(GL_DEPTH_BUFFER_BIT);
 
-        glDisable(GL_CULL_FACE);
+        RenderState::disable(GL_CULL_FACE);
         m_simple_color_shader->use();
-        m_simple_color_shader->set_mat4("projection", m_projection);
-        m_simple_color_shader->set_mat4("view", m_view);
-        m_simple_color_shader->set_vec4("color", core::Application::theme().color(utils::Color::Name::COLLIDER_WIREFRAME));
-        for (auto c : entity->scene->get_components<physics::ColliderComponent>(false, true)) {
-            c->render_wireframe(*m_simple_color_shader);
-        }
-        glEnable(GL_CULL_FACE);
+        m_simple_color_shader->set_vec4(uniforms::color, core::Application::theme().color(utils::Color::Name::COLLIDER_WIREFRAME));
+        for (auto const& c : m_snapshot.colliders)
+            c.collider->render_wireframe(c.matrix, *m_simple_color_shader);
+        RenderState::enable(GL_CULL_FACE);
     }
 
     void Camera::serialize(serializer::Adapter& adapter)
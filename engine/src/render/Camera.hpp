@@ -4,10 +4,20 @@
 #include "core/ResourceHandle.hpp"
 #include "ecs/Component.hpp"
 #include "render/Forward.hpp"
+#include "render/InstanceBatches.hpp"
+#include "render/RenderSnapshot.hpp"
 #include "render/Rendertarget.hpp"
+#include "render/ShaderBuffer.hpp"
 
 namespace Birdy3d::render {
 
+    struct CullingStats {
+        // Models of the last frame that intersect the view frustum
+        std::size_t visible = 0;
+        // Models of the last frame that were skipped, because they are outside of the view frustum
+        std::size_t culled = 0;
+    };
+
     class Camera : public ecs::Component {
     public:
         bool display_normals = false;
@@ -21,9 +31,19 @@ namespace Birdy3d::render {
         Camera(std::shared_ptr<Rendertarget> target, bool deferred);
         void start() override;
         void cleanup() override;
+        /**
+         * @brief Captures everything that is needed to render the current state of the scene.
+         * @param selected_entity Entity to draw the outline of with render_outline()
+         */
+        void capture(ecs::Entity* selected_entity = nullptr);
+        /**
+         * @brief Renders the last captured snapshot. Doesn't access the transforms of the scene.
+         */
         void render();
-        void render_outline(ecs::Entity*);
+        void render_outline();
         void render_collider_wireframe();
+        RenderSnapshot const& snapshot() const { return m_snapshot; }
+        CullingStats const& culling_stats() const { return m_culling_stats; }
         void serialize(serializer::Adapter&) override;
         glm::mat4 view() { return m_view; }
         glm::mat4 projection() { return m_projection; }
@@ -43,13 +63,12 @@ namespace Birdy3d::render {
         unsigned int m_outline_vao = 0;
         unsigned int m_outline_vbo = 0;
 
-        std::vector<std::shared_ptr<DirectionalLight>> m_dirlights;
-        std::vector<std::shared_ptr<PointLight>> m_pointlights;
-        std::vector<std::shared_ptr<Spotlight>> m_spotlights;
+        RenderSnapshot m_snapshot;
         // For updating shader
         std::size_t m_dirlight_amount = 0;
         std::size_t m_pointlight_amount = 0;
         std::size_t m_spotlight_amount = 0;
+        int m_shadow_cascade_size = 0;
 
         Rendertarget m_ssao_target;
         Texture* m_ssao_texture;
@@ -61,7 +80,26 @@ namespace Birdy3d::render {
         core::ResourceHandle<Shader> m_ssao_shader, m_ssao_blur_shader;
 
         std::vector<std::shared_ptr<ModelComponent>> m_models;
-
+        // Models of the snapshot that intersect the view frustum, the shadow maps still use all of them
+        std::vector<SnapshotModel const*> m_visible_models;
+        std::vector<BoundingBox> m_bounding_boxes;
+        std::vector<std::uint8_t> m_visibility;
+        CullingStats m_culling_stats;
+        std::vector<SnapshotModel const*> m_sorted_models;
+        InstanceBatches m_instances;
+        InstanceBatches m_transparent_instances;
+        InstanceBatches m_shadow_casters;
+
+        // Shared by all shaders, updated once per frame
+        ShaderBuffer m_camera_buffer{GL_UNIFORM_BUFFER, BufferBinding::CAMERA};
+        ShaderBuffer m_directional_light_buffer{GL_SHADER_STORAGE_BUFFER, BufferBinding::DIRECTIONAL_LIGHTS};
+        ShaderBuffer m_shadow_cascade_buffer{GL_SHADER_STORAGE_BUFFER, BufferBinding::SHADOW_CASCADES};
+        ShaderBuffer m_point_light_buffer{GL_SHADER_STORAGE_BUFFER, BufferBinding::POINT_LIGHTS};
+        ShaderBuffer m_spotlight_buffer{GL_SHADER_STORAGE_BUFFER, BufferBinding::SPOTLIGHTS};
+
+        void capture_outline(ecs::Entity& selected_entity);
+        void cull_models();
+        void update_shader_buffers();
         void render_quad();
         void render_deferred();
         void render_forward(bool render_opaque);
@@ -2,14 +2,22 @@
 
 #include "core/Application.hpp"
 #include "ecs/Entity.hpp"
-#include "ecs/Scene.hpp"
-#include "render/Camera.hpp"
-#include "render/ModelComponent.hpp"
+#include "render/InstanceBatches.hpp"
+#include "render/RenderSnapshot.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        namespace uniforms {
+            UniformHandle const light_space_matrices{"light_space_matrices"};
+        }
+
+    }
+
     DirectionalLight::DirectionalLight(utils::Color color, float intensity_ambient, float intensity_diffuse, bool shadow_enabled)
         : color(color)
         , intensity_ambient(intensity_ambient)
@@ -23,8 +31,8 @@ namespace Birdy3d::render {
 
         glGenFramebuffers(1, &m_shadow_map_fbo);
 
-        glGenTextures(1, &m_shadow_map);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, m_shadow_map);
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_shadow_map);
+        RenderState::bind_texture(0, m_shadow_map);
         glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, shadow_size, shadow_size, core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE), 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 
         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -36,7 +44,7 @@ namespace Birdy3d::render {
         constexpr float bordercolor[] = {1.0f, 1.0f, 1.0f, 1.0f};
         glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, bordercolor);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, m_shadow_map_fbo);
+        RenderState::bind_framebuffer(m_shadow_map_fbo);
         glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_shadow_map, 0);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
@@ -46,61 +54,63 @@ namespace Birdy3d::render {
             core::Logger::error("ERROR::FRAMEBUFFER:: Framebuffer is not complete!");
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::bind_framebuffer(0);
     }
 
-    void DirectionalLight::use(Shader const& light_shader, int id, int textureid)
+    DirectionalLightData DirectionalLight::use(int textureid, RenderSnapshot const& snapshot, SnapshotTransform const& transform, InstanceBatches const& shadow_casters, std::vector<ShadowCascadeData>& cascades)
     {
         if (!m_shadow_map_updated) {
-            gen_shadow_map();
+            gen_shadow_map(snapshot, transform, shadow_casters);
             m_shadow_map_updated = true;
         }
-        std::string name = "directional_lights[" + std::to_string(id) + "].";
-        light_shader.use();
-        light_shader.set_bool(name + "shadow_enabled", shadow_enabled);
-        light_shader.set_vec3(name + "position", entity->scene->m_current_camera->entity->transform.world_position() - entity->world_forward() * m_cam_offset);
-        light_shader.set_vec3(name + "direction", entity->world_forward());
-        light_shader.set_vec3(name + "ambient", color.value * intensity_ambient);
-        light_shader.set_vec3(name + "diffuse", color.value * intensity_diffuse);
-        glActiveTexture(GL_TEXTURE0 + textureid);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, m_shadow_map);
-        for (int i = 0; i < core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE); ++i) {
-            light_shader.set_mat4(name + "light_space_matrices[" + std::to_string(i) + "]", m_light_space_transforms[i]);
-            light_shader.set_float(name + "shadow_cascade_levels[" + std::to_string(i) + "]", m_shadow_cascade_levels[i]);
+        RenderState::bind_texture(textureid, m_shadow_map);
+
+        // The shaders expect exactly SHADOW_CASCADE_SIZE cascades per light, even if the option changed since the shadow map was generated.
+        std::size_t shadow_cascade_size = core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE);
+        for (std::size_t i = 0; i < shadow_cascade_size; ++i) {
+            if (i < m_light_space_transforms.size())
+                cascades.push_back({m_light_space_transforms[i], m_shadow_cascade_levels[i]});
+            else
+                cascades.push_back({glm::mat4{1}, std::numeric_limits<float>::infinity()});
         }
-        light_shader.set_int(name + "shadow_map", textureid);
+
+        return {
+            .position = snapshot.camera.position - transform.forward * m_cam_offset,
+            .shadow_enabled = shadow_enabled,
+            .direction = transform.forward,
+            .ambient = color.value * intensity_ambient,
+            .diffuse = color.value * intensity_diffuse,
+        };
     }
 
-    void DirectionalLight::gen_shadow_map()
+    void DirectionalLight::gen_shadow_map(RenderSnapshot const& snapshot, SnapshotTransform const& transform, InstanceBatches const& shadow_casters)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_shadow_map_fbo);
+        RenderState::bind_framebuffer(m_shadow_map_fbo);
         glClear(GL_DEPTH_BUFFER_BIT);
-        glCullFace(GL_FRONT);
-        glEnable(GL_DEPTH_TEST);
-        glViewport(0, 0, shadow_size, shadow_size);
+        RenderState::cull_face(GL_FRONT);
+        RenderState::enable(GL_DEPTH_TEST);
+        RenderState::viewport(0, 0, shadow_size, shadow_size);
 
         int shadow_cascade_size = core::Application::option_int(core::IntOption::SHADOW_CASCADE_SIZE);
         m_depth_shader.arg("SHADOW_CASCADE_SIZE", shadow_cascade_size);
         m_depth_shader->use();
 
         float nearest = 5.0f;
-        float camera_near = entity->scene->m_current_camera->near;
-        float camera_far = entity->scene->m_current_camera->far;
-        m_light_space_transforms.reserve(shadow_cascade_size);
-        m_shadow_cascade_levels.reserve(shadow_cascade_size);
+        float camera_near = snapshot.near;
+        float camera_far = snapshot.far;
+        m_light_space_transforms.resize(shadow_cascade_size);
+        m_shadow_cascade_levels.resize(shadow_cascade_size);
         for (int i = 0; i < shadow_cascade_size; ++i) {
             // TODO: Use exponential scale instead of linear
             float near = i == 0 ? camera_near : m_shadow_cascade_levels[i - 1];
             float far = i == 0 ? nearest : near + (camera_far - near) / (shadow_cascade_size - i);
             m_shadow_cascade_levels[i] = far;
-            m_light_space_transforms[i] = calculate_light_space_matrix(near, far);
-            m_depth_shader->set_mat4("light_space_matrices[" + std::to_string(i) + "]", m_light_space_transforms[i]);
-        }
-        for (auto m : entity->scene->get_components<ModelComponent>(false, true)) {
-            m->render_depth(*m_depth_shader);
+            m_light_space_transforms[i] = calculate_light_space_matrix(snapshot, transform, near, far);
         }
+        m_depth_shader->set_mat4_array(uniforms::light_space_matrices, m_light_space_transforms);
+        shadow_casters.render_depth();
 
-        glCullFace(GL_BACK);
+        RenderState::cull_face(GL_BACK);
     }
 
     void DirectionalLight::start()
@@ -123,11 +133,10 @@ namespace Birdy3d::render {
         adapter("cam_offset", m_cam_offset);
     }
 
-    glm::mat4 DirectionalLight::calculate_light_space_matrix(float const near_plane, float const far_plane)
+    glm::mat4 DirectionalLight::calculate_light_space_matrix(RenderSnapshot const& snapshot, SnapshotTransform const& transform, float const near_plane, float const far_plane)
     {
-        auto const camera = entity->scene->m_current_camera;
-        auto const projection = glm::perspective(camera->fov, (float)camera->target->width() / (float)camera->target->height(), near_plane, far_plane);
-        auto const view = entity->scene->m_current_camera->view();
+        auto const projection = glm::perspective(snapshot.fov, snapshot.aspect, near_plane, far_plane);
+        auto const view = snapshot.view;
 
         auto const inv = glm::inverse(projection * view);
 
@@ -147,7 +156,7 @@ namespace Birdy3d::render {
         }
         center /= frustum_corners.size();
 
-        auto const light_view = glm::lookAt(center - entity->world_forward(), center, entity->world_up());
+        auto const light_view = glm::lookAt(center - transform.forward, center, transform.up);
 
         float min_x = std::numeric_limits<float>::max();
         float max_x = std::numeric_limits<float>::min();
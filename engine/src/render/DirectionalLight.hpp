@@ -3,6 +3,7 @@
 #include "core/ResourceHandle.hpp"
 #include "ecs/Component.hpp"
 #include "render/Shader.hpp"
+#include "render/ShaderData.hpp"
 #include "utils/Color.hpp"
 
 namespace Birdy3d::render {
@@ -16,8 +17,14 @@ namespace Birdy3d::render {
 
         DirectionalLight(utils::Color color = utils::Color::WHITE, float intensity_ambient = 1, float intensity_diffuse = 1, bool shadow_enabled = true);
         void setup_shadow_map();
-        void gen_shadow_map();
-        void use(Shader const& light_shader, int id, int textureid);
+        void gen_shadow_map(RenderSnapshot const&, SnapshotTransform const&, InstanceBatches const& shadow_casters);
+        /**
+         * @brief Updates the shadow map if necessary and binds it to the texture unit.
+         * @param shadow_casters Models that are drawn into the shadow map, already uploaded
+         * @param cascades Receives SHADOW_CASCADE_SIZE cascades of the shadow map
+         * @returns the data of the light for the shaders
+         */
+        DirectionalLightData use(int textureid, RenderSnapshot const&, SnapshotTransform const&, InstanceBatches const& shadow_casters, std::vector<ShadowCascadeData>& cascades);
         void start() override;
         void update() override;
         void serialize(serializer::Adapter&) override;
@@ -31,7 +38,7 @@ namespace Birdy3d::render {
         GLuint m_shadow_map_fbo, m_shadow_map;
         bool m_shadow_map_updated = false;
 
-        glm::mat4 calculate_light_space_matrix(float const near_plane, float const far_plane);
+        glm::mat4 calculate_light_space_matrix(RenderSnapshot const&, SnapshotTransform const&, float const near_plane, float const far_plane);
 
         BIRDY3D_REGISTER_DERIVED_TYPE_DEC(ecs::Component, DirectionalLight);
     };
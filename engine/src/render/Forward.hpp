@@ -4,6 +4,7 @@ namespace Birdy3d::render {
 
     class Camera;
     class DirectionalLight;
+    class InstanceBatches;
     class Material;
     class Mesh;
     class Model;
@@ -13,6 +14,9 @@ namespace Birdy3d::render {
     class Shader;
     class Spotlight;
     class Texture;
+    struct RenderSnapshot;
+    struct ShaderSources;
+    struct SnapshotTransform;
     struct Vertex;
 
 }
@@ -0,0 +1,89 @@
+#include "render/Frustum.hpp"
+
+#include "core/JobSystem.hpp"
+
+namespace Birdy3d::render {
+
+    namespace {
+
+        // Boxes per batch, small enough that the transposed batch stays in the L1 cache
+        constexpr std::size_t BATCH_SIZE = 64;
+        // Batches per job of parallel_for
+        constexpr std::size_t BATCHES_PER_JOB = 16;
+
+    }
+
+    BoundingBox BoundingBox::transformed(std::pair<glm::vec3, glm::vec3> const& local, glm::mat4 const& matrix)
+    {
+        glm::vec3 center = (local.first + local.second) * 0.5f;
+        glm::vec3 extent = (local.second - local.first) * 0.5f;
+        // The extent along each world axis is the sum of the absolute contributions of the local axes.
+        glm::vec3 world_extent = glm::abs(glm::vec3(matrix[0])) * extent.x + glm::abs(glm::vec3(matrix[1])) * extent.y + glm::abs(glm::vec3(matrix[2])) * extent.z;
+        return {glm::vec3(matrix * glm::vec4(center, 1.0f)), world_extent};
+    }
+
+    Frustum::Frustum(glm::mat4 const& projection_view)
+    {
+        // Gribb-Hartmann: each plane is the sum or difference of the fourth and one of the other rows.
+        glm::mat4 rows = glm::transpose(projection_view);
+        m_planes = {
+            rows[3] + rows[0],
+            rows[3] - rows[0],
+            rows[3] + rows[1],
+            rows[3] - rows[1],
+            rows[3] + rows[2],
+            rows[3] - rows[2],
+        };
+        for (auto& plane : m_planes)
+            plane /= glm::length(glm::vec3(plane));
+    }
+
+    void Frustum::cull(std::span<BoundingBox const> boxes, std::vector<std::uint8_t>& visible) const
+    {
+        visible.resize(boxes.size());
+        std::size_t batch_count = (boxes.size() + BATCH_SIZE - 1) / BATCH_SIZE;
+        core::JobSystem::parallel_for(
+            batch_count, [&](std::size_t batch) {
+                std::size_t begin = batch * BATCH_SIZE;
+                std::size_t count = std::min(BATCH_SIZE, boxes.size() - begin);
+
+                // The unused tail of the last batch is tested as well and ignored afterwards.
+                alignas(32) std::array<float, BATCH_SIZE> cx{}, cy{}, cz{}, ex{}, ey{}, ez{};
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto const& box = boxes[begin + i];
+                    cx[i] = box.center.x;
+                    cy[i] = box.center.y;
+                    cz[i] = box.center.z;
+                    ex[i] = box.extent.x;
+                    ey[i] = box.extent.y;
+                    ez[i] = box.extent.z;
+                }
+
+                // The inner loops have no branches, so that they run on all lanes at once.
+                alignas(32) std::array<std::uint8_t, BATCH_SIZE> inside;
+                inside.fill(1);
+                for (auto const& plane : m_planes) {
+                    glm::vec3 absolute = glm::abs(glm::vec3(plane));
+                    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+                        float distance = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+                        float radius = absolute.x * ex[i] + absolute.y * ey[i] + absolute.z * ez[i];
+                        inside[i] &= distance + radius >= 0.0f;
+                    }
+                }
+                std::copy_n(inside.begin(), count, visible.begin() + begin);
+            },
+            BATCHES_PER_JOB);
+    }
+
+    bool Frustum::visible(BoundingBox const& box) const
+    {
+        for (auto const& plane : m_planes) {
+            float distance = glm::dot(glm::vec3(plane), box.center) + plane.w;
+            float radius = glm::dot(glm::abs(glm::vec3(plane)), box.extent);
+            if (distance + radius < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+}
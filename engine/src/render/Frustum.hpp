@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include <cstdint>
+#include <span>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Axis aligned bounding box in world space, stored as center and half size.
+     */
+    struct BoundingBox {
+        glm::vec3 center{0};
+        glm::vec3 extent{0};
+
+        /**
+         * @brief Computes the axis aligned box that encloses a transformed box.
+         * @param local lowest and highest corner of the box before the transformation, e.g. Model::bounding_box()
+         */
+        static BoundingBox transformed(std::pair<glm::vec3, glm::vec3> const& local, glm::mat4 const& matrix);
+    };
+
+    /**
+     * @brief The six planes of a view frustum, pointing inwards.
+     */
+    class Frustum {
+    public:
+        /**
+         * @param projection_view projection * view matrix of the camera
+         */
+        explicit Frustum(glm::mat4 const& projection_view);
+
+        /**
+         * @brief Tests the boxes against all planes in batches of structure-of-arrays data that the compiler can
+         * vectorize. Boxes that intersect the frustum count as visible.
+         * @param visible resized to the amount of boxes, 1 if the box is visible and 0 if it is culled
+         */
+        void cull(std::span<BoundingBox const> boxes, std::vector<std::uint8_t>& visible) const;
+        [[nodiscard]] bool visible(BoundingBox const&) const;
+
+    private:
+        // xyz is the normal, w the distance from the origin
+        std::array<glm::vec4, 6> m_planes;
+    };
+
+}
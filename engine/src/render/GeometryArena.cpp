@@ -0,0 +1,161 @@
+#include "render/GeometryArena.hpp"
+
+#include "core/Application.hpp"
+#include "render/RenderState.hpp"
+#include "render/Vertex.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace Birdy3d::render {
+
+    GLuint GeometryArena::m_vao = 0;
+    GLuint GeometryArena::m_vbo = 0;
+    GLuint GeometryArena::m_ebo = 0;
+    RangeAllocator GeometryArena::m_vertices;
+    RangeAllocator GeometryArena::m_indices;
+
+    std::optional<std::uint32_t> RangeAllocator::allocate(std::uint32_t count)
+    {
+        for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+            auto [offset, size] = *it;
+            if (size < count)
+                continue;
+            if (size == count) {
+                m_free.erase(it);
+            } else {
+                it->first += count;
+                it->second -= count;
+            }
+            return offset;
+        }
+        return {};
+    }
+
+    void RangeAllocator::free(std::uint32_t offset, std::uint32_t count)
+    {
+        if (count == 0)
+            return;
+        auto next = std::lower_bound(m_free.begin(), m_free.end(), std::pair{offset, 0u});
+        if (next != m_free.begin()) {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset) {
+                previous->second += count;
+                if (next != m_free.end() && offset + count == next->first) {
+                    previous->second += next->second;
+                    m_free.erase(next);
+                }
+                return;
+            }
+        }
+        if (next != m_free.end() && offset + count == next->first) {
+            next->first = offset;
+            next->second += count;
+            return;
+        }
+        m_free.insert(next, {offset, count});
+    }
+
+    void RangeAllocator::grow(std::uint32_t capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+        auto old_capacity = m_capacity;
+        m_capacity = capacity;
+        free(old_capacity, capacity - old_capacity);
+    }
+
+    std::optional<GeometryRange> GeometryArena::allocate(std::span<Vertex const> vertices, std::span<unsigned int const> indices)
+    {
+        if (!core::Application::option_bool(core::BoolOption::GEOMETRY_ARENA))
+            return {};
+        if (m_vao == 0)
+            glCreateVertexArrays(1, &m_vao);
+
+        auto first_vertex = allocate(m_vertices, m_vbo, sizeof(Vertex), vertices.size());
+        auto first_index = allocate(m_indices, m_ebo, sizeof(unsigned int), indices.size());
+        GeometryRange range{
+            .first_vertex = *first_vertex,
+            .vertex_count = static_cast<std::uint32_t>(vertices.size()),
+            .first_index = *first_index,
+            .index_count = static_cast<std::uint32_t>(indices.size()),
+        };
+        glNamedBufferSubData(m_vbo, range.first_vertex * sizeof(Vertex), vertices.size_bytes(), vertices.data());
+        glNamedBufferSubData(m_ebo, range.first_index * sizeof(unsigned int), indices.size_bytes(), indices.data());
+        return range;
+    }
+
+    void GeometryArena::free(GeometryRange const& range)
+    {
+        // The meshes of resources that outlive the context are freed after cleanup().
+        if (m_vao == 0)
+            return;
+        m_vertices.free(range.first_vertex, range.vertex_count);
+        m_indices.free(range.first_index, range.index_count);
+    }
+
+    void GeometryArena::bind()
+    {
+        RenderState::bind_vertex_array(m_vao);
+    }
+
+    void GeometryArena::cleanup()
+    {
+        if (m_vao != 0)
+            RenderState::delete_vertex_array(m_vao);
+        if (m_vbo != 0)
+            glDeleteBuffers(1, &m_vbo);
+        if (m_ebo != 0)
+            glDeleteBuffers(1, &m_ebo);
+        m_vao = 0;
+        m_vbo = 0;
+        m_ebo = 0;
+        m_vertices = {};
+        m_indices = {};
+    }
+
+    std::size_t GeometryArena::memory_size()
+    {
+        return m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(unsigned int);
+    }
+
+    std::optional<std::uint32_t> GeometryArena::allocate(RangeAllocator& allocator, GLuint& buffer, std::size_t element_size, std::uint32_t count)
+    {
+        if (auto offset = allocator.allocate(count))
+            return offset;
+
+        // Grows at least by half, so that loading many meshes doesn't copy the buffer every time.
+        auto old_capacity = allocator.capacity();
+        auto capacity = std::max<std::uint32_t>(1 << 16, std::bit_ceil(old_capacity + std::max(count, old_capacity / 2)));
+        GLuint new_buffer;
+        glCreateBuffers(1, &new_buffer);
+        glNamedBufferData(new_buffer, capacity * element_size, nullptr, GL_STATIC_DRAW);
+        if (buffer != 0) {
+            glCopyNamedBufferSubData(buffer, new_buffer, 0, 0, old_capacity * element_size);
+            glDeleteBuffers(1, &buffer);
+        }
+        buffer = new_buffer;
+        allocator.grow(capacity);
+        attach_buffers();
+        return allocator.allocate(count);
+    }
+
+    void GeometryArena::attach_buffers()
+    {
+        glVertexArrayVertexBuffer(m_vao, 0, m_vbo, 0, sizeof(Vertex));
+        glVertexArrayElementBuffer(m_vao, m_ebo);
+        // Same attributes as the vertex arrays of the meshes that aren't in the arena
+        glEnableVertexArrayAttrib(m_vao, 0);
+        glVertexArrayAttribFormat(m_vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position));
+        glVertexArrayAttribBinding(m_vao, 0, 0);
+        glEnableVertexArrayAttrib(m_vao, 1);
+        glVertexArrayAttribFormat(m_vao, 1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, normal));
+        glVertexArrayAttribBinding(m_vao, 1, 0);
+        glEnableVertexArrayAttrib(m_vao, 2);
+        glVertexArrayAttribFormat(m_vao, 2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, tex_coords));
+        glVertexArrayAttribBinding(m_vao, 2, 0);
+        glEnableVertexArrayAttrib(m_vao, 3);
+        glVertexArrayAttribFormat(m_vao, 3, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, tangent));
+        glVertexArrayAttribBinding(m_vao, 3, 0);
+    }
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include "render/Forward.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Layout of the commands of glMultiDrawElementsIndirect.
+     */
+    struct DrawElementsIndirectCommand {
+        std::uint32_t count;
+        std::uint32_t instance_count;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        std::uint32_t base_instance;
+    };
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+    /**
+     * @brief Location of the vertices and indices of a mesh in the GeometryArena. The indices are relative to
+     * first_vertex.
+     */
+    struct GeometryRange {
+        std::uint32_t first_vertex;
+        std::uint32_t vertex_count;
+        std::uint32_t first_index;
+        std::uint32_t index_count;
+
+        [[nodiscard]] DrawElementsIndirectCommand command(std::uint32_t instance_count, std::uint32_t first_instance) const
+        {
+            return {index_count, instance_count, first_index, static_cast<std::int32_t>(first_vertex), first_instance};
+        }
+    };
+
+    /**
+     * @brief First fit allocator of ranges in a buffer. Adjacent free ranges are merged.
+     */
+    class RangeAllocator {
+    public:
+        /// @returns offset of the range or nullopt if there is no large enough free range
+        std::optional<std::uint32_t> allocate(std::uint32_t count);
+        void free(std::uint32_t offset, std::uint32_t count);
+        /**
+         * @brief Adds the space between the old and new capacity as a free range.
+         */
+        void grow(std::uint32_t capacity);
+        [[nodiscard]] std::uint32_t capacity() const { return m_capacity; }
+        /// @returns offset and size of the free ranges, sorted by offset
+        [[nodiscard]] std::vector<std::pair<std::uint32_t, std::uint32_t>> const& free_ranges() const { return m_free; }
+
+    private:
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> m_free;
+        std::uint32_t m_capacity = 0;
+    };
+
+    /**
+     * @brief One vertex and one index buffer with a shared vertex array that hold the meshes, so that draws of
+     * different meshes don't have to switch the vertex array and can be submitted together with glMultiDrawElementsIndirect.
+     *
+     * The buffers grow by copying them into larger ones, which keeps all ranges valid. Only used on the main thread.
+     */
+    class GeometryArena {
+    public:
+        /**
+         * @brief Copies the mesh data into the arena.
+         * @returns location of the data, nullopt if the arena is disabled
+         */
+        static std::optional<GeometryRange> allocate(std::span<Vertex const> vertices, std::span<unsigned int const> indices);
+        static void free(GeometryRange const&);
+        /**
+         * @brief Binds the shared vertex array, which also binds the index buffer.
+         */
+        static void bind();
+        static void cleanup();
+        /// @returns size of the vertex and index buffers in bytes
+        static std::size_t memory_size();
+
+    private:
+        static GLuint m_vao;
+        static GLuint m_vbo;
+        static GLuint m_ebo;
+        static RangeAllocator m_vertices;
+        static RangeAllocator m_indices;
+
+        static std::optional<std::uint32_t> allocate(RangeAllocator&, GLuint& buffer, std::size_t element_size, std::uint32_t count);
+        static void attach_buffers();
+    };
+
+}
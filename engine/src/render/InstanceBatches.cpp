@@ -0,0 +1,142 @@
+#include "render/InstanceBatches.hpp"
+
+#include "render/Material.hpp"
+#include "render/Mesh.hpp"
+#include "render/Model.hpp"
+#include "render/Texture.hpp"
+#include <algorithm>
+
+namespace Birdy3d::render {
+
+    void InstanceBatches::clear()
+    {
+        m_groups.clear();
+        m_group_indices.clear();
+        m_instances.clear();
+    }
+
+    void InstanceBatches::add(Model const& model, Material const* material, glm::mat4 const& matrix)
+    {
+        if (material == nullptr)
+            material = &model.embedded_material();
+        auto [it, inserted] = m_group_indices.try_emplace({&model, material}, 0);
+        if (inserted)
+            it->second = new_group(model, *material);
+        m_instances.push_back({it->second, matrix});
+    }
+
+    void InstanceBatches::add_ordered(Model const& model, Material const* material, glm::mat4 const& matrix)
+    {
+        if (material == nullptr)
+            material = &model.embedded_material();
+        bool same_as_previous = !m_instances.empty() && m_groups[m_instances.back().group].model == &model && m_groups[m_instances.back().group].material == material;
+        auto group = same_as_previous ? m_instances.back().group : new_group(model, *material);
+        m_instances.push_back({group, matrix});
+    }
+
+    void InstanceBatches::upload()
+    {
+        // The instances of a group have to be contiguous, so they are sorted by group with a counting sort.
+        for (auto& group : m_groups)
+            group.instance_count = 0;
+        for (auto const& instance : m_instances)
+            ++m_groups[instance.group].instance_count;
+        std::uint32_t offset = 0;
+        for (auto& group : m_groups) {
+            group.first_instance = offset;
+            group.material_index = group.material->index();
+            offset += group.instance_count;
+            group.instance_count = 0;
+        }
+
+        m_instance_data.resize(m_instances.size());
+        for (auto const& instance : m_instances) {
+            auto& group = m_groups[instance.group];
+            m_instance_data[group.first_instance + group.instance_count++] = {instance.matrix, group.material_index};
+        }
+        m_buffer.stream(m_instance_data);
+
+        m_commands.clear();
+        add_commands(false);
+        m_first_transparent_command = m_commands.size();
+        add_commands(true);
+        m_command_buffer.stream(m_commands);
+    }
+
+    void InstanceBatches::render(bool transparent) const
+    {
+        m_buffer.bind();
+        // Without bindless textures every group has to bind the textures of its material.
+        if ((transparent ? m_transparent_indirect : m_opaque_indirect) && Texture::bindless_supported()) {
+            if (transparent)
+                multi_draw(m_first_transparent_command, m_commands.size() - m_first_transparent_command);
+            else
+                multi_draw(0, m_first_transparent_command);
+            return;
+        }
+        for (auto const& group : m_groups) {
+            if (group.material->transparent() != transparent)
+                continue;
+            group.material->use();
+            render_group(group);
+        }
+    }
+
+    void InstanceBatches::render_depth() const
+    {
+        m_buffer.bind();
+        if (m_opaque_indirect && m_transparent_indirect) {
+            multi_draw(0, m_commands.size());
+            return;
+        }
+        for (auto const& group : m_groups)
+            render_group(group);
+    }
+
+    std::uint32_t InstanceBatches::new_group(Model const& model, Material const& material)
+    {
+        m_groups.push_back({&model, &material});
+        return m_groups.size() - 1;
+    }
+
+    void InstanceBatches::add_commands(bool transparent)
+    {
+        bool& indirect = transparent ? m_transparent_indirect : m_opaque_indirect;
+        indirect = true;
+        for (auto& group : m_groups) {
+            if (group.material->transparent() != transparent)
+                continue;
+            auto const& meshes = group.model->get_meshes();
+            group.first_command = m_commands.size();
+            group.command_count = 0;
+            // Meshes that were created while the arena was disabled have their own vertex arrays.
+            if (!std::all_of(meshes.begin(), meshes.end(), [](Mesh const& mesh) { return mesh.geometry_range().has_value(); })) {
+                indirect = false;
+                continue;
+            }
+            for (auto const& mesh : meshes)
+                m_commands.push_back(mesh.geometry_range()->command(group.instance_count, group.first_instance));
+            group.command_count = meshes.size();
+        }
+    }
+
+    void InstanceBatches::render_group(Group const& group) const
+    {
+        if (group.command_count > 0) {
+            multi_draw(group.first_command, group.command_count);
+            return;
+        }
+        for (auto const& mesh : group.model->get_meshes())
+            mesh.render(group.instance_count, group.first_instance);
+    }
+
+    void InstanceBatches::multi_draw(std::size_t first_command, std::size_t command_count) const
+    {
+        if (command_count == 0)
+            return;
+        GeometryArena::bind();
+        m_command_buffer.bind();
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<void const*>(first_command * sizeof(DrawElementsIndirectCommand)), command_count, 0);
+    }
+
+}
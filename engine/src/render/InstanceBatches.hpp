@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include "render/Forward.hpp"
+#include "render/GeometryArena.hpp"
+#include "render/ShaderBuffer.hpp"
+#include "render/ShaderData.hpp"
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Groups the models of a pass by model and material, so that every mesh of a group is drawn with a single
+     * instanced draw call.
+     *
+     * The world matrices and material indices of the instances are streamed into a shader storage buffer, which the
+     * shaders index with gl_BaseInstance + gl_InstanceID. The meshes in the GeometryArena are drawn with indirect
+     * draws, whole passes at once if the materials don't have to be bound. The models and materials have to outlive the
+     * batches.
+     */
+    class InstanceBatches {
+    public:
+        /**
+         * @brief Removes all instances but keeps the allocated memory.
+         */
+        void clear();
+        /**
+         * @brief Adds an instance to the group of the model and material.
+         * @param material nullptr for the embedded material of the model
+         */
+        void add(Model const& model, Material const* material, glm::mat4 const& matrix);
+        /**
+         * @brief Adds an instance that is drawn after all instances that were added before, e.g. for sorted transparent
+         * models. Only merged with the group of the previous instance.
+         */
+        void add_ordered(Model const& model, Material const* material, glm::mat4 const& matrix);
+        /**
+         * @brief Uploads the instances. Has to be called after adding the instances and before drawing them.
+         */
+        void upload();
+
+        /**
+         * @brief Draws the groups whose material has the given transparency with their materials.
+         */
+        void render(bool transparent) const;
+        /**
+         * @brief Draws all groups without binding any materials, e.g. into a shadow map.
+         */
+        void render_depth() const;
+
+        [[nodiscard]] std::size_t group_count() const { return m_groups.size(); }
+        [[nodiscard]] std::size_t instance_count() const { return m_instances.size(); }
+        [[nodiscard]] std::size_t command_count() const { return m_commands.size(); }
+
+    private:
+        struct Group {
+            Model const* model;
+            Material const* material;
+            std::uint32_t first_instance = 0;
+            std::uint32_t instance_count = 0;
+            std::uint32_t material_index = 0;
+            // Commands of the meshes, only if all of them are in the GeometryArena
+            std::uint32_t first_command = 0;
+            std::uint32_t command_count = 0;
+        };
+
+        struct Instance {
+            std::uint32_t group;
+            glm::mat4 matrix;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(std::pair<Model const*, Material const*> const& key) const
+            {
+                return std::hash<Model const*>()(key.first) ^ (std::hash<Material const*>()(key.second) * 31);
+            }
+        };
+
+        std::vector<Group> m_groups;
+        std::unordered_map<std::pair<Model const*, Material const*>, std::uint32_t, KeyHash> m_group_indices;
+        std::vector<Instance> m_instances;
+        std::vector<InstanceData> m_instance_data;
+        ShaderBuffer m_buffer{GL_SHADER_STORAGE_BUFFER, BufferBinding::INSTANCES};
+        // The commands of the opaque groups come before the ones of the transparent groups.
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        std::size_t m_first_transparent_command = 0;
+        ShaderBuffer m_command_buffer{GL_DRAW_INDIRECT_BUFFER};
+        // Whether the commands cover all meshes of the opaque or transparent groups
+        bool m_opaque_indirect = true;
+        bool m_transparent_indirect = true;
+
+        std::uint32_t new_group(Model const& model, Material const& material);
+        void add_commands(bool transparent);
+        void render_group(Group const& group) const;
+        void multi_draw(std::size_t first_command, std::size_t command_count) const;
+    };
+
+}
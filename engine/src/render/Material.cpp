@@ -1,9 +1,19 @@
 #include "render/Material.hpp"
 
-#include "render/Shader.hpp"
-
 namespace Birdy3d::render {
 
+    core::ResourceIdentifier const& Material::white_texture()
+    {
+        static core::ResourceIdentifier const id = "color::" + utils::Color::WHITE.to_string();
+        return id;
+    }
+
+    core::ResourceIdentifier const& Material::black_texture()
+    {
+        static core::ResourceIdentifier const id = "color::" + utils::Color::BLACK.to_string();
+        return id;
+    }
+
     void Material::diffuse_map(core::ResourceIdentifier const& id)
     {
         m_diffuse_map = id;
@@ -24,26 +34,34 @@ namespace Birdy3d::render {
         m_emissive_map = id;
     }
 
-    void Material::use(Shader const& shader) const
+    std::uint32_t Material::index() const
     {
-        shader.set_bool("material.diffuse_map_enabled", diffuse_map_enabled);
-        shader.set_vec4("material.diffuse_color", diffuse_color);
-        m_diffuse_map->bind(0);
-        shader.set_int("material.diffuse_map", 0);
+        MaterialData data{
+            .diffuse_color = diffuse_color,
+            .emissive_color = emissive_color,
+            .specular_value = specular_value,
+            .diffuse_map_enabled = diffuse_map_enabled,
+            .specular_map_enabled = specular_map_enabled,
+            .normal_map_enabled = normal_map_enabled,
+            .emissive_map_enabled = emissive_map_enabled,
+        };
+        if (Texture::bindless_supported()) {
+            data.diffuse_map = m_diffuse_map->bindless_handle();
+            data.specular_map = m_specular_map->bindless_handle();
+            data.normal_map = m_normal_map->bindless_handle();
+            data.emissive_map = m_emissive_map->bindless_handle();
+        }
+        return m_slot.write(data);
+    }
 
-        shader.set_bool("material.specular_map_enabled", specular_map_enabled);
-        shader.set_float("material.specular_value", specular_value);
+    void Material::use() const
+    {
+        if (Texture::bindless_supported())
+            return;
+        m_diffuse_map->bind(0);
         m_specular_map->bind(1);
-        shader.set_int("material.specular_map", 1);
-
-        shader.set_bool("material.normal_map_enabled", normal_map_enabled);
         m_normal_map->bind(2);
-        shader.set_int("material.normal_map", 2);
-
-        shader.set_bool("material.emissive_map_enabled", emissive_map_enabled);
-        shader.set_vec4("material.emissive_color", emissive_color);
         m_emissive_map->bind(3);
-        shader.set_int("material.emissive_map", 3);
     }
 
     bool Material::transparent() const
@@ -54,6 +72,19 @@ namespace Birdy3d::render {
             return diffuse_color.value.a < 1;
     }
 
+    bool Material::loading() const
+    {
+        return m_diffuse_map.loading() || m_specular_map.loading() || m_normal_map.loading() || m_emissive_map.loading();
+    }
+
+    void Material::loading_priority(float priority) const
+    {
+        m_diffuse_map.priority(priority);
+        m_specular_map.priority(priority);
+        m_normal_map.priority(priority);
+        m_emissive_map.priority(priority);
+    }
+
     void Material::serialize(serializer::Adapter& adapter)
     {
         adapter("diffuse_map_enabled", diffuse_map_enabled);
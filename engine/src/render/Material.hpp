@@ -2,6 +2,7 @@
 
 #include "core/Base.hpp"
 #include "core/ResourceManager.hpp"
+#include "render/MaterialTable.hpp"
 #include "render/Texture.hpp"
 #include "utils/serializer/Adapter.hpp"
 
@@ -24,16 +25,37 @@ namespace Birdy3d::render {
         utils::Color emissive_color = utils::Color::BLACK;
         void emissive_map(core::ResourceIdentifier const&);
 
-        void use(Shader const& shader) const;
+        /**
+         * @brief Writes the material to the MaterialTable if a value changed.
+         * @returns index of the material in the table
+         */
+        [[nodiscard]] std::uint32_t index() const;
+        /**
+         * @brief Binds the maps to the units 0 to 3. Does nothing if bindless textures are supported.
+         */
+        void use() const;
         [[nodiscard]] bool transparent() const;
+        /**
+         * @returns whether any of the maps is still being loaded
+         */
+        [[nodiscard]] bool loading() const;
+        /**
+         * @brief Changes the loading priority of the maps that are still being loaded.
+         */
+        void loading_priority(float priority) const;
 
         void serialize(serializer::Adapter&);
 
     private:
-        core::ResourceHandle<Texture> m_diffuse_map = core::ResourceManager::get_texture("color::" + utils::Color::WHITE.to_string());
-        core::ResourceHandle<Texture> m_specular_map = core::ResourceManager::get_texture("color::" + utils::Color::BLACK.to_string());
-        core::ResourceHandle<Texture> m_normal_map = core::ResourceManager::get_texture("color::" + utils::Color::WHITE.to_string());
-        core::ResourceHandle<Texture> m_emissive_map = core::ResourceManager::get_texture("color::" + utils::Color::BLACK.to_string());
+        core::ResourceHandle<Texture> m_diffuse_map = core::ResourceManager::get_texture(white_texture());
+        core::ResourceHandle<Texture> m_specular_map = core::ResourceManager::get_texture(black_texture());
+        core::ResourceHandle<Texture> m_normal_map = core::ResourceManager::get_texture(white_texture());
+        core::ResourceHandle<Texture> m_emissive_map = core::ResourceManager::get_texture(black_texture());
+        mutable MaterialSlot m_slot;
+
+        // Parsed once, so that creating a Material doesn't allocate.
+        static core::ResourceIdentifier const& white_texture();
+        static core::ResourceIdentifier const& black_texture();
 
         BIRDY3D_REGISTER_TYPE_DEC(Material);
     };
@@ -0,0 +1,85 @@
+#include "render/MaterialTable.hpp"
+
+namespace Birdy3d::render {
+
+    std::vector<MaterialData> MaterialTable::m_data;
+    std::vector<std::uint32_t> MaterialTable::m_free_indices;
+    std::unique_ptr<ShaderBuffer> MaterialTable::m_buffer;
+    std::size_t MaterialTable::m_used = 0;
+    std::size_t MaterialTable::m_uploaded_size = 0;
+
+    std::uint32_t MaterialTable::allocate()
+    {
+        if (!m_free_indices.empty()) {
+            auto index = m_free_indices.back();
+            m_free_indices.pop_back();
+            return index;
+        }
+        // Grows in large steps, because every growth uploads the whole table.
+        if (m_used == m_data.size())
+            m_data.resize(std::max<std::size_t>(64, m_data.size() * 2));
+        return m_used++;
+    }
+
+    void MaterialTable::free(std::uint32_t index)
+    {
+        if (index < m_used)
+            m_free_indices.push_back(index);
+    }
+
+    void MaterialTable::write(std::uint32_t index, MaterialData const& data)
+    {
+        if (index >= m_used)
+            return;
+        m_data[index] = data;
+        if (!m_buffer)
+            m_buffer = std::make_unique<ShaderBuffer>(GL_SHADER_STORAGE_BUFFER, BufferBinding::MATERIALS);
+        if (m_data.size() > m_uploaded_size) {
+            m_buffer->upload(m_data);
+            m_uploaded_size = m_data.size();
+            bind();
+        } else {
+            m_buffer->update(index * sizeof(MaterialData), &data, sizeof(MaterialData));
+        }
+    }
+
+    void MaterialTable::bind()
+    {
+        if (m_buffer)
+            m_buffer->bind();
+    }
+
+    void MaterialTable::cleanup()
+    {
+        m_buffer.reset();
+        m_uploaded_size = 0;
+    }
+
+    MaterialSlot::MaterialSlot(MaterialSlot const&) { }
+
+    MaterialSlot& MaterialSlot::operator=(MaterialSlot const& other)
+    {
+        // Keeps the own index, the data is written again on the next use.
+        if (this != &other)
+            m_data.reset();
+        return *this;
+    }
+
+    MaterialSlot::~MaterialSlot()
+    {
+        if (m_index)
+            MaterialTable::free(*m_index);
+    }
+
+    std::uint32_t MaterialSlot::write(MaterialData const& data)
+    {
+        if (!m_index)
+            m_index = MaterialTable::allocate();
+        if (data != m_data) {
+            MaterialTable::write(*m_index, data);
+            m_data = data;
+        }
+        return *m_index;
+    }
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include "render/ShaderBuffer.hpp"
+#include "render/ShaderData.hpp"
+#include <cstdint>
+#include <optional>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Shader storage buffer with the data of all materials. Draws only pass the index of their material.
+     *
+     * Indices stay valid until they are freed and are reused afterwards. Only used on the main thread.
+     */
+    class MaterialTable {
+    public:
+        static std::uint32_t allocate();
+        static void free(std::uint32_t index);
+        /**
+         * @brief Replaces the data at the index. Only the changed entry is uploaded unless the table grew.
+         */
+        static void write(std::uint32_t index, MaterialData const& data);
+        static void bind();
+        static void cleanup();
+        /// @returns amount of indices that are in use
+        static std::size_t size() { return m_used - m_free_indices.size(); }
+
+    private:
+        // Includes the entries that weren't allocated yet, so that the buffer doesn't grow with every allocation.
+        static std::vector<MaterialData> m_data;
+        static std::vector<std::uint32_t> m_free_indices;
+        static std::unique_ptr<ShaderBuffer> m_buffer;
+        // Indices below this were allocated at some point.
+        static std::size_t m_used;
+        // Entries that fit into the buffer, the whole table is uploaded again if it grew beyond that.
+        static std::size_t m_uploaded_size;
+    };
+
+    /**
+     * @brief Index in the MaterialTable that is freed with the slot. Copies get their own index.
+     */
+    class MaterialSlot {
+    public:
+        MaterialSlot() = default;
+        MaterialSlot(MaterialSlot const&);
+        MaterialSlot& operator=(MaterialSlot const&);
+        ~MaterialSlot();
+
+        /**
+         * @brief Allocates the index on first use and writes the data if it changed since the last call.
+         * @returns index of the material
+         */
+        std::uint32_t write(MaterialData const&);
+
+    private:
+        std::optional<std::uint32_t> m_index;
+        std::optional<MaterialData> m_data;
+    };
+
+}
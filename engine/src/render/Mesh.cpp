@@ -1,5 +1,6 @@
 #include "render/Mesh.hpp"
 
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include "render/Vertex.hpp"
 
@@ -19,12 +20,16 @@ namespace Birdy3d::render {
 
     void Mesh::setup()
     {
+        m_range = GeometryArena::allocate(vertices, indices);
+        if (m_range)
+            return;
+
         // generate vao, vbo and ebo
         glGenVertexArrays(1, &m_vao);
         glGenBuffers(1, &m_vbo);
         glGenBuffers(1, &m_ebo);
 
-        glBindVertexArray(m_vao);
+        RenderState::bind_vertex_array(m_vao);
 
         // load vertices into vbo
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -47,14 +52,16 @@ namespace Birdy3d::render {
         // vertex tangent coords
         glEnableVertexAttribArray(3);
         glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-
-        glBindVertexArray(0);
     }
 
     void Mesh::release()
     {
+        if (m_range) {
+            GeometryArena::free(*m_range);
+            m_range.reset();
+        }
         if (m_vao != 0) {
-            glDeleteVertexArrays(1, &m_vao);
+            RenderState::delete_vertex_array(m_vao);
             m_vao = 0;
         }
         if (m_vbo != 0) {
@@ -67,29 +74,30 @@ namespace Birdy3d::render {
         }
     }
 
-    void Mesh::render(Shader const& shader, Material const& material) const
+    void Mesh::render(std::size_t instance_count, std::uint32_t first_instance) const
     {
-        material.use(shader);
-
-        // draw mesh
-        glBindVertexArray(m_vao);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
-
-    void Mesh::render_depth() const
-    {
-        glBindVertexArray(m_vao);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        if (m_range) {
+            GeometryArena::bind();
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, m_range->index_count, GL_UNSIGNED_INT, reinterpret_cast<void*>(m_range->first_index * sizeof(unsigned int)), instance_count, m_range->first_vertex, first_instance);
+            return;
+        }
+        // Not unbound afterwards, so that drawing the mesh again doesn't have to bind it.
+        RenderState::bind_vertex_array(m_vao);
+        // The base instance is the offset into the instance buffer, see includes/instances.glsl.
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr, instance_count, first_instance);
     }
 
     void Mesh::render_wireframe() const
     {
-        glBindVertexArray(m_vao);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        RenderState::polygon_mode(GL_LINE);
+        if (m_range) {
+            GeometryArena::bind();
+            glDrawElementsBaseVertex(GL_TRIANGLES, m_range->index_count, GL_UNSIGNED_INT, reinterpret_cast<void*>(m_range->first_index * sizeof(unsigned int)), m_range->first_vertex);
+        } else {
+            RenderState::bind_vertex_array(m_vao);
+            glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        }
+        RenderState::polygon_mode(GL_FILL);
     }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "render/Forward.hpp"
+#include "render/GeometryArena.hpp"
 #include "render/Material.hpp"
 #include "render/Vertex.hpp"
 
@@ -19,31 +20,48 @@ namespace Birdy3d::render {
         Mesh& operator=(Mesh const&) = delete;
 
         Mesh(Mesh&& other)
-            : vertices(other.vertices)
-            , indices(other.indices)
+            : vertices(std::move(other.vertices))
+            , indices(std::move(other.indices))
             , m_vao(other.m_vao)
-            , m_vbo(other.m_vao)
+            , m_vbo(other.m_vbo)
             , m_ebo(other.m_ebo)
+            , m_range(other.m_range)
         {
             other.m_vao = 0;
             other.m_vbo = 0;
             other.m_ebo = 0;
+            other.m_range.reset();
         }
 
         Mesh& operator=(Mesh&& other)
         {
             if (this != &other) {
                 release();
+                vertices = std::move(other.vertices);
+                indices = std::move(other.indices);
+                m_vao = std::exchange(other.m_vao, 0);
+                m_vbo = std::exchange(other.m_vbo, 0);
+                m_ebo = std::exchange(other.m_ebo, 0);
+                m_range = std::exchange(other.m_range, std::nullopt);
             }
             return *this;
         }
 
-        void render(Shader const& shader, Material const& material) const;
-        void render_depth() const;
+        /**
+         * @brief Draws the instances of the bound instance buffer, starting at first_instance.
+         */
+        void render(std::size_t instance_count, std::uint32_t first_instance) const;
+        /**
+         * @brief Draws the wireframe once, for shaders that take the model matrix as uniform.
+         */
         void render_wireframe() const;
+        /// @returns location of the mesh in the GeometryArena, nullopt if the mesh has its own buffers
+        [[nodiscard]] std::optional<GeometryRange> const& geometry_range() const { return m_range; }
 
     private:
-        unsigned int m_vao, m_vbo, m_ebo;
+        // 0 if the mesh is in the GeometryArena
+        unsigned int m_vao = 0, m_vbo = 0, m_ebo = 0;
+        std::optional<GeometryRange> m_range;
 
         void setup();
         void release();
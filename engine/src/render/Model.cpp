@@ -1,7 +1,6 @@
 #include "render/Model.hpp"
 
 #include "core/Logger.hpp"
-#include "ecs/Entity.hpp"
 #include "render/Mesh.hpp"
 #include "render/Shader.hpp"
 #include "render/Texture.hpp"
@@ -9,13 +8,31 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <algorithm>
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        namespace uniforms {
+            UniformHandle const model{"model"};
+        }
+
+    }
+
     Model::Model(std::string const& path)
     {
         core::Logger::debug("Loading model: {}", path);
-        load(path);
+        auto importer = import(path);
+        if (!importer)
+            core::Logger::critical("Failed to load model '{}'", path);
+        load(path, *importer);
+        compute_bounding_box();
+    }
+
+    Model::Model(std::string const& path, Assimp::Importer const& importer)
+    {
+        load(path, importer);
         compute_bounding_box();
     }
 
@@ -31,52 +48,68 @@ namespace Birdy3d::render {
             m_meshes.push_back(std::move(mesh));
     }
 
-    void Model::render(ecs::Entity& entity, Material const* material, Shader const& shader, bool transparent) const
+    void Model::render_wireframe(glm::mat4 const& model, Shader const& shader) const
     {
-        if (material == nullptr)
-            material = &m_embedded_material;
-        glm::mat4 model = entity.transform.global_matrix();
-        shader.set_mat4("model", model);
+        shader.use();
+        shader.set_mat4(uniforms::model, model);
         for (auto const& m : m_meshes) {
-            if (transparent == material->transparent())
-                m.render(shader, *material);
+            m.render_wireframe();
         }
     }
 
-    void Model::render_depth(ecs::Entity& entity, Shader const& shader) const
+    std::vector<Mesh> const& Model::get_meshes() const
     {
-        glm::mat4 model = entity.transform.global_matrix();
-        shader.use();
-        shader.set_mat4("model", model);
-        for (auto const& m : m_meshes) {
-            m.render_depth();
-        }
+        return m_meshes;
     }
 
-    void Model::render_wireframe(ecs::Entity const& entity, Shader const& shader) const
+    std::size_t Model::memory_size() const
     {
-        glm::mat4 model = entity.transform.global_matrix();
-        shader.use();
-        shader.set_mat4("model", model);
-        for (auto const& m : m_meshes) {
-            m.render_wireframe();
-        }
+        std::size_t size = 0;
+        for (auto const& mesh : m_meshes)
+            size += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int);
+        return size;
     }
 
-    std::vector<Mesh> const& Model::get_meshes() const
+    std::shared_ptr<Assimp::Importer> Model::import(std::string const& path)
     {
-        return m_meshes;
+        auto importer = std::make_shared<Assimp::Importer>();
+        aiScene const* scene = importer->ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals | aiProcess_RemoveRedundantMaterials | aiProcess_FindInvalidData | aiProcess_GenUVCoords | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices);
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            core::Logger::error("ASSIMP error: {}", importer->GetErrorString());
+            return nullptr;
+        }
+        return importer;
     }
 
-    void Model::load(std::string path)
+    std::vector<std::string> Model::texture_paths(std::string const& path, Assimp::Importer const& importer)
     {
-        Assimp::Importer importer;
-        aiScene const* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals | aiProcess_RemoveRedundantMaterials | aiProcess_FindInvalidData | aiProcess_GenUVCoords | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices);
+        std::vector<std::string> paths;
+        aiScene const* scene = importer.GetScene();
+        if (!scene)
+            return paths;
+        auto directory = path.substr(0, path.find_last_of('/'));
+
+        for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+            aiMaterial* material = scene->mMaterials[scene->mMeshes[i]->mMaterialIndex];
+            for (auto type : {aiTextureType_DIFFUSE, aiTextureType_SPECULAR, aiTextureType_NORMALS, aiTextureType_EMISSIVE}) {
+                if (material->GetTextureCount(type) == 0)
+                    continue;
+                aiString texture_path;
+                material->GetTexture(type, 0, &texture_path);
+                auto full_path = directory + "/" + texture_path.C_Str();
+                if (std::find(paths.begin(), paths.end(), full_path) == paths.end())
+                    paths.push_back(full_path);
+            }
+        }
+        return paths;
+    }
 
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            core::Logger::critical("ASSIMP error: {}", importer.GetErrorString());
+    void Model::load(std::string const& path, Assimp::Importer const& importer)
+    {
+        aiScene const* scene = importer.GetScene();
+        if (!scene)
             return;
-        }
         m_directory = path.substr(0, path.find_last_of('/'));
 
         process_node(scene->mRootNode, scene, glm::mat4{1.0f});
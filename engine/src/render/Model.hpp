@@ -1,7 +1,6 @@
 #pragma once
 
 #include "core/Base.hpp"
-#include "ecs/Forward.hpp"
 #include "render/Material.hpp"
 #include "render/Mesh.hpp"
 
@@ -9,18 +8,44 @@ struct aiMesh;
 struct aiNode;
 struct aiScene;
 
+namespace Assimp {
+    class Importer;
+}
+
 namespace Birdy3d::render {
 
     class Model {
     public:
         Model(std::string const& path);
+        /**
+         * @brief Creates the model from a file that was already imported with import().
+         *
+         * This allows the expensive import to happen on a loading thread.
+         */
+        Model(std::string const& path, Assimp::Importer const&);
         Model(Mesh);
         Model(std::vector<Mesh>&);
-        void render(ecs::Entity& entity, Material const* material, Shader const& shader, bool transparent) const;
-        void render_depth(ecs::Entity&, Shader const&) const;
-        void render_wireframe(ecs::Entity const&, Shader const&) const;
+        void render_wireframe(glm::mat4 const& model, Shader const&) const;
         [[nodiscard]] std::vector<Mesh> const& get_meshes() const;
+        /// @returns the material from the model file, used if a ModelComponent doesn't set one
+        [[nodiscard]] Material const& embedded_material() const { return m_embedded_material; }
         [[nodiscard]] std::pair<glm::vec3, glm::vec3> bounding_box() const { return m_bounding_box; }
+        /// @returns size of the vertex and index data in bytes
+        [[nodiscard]] std::size_t memory_size() const;
+
+        /**
+         * @brief Reads and post-processes a model file. Doesn't use OpenGL, so it can be called from any thread.
+         * @returns the importer that owns the imported scene or nullptr on failure
+         */
+        static std::shared_ptr<Assimp::Importer> import(std::string const& path);
+
+        /**
+         * @brief Lists the textures the embedded material of an imported model will use.
+         *
+         * This allows loading the textures while the meshes are created.
+         * @returns texture paths in the form they are passed to the material
+         */
+        static std::vector<std::string> texture_paths(std::string const& path, Assimp::Importer const&);
 
     private:
         std::vector<Mesh> m_meshes;
@@ -28,7 +53,7 @@ namespace Birdy3d::render {
         Material m_embedded_material;
         std::pair<glm::vec3, glm::vec3> m_bounding_box;
 
-        void load(std::string path);
+        void load(std::string const& path, Assimp::Importer const&);
         void process_node(aiNode* node, aiScene const* scene, glm::mat4 parent_transform);
         Mesh process_mesh(aiMesh* mesh, aiScene const* scene, glm::mat4 transform);
         void compute_bounding_box();
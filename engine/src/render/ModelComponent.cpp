@@ -1,5 +1,11 @@
 #include "render/ModelComponent.hpp"
 
+#include "core/Application.hpp"
+#include "ecs/Entity.hpp"
+#include "ecs/Scene.hpp"
+#include "events/EventBus.hpp"
+#include "events/ResourceEvents.hpp"
+
 namespace Birdy3d::render {
 
     ModelComponent::ModelComponent()
@@ -13,26 +19,46 @@ namespace Birdy3d::render {
 
     void ModelComponent::start()
     {
-        if (!m_model)
+        if (!m_model && !m_model.loading())
             core::Logger::warn("No model specified");
+        if (entity->scene)
+            m_bounds_proxy = entity->scene->bounding_volumes().insert(this, ecs::BoundsLayer::MODELS, world_bounding_box());
+        // The bounds are only known once the model finished loading.
+        core::Application::event_bus->subscribe(this, &ModelComponent::on_resource_loaded);
     }
 
-    void ModelComponent::serialize(serializer::Adapter& adapter)
+    void ModelComponent::update()
     {
-        adapter("model", m_model);
-        adapter("material", material);
+        // Switching to a reloaded model may destroy the old one with its OpenGL objects, so it only happens here on
+        // the main thread. The bounds only peek at the model, because they are also updated by the simulation.
+        auto previous = m_model.peek();
+        if (m_model.ptr() != previous)
+            update_bounds();
+    }
+
+    void ModelComponent::cleanup()
+    {
+        core::Application::event_bus->unsubscribe(this, &ModelComponent::on_resource_loaded);
+        if (m_bounds_proxy && entity->scene)
+            entity->scene->bounding_volumes().remove(*m_bounds_proxy);
+        m_bounds_proxy.reset();
+    }
+
+    void ModelComponent::on_resource_loaded(events::ResourceLoadEvent const&)
+    {
+        update_bounds();
     }
 
-    void ModelComponent::render(Shader const& shader, bool transparent) const
+    void ModelComponent::update_bounds()
     {
-        if (m_model)
-            m_model->render(*entity, material.get(), shader, transparent);
+        if (m_bounds_proxy && entity->scene)
+            entity->scene->bounding_volumes().move(*m_bounds_proxy, world_bounding_box());
     }
 
-    void ModelComponent::render_depth(Shader const& shader) const
+    void ModelComponent::serialize(serializer::Adapter& adapter)
     {
-        if (m_model)
-            m_model->render_depth(*entity, shader);
+        adapter("model", m_model);
+        adapter("material", material);
     }
 
     core::ResourceHandle<Model> ModelComponent::model()
@@ -43,6 +69,21 @@ namespace Birdy3d::render {
     void ModelComponent::model(std::string const& name)
     {
         m_model = name;
+        update_bounds();
+    }
+
+    BoundingBox ModelComponent::world_bounding_box() const
+    {
+        auto matrix = entity->transform.global_matrix();
+        auto model = m_model.peek();
+        if (!model)
+            return {glm::vec3(matrix[3]), glm::vec3(0)};
+        if (model != m_world_bounding_box_model || matrix != m_world_bounding_box_matrix) {
+            m_world_bounding_box = BoundingBox::transformed(model->bounding_box(), matrix);
+            m_world_bounding_box_matrix = matrix;
+            m_world_bounding_box_model = model;
+        }
+        return m_world_bounding_box;
     }
 
     BIRDY3D_REGISTER_DERIVED_TYPE_DEF(ecs::Component, ModelComponent);
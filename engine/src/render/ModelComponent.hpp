@@ -1,7 +1,10 @@
 #pragma once
 
 #include "core/Base.hpp"
+#include "ecs/BoundingVolumeHierarchy.hpp"
 #include "ecs/Component.hpp"
+#include "events/Forward.hpp"
+#include "render/Frustum.hpp"
 #include "render/Material.hpp"
 #include "render/Model.hpp"
 
@@ -14,14 +17,31 @@ namespace Birdy3d::render {
         ModelComponent();
         ModelComponent(std::string const& name, std::shared_ptr<Material> material = {});
         void start() override;
+        void update() override;
+        void cleanup() override;
         void serialize(serializer::Adapter& adapter) override;
-        void render(Shader const& shader, bool transparent) const;
-        void render_depth(Shader const& shader) const;
         core::ResourceHandle<Model> model();
         void model(std::string const& name);
+        /**
+         * @brief Bounding box of the model in world space. Only recomputed if the transform or the model changed.
+         * Can be called from the simulation worker.
+         * @returns the box or an empty one at the origin of the entity if the model isn't loaded
+         */
+        [[nodiscard]] BoundingBox world_bounding_box() const;
+        /**
+         * @brief Moves the bounds in the BoundingVolumeHierarchy of the scene to the current transform and model.
+         */
+        void update_bounds();
 
     private:
         core::ResourceHandle<Model> m_model;
+        mutable BoundingBox m_world_bounding_box;
+        // State the cached box was computed for
+        mutable glm::mat4 m_world_bounding_box_matrix{0};
+        mutable Model const* m_world_bounding_box_model = nullptr;
+        std::optional<ecs::BoundingVolumeHierarchy::ProxyId> m_bounds_proxy;
+
+        void on_resource_loaded(events::ResourceLoadEvent const& event);
 
         BIRDY3D_REGISTER_DERIVED_TYPE_DEC(ecs::Component, ModelComponent);
     };
@@ -2,13 +2,24 @@
 
 #include "core/ResourceManager.hpp"
 #include "ecs/Entity.hpp"
-#include "ecs/Scene.hpp"
-#include "render/ModelComponent.hpp"
+#include "render/InstanceBatches.hpp"
+#include "render/RenderSnapshot.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        namespace uniforms {
+            UniformArray shadow_matrices{"shadow_matrices"};
+            UniformHandle const far_plane{"far_plane"};
+            UniformHandle const light_pos{"light_pos"};
+        }
+
+    }
+
     PointLight::PointLight(utils::Color color, float intensity_ambient, float intensity_diffuse, float linear, float quadratic, bool shadow_enabled)
         : color(color)
         , intensity_ambient(intensity_ambient)
@@ -24,8 +35,8 @@ namespace Birdy3d::render {
         // framebuffer
         glGenFramebuffers(1, &m_shadow_map_fbo);
         // shadow map
-        glGenTextures(1, &m_shadow_map);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_shadow_map);
+        glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_shadow_map);
+        RenderState::bind_texture(0, m_shadow_map);
         for (unsigned int i = 0; i < 6; i++)
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, shadow_width, shadow_height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
@@ -35,61 +46,58 @@ namespace Birdy3d::render {
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
         // bind framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, m_shadow_map_fbo);
+        RenderState::bind_framebuffer(m_shadow_map_fbo);
         glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_shadow_map, 0);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::bind_framebuffer(0);
     }
 
-    void PointLight::use(Shader const& light_shader, int id, int textureid)
+    PointLightData PointLight::use(int textureid, SnapshotTransform const& transform, InstanceBatches const& shadow_casters)
     {
         if (!m_shadow_map_updated) {
-            gen_shadow_map();
+            gen_shadow_map(transform, shadow_casters);
             m_shadow_map_updated = true;
         }
-        std::string name = "point_lights[" + std::to_string(id) + "].";
-        light_shader.use();
-        light_shader.set_bool(name + "shadow_enabled", shadow_enabled);
-        light_shader.set_vec3(name + "position", entity->transform.world_position());
-        light_shader.set_vec3(name + "ambient", color.value * intensity_ambient);
-        light_shader.set_vec3(name + "diffuse", color.value * intensity_diffuse);
-        light_shader.set_float(name + "linear", linear);
-        light_shader.set_float(name + "quadratic", quadratic);
-        glActiveTexture(GL_TEXTURE0 + textureid);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, m_shadow_map);
-        light_shader.set_int(name + "shadow_map", textureid);
-        light_shader.set_float(name + "far", m_far);
+        RenderState::bind_texture(textureid, m_shadow_map);
+
+        return {
+            .position = transform.position,
+            .shadow_enabled = shadow_enabled,
+            .ambient = color.value * intensity_ambient,
+            .linear = linear,
+            .diffuse = color.value * intensity_diffuse,
+            .quadratic = quadratic,
+            .far = m_far,
+        };
     }
 
-    void PointLight::gen_shadow_map()
+    void PointLight::gen_shadow_map(SnapshotTransform const& transform, InstanceBatches const& shadow_casters)
     {
-        glm::vec3 world_pos = entity->transform.world_position();
+        glm::vec3 world_pos = transform.position;
 
-        glViewport(0, 0, shadow_width, shadow_height);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_shadow_map_fbo);
+        RenderState::viewport(0, 0, shadow_width, shadow_height);
+        RenderState::bind_framebuffer(m_shadow_map_fbo);
         glClear(GL_DEPTH_BUFFER_BIT);
-        glCullFace(GL_FRONT);
-        glEnable(GL_DEPTH_TEST);
+        RenderState::cull_face(GL_FRONT);
+        RenderState::enable(GL_DEPTH_TEST);
 
         m_depth_shader->use();
         float aspect = (float)shadow_width / (float)shadow_height;
         float near = 1.0f;
         glm::mat4 shadow_proj = glm::perspective(glm::radians(90.0f), aspect, near, m_far);
 
-        m_depth_shader->set_mat4("shadow_matrices[0]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-        m_depth_shader->set_mat4("shadow_matrices[1]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-        m_depth_shader->set_mat4("shadow_matrices[2]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)));
-        m_depth_shader->set_mat4("shadow_matrices[3]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, -1.0)));
-        m_depth_shader->set_mat4("shadow_matrices[4]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
-        m_depth_shader->set_mat4("shadow_matrices[5]", shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0)));
-        m_depth_shader->set_float("far_plane", m_far);
-        m_depth_shader->set_vec3("light_pos", world_pos);
-        for (auto m : entity->scene->get_components<ModelComponent>(false, true)) {
-            m->render_depth(*m_depth_shader);
-        }
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[0], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[1], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[2], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)));
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[3], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, -1.0)));
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[4], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
+        m_depth_shader->set_mat4(uniforms::shadow_matrices[5], shadow_proj * glm::lookAt(world_pos, world_pos + glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0)));
+        m_depth_shader->set_float(uniforms::far_plane, m_far);
+        m_depth_shader->set_vec3(uniforms::light_pos, world_pos);
+        shadow_casters.render_depth();
 
-        glCullFace(GL_BACK);
+        RenderState::cull_face(GL_BACK);
     }
 
     void PointLight::start()
@@ -3,6 +3,7 @@
 #include "core/ResourceHandle.hpp"
 #include "ecs/Component.hpp"
 #include "render/Shader.hpp"
+#include "render/ShaderData.hpp"
 #include "utils/Color.hpp"
 
 namespace Birdy3d::render {
@@ -18,8 +19,13 @@ namespace Birdy3d::render {
 
         PointLight(utils::Color color = utils::Color::WHITE, float intensity_ambient = 1, float intensity_diffuse = 1, float linear = 0, float quadratic = 0, bool shadow_enabled = true);
         void setup_shadow_map();
-        void gen_shadow_map();
-        void use(Shader const& light_shader, int id, int textureid);
+        void gen_shadow_map(SnapshotTransform const&, InstanceBatches const& shadow_casters);
+        /**
+         * @brief Updates the shadow map if necessary and binds it to the texture unit.
+         * @param shadow_casters Models that are drawn into the shadow map, already uploaded
+         * @returns the data of the light for the shaders
+         */
+        PointLightData use(int textureid, SnapshotTransform const&, InstanceBatches const& shadow_casters);
         void start() override;
         void update() override;
         void serialize(serializer::Adapter&) override;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include "core/ResourceHandle.hpp"
+#include "physics/Forward.hpp"
+#include "render/Forward.hpp"
+#include "render/Frustum.hpp"
+#include <optional>
+#include <vector>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief World space placement of an entity at the time the snapshot was taken.
+     */
+    struct SnapshotTransform {
+        glm::mat4 matrix;
+        glm::vec3 position;
+        glm::vec3 forward;
+        glm::vec3 up;
+    };
+
+    struct SnapshotModel {
+        core::ResourceHandle<Model> model;
+        std::shared_ptr<Material> material;
+        glm::mat4 matrix;
+        // Distance to the camera
+        float distance;
+        BoundingBox bounds;
+    };
+
+    template <typename T>
+    struct SnapshotLight {
+        std::shared_ptr<T> light;
+        SnapshotTransform transform;
+    };
+
+    struct SnapshotCollider {
+        std::shared_ptr<physics::ColliderComponent> collider;
+        glm::mat4 matrix;
+    };
+
+    /**
+     * @brief Everything a Camera needs to render one frame, captured after the simulation of the frame.
+     *
+     * Rendering only reads the snapshot and never the transforms of the scene, so the scene can be simulated further
+     * while the snapshot is submitted.
+     */
+    struct RenderSnapshot {
+        SnapshotTransform camera;
+        glm::mat4 view;
+        glm::mat4 projection;
+        float fov;
+        float near;
+        float far;
+        float aspect;
+
+        std::vector<SnapshotModel> models;
+        std::vector<SnapshotLight<DirectionalLight>> directional_lights;
+        std::vector<SnapshotLight<PointLight>> point_lights;
+        std::vector<SnapshotLight<Spotlight>> spotlights;
+        // Only captured if BoolOption::SHOW_COLLIDERS is set
+        std::vector<SnapshotCollider> colliders;
+
+        // Bounding box of the selected entity in its local space and its world matrix
+        std::optional<std::pair<glm::vec3, glm::vec3>> outline;
+        glm::mat4 outline_matrix;
+
+        /**
+         * @brief Drops all captured objects but keeps the allocated memory.
+         */
+        void clear()
+        {
+            models.clear();
+            directional_lights.clear();
+            point_lights.clear();
+            spotlights.clear();
+            colliders.clear();
+            outline.reset();
+        }
+    };
+
+}
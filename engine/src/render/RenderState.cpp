@@ -0,0 +1,161 @@
+#include "render/RenderState.hpp"
+
+namespace Birdy3d::render {
+
+    namespace {
+
+        std::optional<std::size_t> capability_index(GLenum capability)
+        {
+            switch (capability) {
+            case GL_DEPTH_TEST:
+                return 0;
+            case GL_BLEND:
+                return 1;
+            case GL_CULL_FACE:
+                return 2;
+            case GL_SCISSOR_TEST:
+                return 3;
+            case GL_FRAMEBUFFER_SRGB:
+                return 4;
+            default:
+                return {};
+            }
+        }
+
+    }
+
+    std::array<std::optional<bool>, RenderState::CAPABILITY_COUNT> RenderState::m_capabilities;
+    std::optional<std::pair<GLenum, GLenum>> RenderState::m_blend_func;
+    std::optional<GLenum> RenderState::m_cull_face;
+    std::optional<GLenum> RenderState::m_polygon_mode;
+    std::optional<std::array<GLint, 4>> RenderState::m_viewport;
+    std::optional<GLuint> RenderState::m_program;
+    std::optional<GLuint> RenderState::m_vertex_array;
+    std::array<std::optional<GLuint>, RenderState::TEXTURE_UNIT_COUNT> RenderState::m_textures;
+    std::optional<GLuint> RenderState::m_framebuffer;
+    std::size_t RenderState::m_issued = 0;
+    std::size_t RenderState::m_skipped = 0;
+    RenderStateStats RenderState::m_stats;
+
+    void RenderState::enable(GLenum capability)
+    {
+        set_capability(capability, true);
+    }
+
+    void RenderState::disable(GLenum capability)
+    {
+        set_capability(capability, false);
+    }
+
+    void RenderState::set_capability(GLenum capability, bool enabled)
+    {
+        auto index = capability_index(capability);
+        if (index && !change(m_capabilities[index.value()], enabled))
+            return;
+        if (!index)
+            ++m_issued;
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+
+    void RenderState::blend_func(GLenum source, GLenum destination)
+    {
+        if (change(m_blend_func, std::pair{source, destination}))
+            glBlendFunc(source, destination);
+    }
+
+    void RenderState::cull_face(GLenum mode)
+    {
+        if (change(m_cull_face, mode))
+            glCullFace(mode);
+    }
+
+    void RenderState::polygon_mode(GLenum mode)
+    {
+        if (change(m_polygon_mode, mode))
+            glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+
+    void RenderState::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (change(m_viewport, std::array<GLint, 4>{x, y, width, height}))
+            glViewport(x, y, width, height);
+    }
+
+    void RenderState::use_program(GLuint program)
+    {
+        if (change(m_program, program))
+            glUseProgram(program);
+    }
+
+    void RenderState::bind_vertex_array(GLuint vertex_array)
+    {
+        if (change(m_vertex_array, vertex_array))
+            glBindVertexArray(vertex_array);
+    }
+
+    void RenderState::bind_texture(GLuint unit, GLuint texture)
+    {
+        if (unit >= TEXTURE_UNIT_COUNT) {
+            ++m_issued;
+            glBindTextureUnit(unit, texture);
+            return;
+        }
+        if (change(m_textures[unit], texture))
+            glBindTextureUnit(unit, texture);
+    }
+
+    void RenderState::bind_framebuffer(GLuint framebuffer)
+    {
+        if (change(m_framebuffer, framebuffer))
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+
+    void RenderState::delete_texture(GLuint texture)
+    {
+        glDeleteTextures(1, &texture);
+        for (auto& bound : m_textures) {
+            if (bound == texture)
+                bound = 0;
+        }
+    }
+
+    void RenderState::delete_vertex_array(GLuint vertex_array)
+    {
+        glDeleteVertexArrays(1, &vertex_array);
+        if (m_vertex_array == vertex_array)
+            m_vertex_array = 0;
+    }
+
+    void RenderState::delete_framebuffer(GLuint framebuffer)
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+        if (m_framebuffer == framebuffer)
+            m_framebuffer = 0;
+    }
+
+    void RenderState::invalidate()
+    {
+        m_capabilities.fill({});
+        m_blend_func.reset();
+        m_cull_face.reset();
+        m_polygon_mode.reset();
+        m_viewport.reset();
+        m_program.reset();
+        m_vertex_array.reset();
+        m_textures.fill({});
+        m_framebuffer.reset();
+    }
+
+    void RenderState::end_frame()
+    {
+        m_stats.issued = m_issued;
+        m_stats.skipped = m_skipped;
+        m_stats.total_skipped += m_skipped;
+        m_issued = 0;
+        m_skipped = 0;
+    }
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include <optional>
+
+namespace Birdy3d::render {
+
+    struct RenderStateStats {
+        // State changes that were passed to OpenGL in the last frame
+        std::size_t issued = 0;
+        // State changes that were skipped in the last frame, because the state was already set
+        std::size_t skipped = 0;
+        std::size_t total_skipped = 0;
+    };
+
+    /**
+     * @brief Cache of the OpenGL state that changes while rendering. Calls that wouldn't change anything are skipped.
+     *
+     * Only used on the main thread. Objects that may be bound have to be deleted through this class, because OpenGL
+     * unbinds them. State that is changed directly has to be forgotten with invalidate().
+     */
+    class RenderState {
+    public:
+        /**
+         * @param capability GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST or GL_FRAMEBUFFER_SRGB. Other
+         * capabilities aren't cached.
+         */
+        static void enable(GLenum capability);
+        static void disable(GLenum capability);
+        static void blend_func(GLenum source, GLenum destination);
+        static void cull_face(GLenum mode);
+        static void polygon_mode(GLenum mode);
+        static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        static void use_program(GLuint program);
+        static void bind_vertex_array(GLuint vertex_array);
+        /// @brief Binds the texture to the unit regardless of its target.
+        static void bind_texture(GLuint unit, GLuint texture);
+        /// @brief Binds the framebuffer for both drawing and reading.
+        static void bind_framebuffer(GLuint framebuffer);
+
+        static void delete_texture(GLuint texture);
+        static void delete_vertex_array(GLuint vertex_array);
+        static void delete_framebuffer(GLuint framebuffer);
+
+        /// @brief Forgets all cached state, so that the next call of every setter reaches OpenGL.
+        static void invalidate();
+        /// @brief Publishes the counts of the frame to stats() and starts counting the next one.
+        static void end_frame();
+        static RenderStateStats const& stats() { return m_stats; }
+
+    private:
+        static constexpr std::size_t CAPABILITY_COUNT = 5;
+        static constexpr std::size_t TEXTURE_UNIT_COUNT = 32;
+
+        // Unknown state is empty, so that it is always set.
+        static std::array<std::optional<bool>, CAPABILITY_COUNT> m_capabilities;
+        static std::optional<std::pair<GLenum, GLenum>> m_blend_func;
+        static std::optional<GLenum> m_cull_face;
+        static std::optional<GLenum> m_polygon_mode;
+        static std::optional<std::array<GLint, 4>> m_viewport;
+        static std::optional<GLuint> m_program;
+        static std::optional<GLuint> m_vertex_array;
+        static std::array<std::optional<GLuint>, TEXTURE_UNIT_COUNT> m_textures;
+        static std::optional<GLuint> m_framebuffer;
+
+        static std::size_t m_issued;
+        static std::size_t m_skipped;
+        static RenderStateStats m_stats;
+
+        static void set_capability(GLenum capability, bool enabled);
+
+        /// @returns whether the value differs from the cached one, which is then replaced
+        template <typename T>
+        static bool change(std::optional<T>& current, T const& value)
+        {
+            if (current == value) {
+                ++m_skipped;
+                return false;
+            }
+            current = value;
+            ++m_issued;
+            return true;
+        }
+    };
+
+}
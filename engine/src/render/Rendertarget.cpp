@@ -1,5 +1,7 @@
 #include "render/Rendertarget.hpp"
 
+#include "render/RenderState.hpp"
+
 namespace Birdy3d::render {
 
     std::shared_ptr<Rendertarget> Rendertarget::DEFAULT;
@@ -34,7 +36,7 @@ namespace Birdy3d::render {
 
     Rendertarget::~Rendertarget()
     {
-        glDeleteFramebuffers(1, &m_id);
+        RenderState::delete_framebuffer(m_id);
         if (m_rbo_depth != 0)
             glDeleteRenderbuffers(1, &m_rbo_depth);
     }
@@ -63,7 +65,7 @@ namespace Birdy3d::render {
         std::vector<GLenum> attachments;
 
         glGenFramebuffers(1, &m_id);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+        RenderState::bind_framebuffer(m_id);
 
         std::size_t color_attachment_id = 0;
         for (auto const& texture : m_textures) {
@@ -99,7 +101,7 @@ namespace Birdy3d::render {
         if (m_rbo_depth == 0)
             return;
 
-        glDeleteFramebuffers(1, &m_id);
+        RenderState::delete_framebuffer(m_id);
         glDeleteRenderbuffers(1, &m_rbo_depth);
         m_rbo_depth = 0;
         add_depth_rbo();
@@ -112,8 +114,8 @@ namespace Birdy3d::render {
             core::Logger::critical("Trying to bind uninitialized Framebuffer");
             return;
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, m_id);
-        glViewport(0, 0, m_width, m_height);
+        RenderState::bind_framebuffer(m_id);
+        RenderState::viewport(0, 0, m_width, m_height);
     }
 
 }
@@ -1,31 +1,398 @@
 #include "render/Shader.hpp"
 
+#include "core/Application.hpp"
 #include "core/Logger.hpp"
 #include "core/ResourceManager.hpp"
+#include "render/RenderState.hpp"
+#include "render/ShaderBuffer.hpp"
+#include "render/ShaderCache.hpp"
+#include "render/Texture.hpp"
+#include <filesystem>
 #include <fstream>
-#include <regex>
+#include <mutex>
+#include <set>
 
 namespace Birdy3d::render {
 
-    Shader::Shader(std::string const& name, std::map<std::string, std::string> params)
-        : m_name(name)
-        , m_params(params)
+    namespace {
+
+        std::string make_shader_header(bool bindless_textures)
+        {
+            std::string result = "#version 460 core\n";
+            // Extensions have to be enabled before any other code.
+            if (bindless_textures)
+                result += "#extension GL_ARB_bindless_texture : require\n#define BINDLESS_TEXTURES\n";
+            auto define = [&result](char const* name, BufferBinding binding) {
+                result += "#define " + std::string(name) + " " + std::to_string(static_cast<GLuint>(binding)) + "\n";
+            };
+            define("CAMERA_BINDING", BufferBinding::CAMERA);
+            define("MATERIALS_BINDING", BufferBinding::MATERIALS);
+            define("DIRECTIONAL_LIGHTS_BINDING", BufferBinding::DIRECTIONAL_LIGHTS);
+            define("SHADOW_CASCADES_BINDING", BufferBinding::SHADOW_CASCADES);
+            define("POINT_LIGHTS_BINDING", BufferBinding::POINT_LIGHTS);
+            define("SPOTLIGHTS_BINDING", BufferBinding::SPOTLIGHTS);
+            define("INSTANCES_BINDING", BufferBinding::INSTANCES);
+            return result;
+        }
+
+        // The header is part of the sources that ShaderCache::source_key() hashes, so the SPIR-V compiler builds both
+        // variants.
+        std::string const& shader_header(bool bindless_textures)
+        {
+            static std::string const headers[] = {make_shader_header(false), make_shader_header(true)};
+            return headers[bindless_textures];
+        }
+
+        // GL_KHR_parallel_shader_compile isn't part of the generated loader.
+        constexpr GLenum COMPLETION_STATUS_KHR = 0x91B1;
+
+        bool parallel_compile_supported()
+        {
+            static bool const supported = [] {
+                if (!glfwExtensionSupported("GL_KHR_parallel_shader_compile") && !glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+                    return false;
+                using MaxShaderCompilerThreads = void(APIENTRYP)(GLuint count);
+                auto max_threads = reinterpret_cast<MaxShaderCompilerThreads>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+                if (!max_threads)
+                    max_threads = reinterpret_cast<MaxShaderCompilerThreads>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+                // Lets the driver choose the amount of threads.
+                if (max_threads)
+                    max_threads(0xFFFFFFFF);
+                return true;
+            }();
+            return supported;
+        }
+
+        enum class LineKind {
+            TEXT,
+            INCLUDE,
+            TYPE,
+            PARAMETER,
+        };
+
+        /**
+         * @brief A directive or a run of consecutive source lines of a shader file.
+         */
+        struct ParsedLine {
+            LineKind kind;
+            // Source lines for TEXT, file name for INCLUDE, stage for TYPE and name for PARAMETER
+            std::string text;
+            // Default value of a PARAMETER
+            std::optional<std::string> value;
+            std::size_t line_number;
+        };
+
+        struct ParsedFile {
+            std::filesystem::file_time_type modified;
+            std::vector<ParsedLine> lines;
+        };
+
+        bool is_name_char(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        bool all_of(std::string_view string, bool (*predicate)(char))
+        {
+            return !string.empty() && std::all_of(string.begin(), string.end(), predicate);
+        }
+
+        /**
+         * @brief Splits "#keyword argument" into its parts. Directives have to start at the beginning of the line.
+         */
+        std::optional<ParsedLine> parse_directive(std::string_view line, std::size_t line_number)
+        {
+            if (!line.starts_with('#'))
+                return {};
+            auto space = line.find(' ');
+            if (space == std::string_view::npos)
+                return {};
+            auto keyword = line.substr(0, space);
+            auto argument = line.substr(space + 1);
+
+            if (keyword == "#include") {
+                if (!all_of(argument, [](char c) { return is_name_char(c) || c == '.' || c == '/'; }))
+                    return {};
+                return ParsedLine{LineKind::INCLUDE, std::string(argument), {}, line_number};
+            }
+
+            if (keyword == "#type") {
+                if (argument != "vertex" && argument != "geometry" && argument != "fragment")
+                    return {};
+                return ParsedLine{LineKind::TYPE, std::string(argument), {}, line_number};
+            }
+
+            if (keyword == "#parameter") {
+                auto separator = argument.find(' ');
+                auto name = argument.substr(0, separator);
+                if (!all_of(name, is_name_char))
+                    return {};
+                if (separator == std::string_view::npos)
+                    return ParsedLine{LineKind::PARAMETER, std::string(name), {}, line_number};
+                auto value = argument.substr(separator + 1);
+                if (!all_of(value, [](char c) { return is_name_char(c) || c == '.' || c == '"'; }))
+                    return {};
+                return ParsedLine{LineKind::PARAMETER, std::string(name), std::string(value), line_number};
+            }
+
+            return {};
+        }
+
+        std::shared_ptr<ParsedFile const> parse_file(std::string const& path, std::filesystem::file_time_type modified)
+        {
+            auto file = std::make_shared<ParsedFile>();
+            file->modified = modified;
+            auto content = core::ResourceManager::read_file(path);
+            std::string_view remaining = content;
+            std::size_t line_number = 1;
+            while (!remaining.empty()) {
+                auto end = remaining.find('\n');
+                auto line = remaining.substr(0, end);
+                remaining = end == std::string_view::npos ? std::string_view{} : remaining.substr(end + 1);
+
+                if (auto directive = parse_directive(line, line_number)) {
+                    file->lines.push_back(std::move(directive.value()));
+                } else {
+                    // Consecutive source lines are appended as one piece.
+                    if (file->lines.empty() || file->lines.back().kind != LineKind::TEXT)
+                        file->lines.push_back({LineKind::TEXT, {}, {}, line_number});
+                    file->lines.back().text.append(line).push_back('\n');
+                }
+                ++line_number;
+            }
+            return file;
+        }
+
+        /**
+         * @brief Returns the parsed file, reading it only if it changed since it was parsed last.
+         */
+        std::shared_ptr<ParsedFile const> cached_file(std::string const& path)
+        {
+            static std::mutex mutex;
+            static std::unordered_map<std::string, std::shared_ptr<ParsedFile const>> files;
+
+            std::error_code error;
+            auto modified = std::filesystem::last_write_time(path, error);
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                auto it = files.find(path);
+                if (!error && it != files.end() && it->second->modified == modified)
+                    return it->second;
+            }
+
+            // Parsed outside of the lock, so that other threads can preprocess in the meantime.
+            auto file = parse_file(path, modified);
+            std::lock_guard<std::mutex> lock{mutex};
+            files[path] = file;
+            return file;
+        }
+
+        ShaderSources expand_file(std::string const& name, std::map<std::string, std::string> const& params, std::set<std::string>& valid_param_names)
+        {
+            ShaderSources preprocessed_file;
+
+            std::string path = core::ResourceManager::get_resource_path(name, core::ResourceType::SHADER);
+            if (path.empty())
+                return preprocessed_file;
+            auto file = cached_file(path);
+
+            std::string* current_shader_source = nullptr;
+            for (auto const& line : file->lines) {
+                switch (line.kind) {
+                case LineKind::INCLUDE:
+                    preprocessed_file += expand_file(line.text, params, valid_param_names);
+                    break;
+                case LineKind::TYPE:
+                    if (line.text == "vertex") {
+                        current_shader_source = &preprocessed_file.vertex_shader;
+                    } else if (line.text == "geometry") {
+                        preprocessed_file.has_geometry_shader = true;
+                        current_shader_source = &preprocessed_file.geometry_shader;
+                    } else {
+                        current_shader_source = &preprocessed_file.fragment_shader;
+                    }
+                    *current_shader_source += "#line " + std::to_string(line.line_number + 1) + "\n";
+                    break;
+                case LineKind::PARAMETER: {
+                    valid_param_names.insert(line.text);
+                    auto param = params.find(line.text);
+                    auto value = param != params.end() ? param->second : line.value.value_or("");
+                    auto define = "#define " + line.text + " " + value + "\n";
+                    preprocessed_file.vertex_shader += define;
+                    preprocessed_file.geometry_shader += define;
+                    preprocessed_file.fragment_shader += define;
+                    break;
+                }
+                case LineKind::TEXT:
+                    if (current_shader_source)
+                        *current_shader_source += line.text;
+                    break;
+                }
+            }
+
+            return preprocessed_file;
+        }
+
+    }
+
+    ShaderSources Shader::preprocess(std::string const& name, std::map<std::string, std::string> const& params)
     {
-        PreprocessedSources shader_sources = preprocess_file(name);
+        return preprocess(name, params, Texture::bindless_supported());
+    }
 
-        for (auto const& param : m_params) {
-            auto it = std::find(m_valid_param_names.cbegin(), m_valid_param_names.cend(), param.first);
-            if (it == m_valid_param_names.cend())
+    ShaderSources Shader::preprocess(std::string const& name, std::map<std::string, std::string> const& params, bool bindless_textures)
+    {
+        std::set<std::string> valid_param_names;
+        ShaderSources shader_sources = expand_file(name, params, valid_param_names);
+
+        for (auto const& param : params) {
+            if (!valid_param_names.contains(param.first))
                 core::Logger::warn("Shader '{}': invalid parameter '{}'", name, param.first);
         }
 
+        auto const& header = shader_header(bindless_textures);
         if (!shader_sources.vertex_shader.empty())
-            shader_sources.vertex_shader.insert(0, "#version 460 core\n");
+            shader_sources.vertex_shader.insert(0, header);
         if (!shader_sources.geometry_shader.empty())
-            shader_sources.geometry_shader.insert(0, "#version 460 core\n");
+            shader_sources.geometry_shader.insert(0, header);
         if (!shader_sources.fragment_shader.empty())
-            shader_sources.fragment_shader.insert(0, "#version 460 core\n");
+            shader_sources.fragment_shader.insert(0, header);
+        return shader_sources;
+    }
+
+    Shader::Shader(std::string const& name, std::map<std::string, std::string> const& params)
+        : Shader(name, preprocess(name, params))
+    { }
+
+    Shader::Shader(std::string const& name, ShaderSources shader_sources, bool wait)
+        : m_name(name)
+        , m_id(0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (core::Application::option_bool(core::BoolOption::SHADER_CACHE)) {
+            m_cache_key = ShaderCache::key(shader_sources.vertex_shader, shader_sources.geometry_shader, shader_sources.fragment_shader);
+            m_id = ShaderCache::load(m_cache_key.value());
+            if (m_id != 0) {
+                reflect_uniforms();
+                ShaderCache::record(true, std::chrono::steady_clock::now() - start);
+                return;
+            }
+        }
+
+        if (load_spirv(shader_sources)) {
+            if (m_cache_key.has_value())
+                ShaderCache::store(m_cache_key.value(), m_id);
+            ShaderCache::record(false, std::chrono::steady_clock::now() - start);
+            return;
+        }
+
         compile(shader_sources);
+        m_compile_time = std::chrono::steady_clock::now() - start;
+        if (wait)
+            finish_linking();
+    }
+
+    bool Shader::load_spirv(ShaderSources const& shader_sources)
+    {
+        auto key = ShaderCache::source_key(shader_sources.vertex_shader, shader_sources.geometry_shader, shader_sources.fragment_shader);
+        auto path = core::ResourceManager::get_resource_dir() + fmt::format("../shaders/spirv/{:016x}", key);
+        std::vector<std::pair<GLenum, std::string>> stages{{GL_VERTEX_SHADER, ".vert.spv"}, {GL_FRAGMENT_SHADER, ".frag.spv"}};
+        if (shader_sources.has_geometry_shader)
+            stages.emplace_back(GL_GEOMETRY_SHADER, ".geom.spv");
+
+        // Only the common variants are compiled at build time, every other one is compiled from GLSL.
+        std::vector<std::string> binaries;
+        for (auto const& [type, extension] : stages) {
+            std::ifstream file(path + extension, std::ios::binary);
+            if (!file)
+                return false;
+            binaries.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        m_id = glCreateProgram();
+        bool failed = false;
+        for (std::size_t i = 0; i < stages.size(); ++i) {
+            GLuint shader = glCreateShader(stages[i].first);
+            glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, binaries[i].data(), binaries[i].size());
+            glSpecializeShader(shader, "main", 0, nullptr, nullptr);
+            GLint success = 0;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            failed = failed || !success;
+            glAttachShader(m_id, shader);
+            m_stages.push_back({shader, stages[i].first});
+        }
+        if (!failed) {
+            glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glLinkProgram(m_id);
+            GLint success = 0;
+            glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+            failed = !success;
+        }
+        for (auto const& stage : m_stages) {
+            glDetachShader(m_id, stage.id);
+            glDeleteShader(stage.id);
+        }
+        m_stages.clear();
+
+        // The setters need the names of the uniforms, which drivers don't have to keep for SPIR-V.
+        if (!failed)
+            failed = !reflect_uniforms();
+        if (failed) {
+            core::Logger::debug("falling back to GLSL for shader '{}'", m_name);
+            m_uniform_locations.clear();
+            glDeleteProgram(m_id);
+            m_id = 0;
+            return false;
+        }
+        return true;
+    }
+
+    Shader::~Shader()
+    {
+        for (auto const& stage : m_stages)
+            glDeleteShader(stage.id);
+        if (m_id != 0)
+            glDeleteProgram(m_id);
+    }
+
+    bool Shader::link_complete() const
+    {
+        if (m_stages.empty() || !parallel_compile_supported())
+            return true;
+        GLint complete = GL_FALSE;
+        glGetProgramiv(m_id, COMPLETION_STATUS_KHR, &complete);
+        return complete == GL_TRUE;
+    }
+
+    void Shader::finish_linking()
+    {
+        if (m_stages.empty())
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+        // The compile status is only queried now, so that the driver doesn't have to finish a stage early.
+        bool failed = false;
+        for (auto const& stage : m_stages)
+            failed = check_compile_errors(stage.id, stage.type) || failed;
+        if (!failed)
+            failed = check_compile_errors(m_id, 0);
+
+        for (auto const& stage : m_stages) {
+            glDetachShader(m_id, stage.id);
+            glDeleteShader(stage.id);
+        }
+        m_stages.clear();
+
+        if (failed) {
+            glDeleteProgram(m_id);
+            m_id = 0;
+        } else {
+            reflect_uniforms();
+            if (m_cache_key.has_value())
+                ShaderCache::store(m_cache_key.value(), m_id);
+        }
+        m_compile_time += std::chrono::steady_clock::now() - start;
+        ShaderCache::record(false, m_compile_time);
     }
 
     bool Shader::check_compile_errors(GLuint shader, GLenum type)
@@ -61,332 +428,372 @@ namespace Birdy3d::render {
         return false;
     }
 
-    Shader::PreprocessedSources Shader::preprocess_file(std::string name)
+    void Shader::compile(ShaderSources const& shader_sources)
     {
-        PreprocessedSources preprocessed_file;
+        // Nothing is queried here, so that the driver can compile and link in the background until finish_linking().
+        m_id = glCreateProgram();
+        m_stages.push_back({compile_stage(GL_VERTEX_SHADER, shader_sources.vertex_shader), GL_VERTEX_SHADER});
+        if (shader_sources.has_geometry_shader)
+            m_stages.push_back({compile_stage(GL_GEOMETRY_SHADER, shader_sources.geometry_shader), GL_GEOMETRY_SHADER});
+        m_stages.push_back({compile_stage(GL_FRAGMENT_SHADER, shader_sources.fragment_shader), GL_FRAGMENT_SHADER});
+        for (auto const& stage : m_stages)
+            glAttachShader(m_id, stage.id);
+        glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(m_id);
+    }
 
-        std::string path = core::ResourceManager::get_resource_path(name, core::ResourceType::SHADER);
-        if (path.empty())
-            return preprocessed_file;
+    GLuint Shader::compile_stage(GLenum type, std::string const& source)
+    {
+        GLuint shader = glCreateShader(type);
+        char const* source_string = source.c_str();
+        glShaderSource(shader, 1, &source_string, nullptr);
+        glCompileShader(shader);
+        return shader;
+    }
 
-        std::ifstream stream;
-        stream.open(path);
-
-        std::regex const regex_include("#include ([a-zA-Z0-9_./]+)");
-        std::regex const regex_type("#type (vertex|geometry|fragment)");
-        std::regex const regex_parameter_empty("#parameter ([a-zA-Z0-9_]+)");
-        std::regex const regex_parameter_default("#parameter ([a-zA-Z0-9_]+) ([a-zA-Z0-9_\".]+)");
-
-        std::string* current_shader_source = nullptr;
-        std::size_t line_number = 1;
-        for (std::string line; std::getline(stream, line); ++line_number) {
-            std::smatch matches;
-            if (std::regex_match(line, matches, regex_include)) {
-                auto include_name = matches[1];
-                preprocessed_file += preprocess_file(include_name);
+    bool Shader::reflect_uniforms()
+    {
+        bool complete = true;
+        GLint count = 0;
+        GLint max_length = 0;
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+        std::vector<char> buffer(max_length + 1);
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type;
+            glGetActiveUniform(m_id, i, buffer.size(), &length, &size, &type, buffer.data());
+            // Members of uniform blocks are set through their buffer and don't have a location.
+            GLuint index = i;
+            GLint block_index = -1;
+            glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block_index);
+            if (block_index != -1)
                 continue;
-            }
-
-            if (std::regex_match(line, matches, regex_type)) {
-                auto type_name = matches[1];
-                if (type_name == "vertex") {
-                    current_shader_source = &preprocessed_file.vertex_shader;
-                } else if (type_name == "geometry") {
-                    preprocessed_file.has_geometry_shader = true;
-                    current_shader_source = &preprocessed_file.geometry_shader;
-                } else if (type_name == "fragment") {
-                    current_shader_source = &preprocessed_file.fragment_shader;
-                } else {
-                    core::Logger::error("Shader preprocessing error in file '{}': invalid type '{}'", name, static_cast<std::string>(type_name));
-                    return {};
-                }
-                *current_shader_source += "#line " + std::to_string(line_number + 1) + "\n";
+            std::string name(buffer.data(), length);
+            GLint location = name.empty() ? -1 : glGetUniformLocation(m_id, name.c_str());
+            if (location < 0) {
+                complete = false;
                 continue;
             }
+            m_uniform_locations[name] = location;
 
-            if (std::regex_match(line, matches, regex_parameter_empty)) {
-                std::string parameter_name = matches[1];
-                m_valid_param_names.insert(parameter_name);
-                auto define = "#define " + parameter_name + " " + m_params[parameter_name] + "\n";
-                preprocessed_file.vertex_shader += define;
-                preprocessed_file.geometry_shader += define;
-                preprocessed_file.fragment_shader += define;
+            // Arrays are only reported as "name[0]", but every element can be set by its own name.
+            if (!name.ends_with("[0]"))
                 continue;
+            auto array_name = name.substr(0, name.size() - 3);
+            m_uniform_locations[array_name] = location;
+            for (GLint element = 1; element < size; ++element) {
+                auto element_name = array_name + "[" + std::to_string(element) + "]";
+                m_uniform_locations[element_name] = glGetUniformLocation(m_id, element_name.c_str());
             }
-
-            if (std::regex_match(line, matches, regex_parameter_default)) {
-                std::string parameter_name = matches[1];
-                std::string parameter_default = matches[2];
-                m_valid_param_names.insert(parameter_name);
-                auto define = (m_params.count(parameter_name) > 0) ? "#define " + parameter_name + " " + m_params[parameter_name] + "\n"
-                                                                   : "#define " + parameter_name + " " + parameter_default + "\n";
-                preprocessed_file.vertex_shader += define;
-                preprocessed_file.geometry_shader += define;
-                preprocessed_file.fragment_shader += define;
-                continue;
-            }
-
-            if (current_shader_source)
-                *current_shader_source += line + "\n";
         }
-
-        return preprocessed_file;
+        return complete;
     }
 
-    void Shader::compile(Shader::PreprocessedSources const& shader_sources)
+    GLint Shader::location(std::string_view name) const
     {
-        m_id = glCreateProgram();
-
-        GLuint vertex_shader = 0, geometry_shader = 0, fragment_shader = 0;
-
-        vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-        char const* vertex_source_string = shader_sources.vertex_shader.c_str();
-        glShaderSource(vertex_shader, 1, &vertex_source_string, nullptr);
-        glCompileShader(vertex_shader);
-        glAttachShader(m_id, vertex_shader);
-        if (check_compile_errors(vertex_shader, GL_VERTEX_SHADER)) {
-            glDeleteShader(vertex_shader);
-            glDeleteProgram(m_id);
-            m_id = 0;
-            return;
-        }
-
-        if (shader_sources.has_geometry_shader) {
-            geometry_shader = glCreateShader(GL_GEOMETRY_SHADER);
-            char const* geometry_source_string = shader_sources.geometry_shader.c_str();
-            glShaderSource(geometry_shader, 1, &geometry_source_string, nullptr);
-            glCompileShader(geometry_shader);
-            glAttachShader(m_id, geometry_shader);
-            if (check_compile_errors(geometry_shader, GL_GEOMETRY_SHADER)) {
-                if (geometry_shader) {
-                    glDeleteShader(geometry_shader);
-                    glDetachShader(m_id, vertex_shader);
-                }
-                glDeleteShader(vertex_shader);
-                glDeleteProgram(m_id);
-                m_id = 0;
-                return;
-            }
-        }
+        auto it = m_uniform_locations.find(name);
+        if (it == m_uniform_locations.end())
+            return -1;
+        return it->second;
+    }
 
-        fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-        char const* fragment_source_string = shader_sources.fragment_shader.c_str();
-        glShaderSource(fragment_shader, 1, &fragment_source_string, nullptr);
-        glCompileShader(fragment_shader);
-        glAttachShader(m_id, fragment_shader);
-        if (check_compile_errors(fragment_shader, GL_FRAGMENT_SHADER)) {
-            glDeleteShader(fragment_shader);
-            glDetachShader(m_id, vertex_shader);
-            glDeleteShader(vertex_shader);
-            if (geometry_shader) {
-                glDetachShader(m_id, geometry_shader);
-                glDeleteShader(geometry_shader);
-            }
-            glDeleteProgram(m_id);
-            m_id = 0;
-            return;
-        }
-        glLinkProgram(m_id);
-        if (check_compile_errors(m_id, 0)) {
-            glDetachShader(m_id, vertex_shader);
-            glDeleteShader(vertex_shader);
-            if (geometry_shader) {
-                glDetachShader(m_id, geometry_shader);
-                glDeleteShader(geometry_shader);
-            }
-            glDetachShader(m_id, fragment_shader);
-            glDeleteShader(fragment_shader);
-            glDeleteProgram(m_id);
-            m_id = 0;
-            return;
-        }
+    GLint Shader::location(UniformHandle uniform) const
+    {
+        // Locations are never negative, so this marks handles that weren't looked up yet.
+        constexpr GLint UNRESOLVED = -2;
+        if (uniform.id() >= m_handle_locations.size())
+            m_handle_locations.resize(uniform.id() + 1, UNRESOLVED);
+        auto& location = m_handle_locations[uniform.id()];
+        if (location == UNRESOLVED)
+            location = this->location(uniform.name());
+        return location;
+    }
 
-        glDetachShader(m_id, vertex_shader);
-        glDeleteShader(vertex_shader);
-        if (geometry_shader) {
-            glDetachShader(m_id, geometry_shader);
-            glDeleteShader(geometry_shader);
-        }
-        glDetachShader(m_id, fragment_shader);
-        glDeleteShader(fragment_shader);
+    std::size_t Shader::memory_size() const
+    {
+        if (m_id == 0)
+            return 0;
+        GLint length = 0;
+        glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+        return length;
     }
 
     void Shader::use() const
     {
         if (!check_program_valid())
             return;
-        glUseProgram(m_id);
+        RenderState::use_program(m_id);
     }
 
     void Shader::set_bool(char const* name, bool value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1i(m_id, glGetUniformLocation(m_id, name), (int)value);
+        glProgramUniform1i(m_id, location(name), (int)value);
     }
 
     void Shader::set_int(char const* name, int value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1i(m_id, glGetUniformLocation(m_id, name), value);
+        glProgramUniform1i(m_id, location(name), value);
     }
 
     void Shader::set_float(char const* name, float value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1f(m_id, glGetUniformLocation(m_id, name), value);
+        glProgramUniform1f(m_id, location(name), value);
     }
 
     void Shader::set_vec2(char const* name, glm::vec2 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform2fv(m_id, glGetUniformLocation(m_id, name), 1, &value[0]);
+        glProgramUniform2fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec2(char const* name, float x, float y) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform2f(m_id, glGetUniformLocation(m_id, name), x, y);
+        glProgramUniform2f(m_id, location(name), x, y);
     }
 
     void Shader::set_vec3(char const* name, glm::vec3 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform3fv(m_id, glGetUniformLocation(m_id, name), 1, &value[0]);
+        glProgramUniform3fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec3(char const* name, float x, float y, float z) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform3f(m_id, glGetUniformLocation(m_id, name), x, y, z);
+        glProgramUniform3f(m_id, location(name), x, y, z);
     }
 
     void Shader::set_vec4(char const* name, glm::vec4 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform4fv(m_id, glGetUniformLocation(m_id, name), 1, &value[0]);
+        glProgramUniform4fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec4(char const* name, float x, float y, float z, float w) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform4f(m_id, glGetUniformLocation(m_id, name), x, y, z, w);
+        glProgramUniform4f(m_id, location(name), x, y, z, w);
     }
 
     void Shader::set_mat2(char const* name, glm::mat2 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix2fv(m_id, glGetUniformLocation(m_id, name), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix2fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::set_mat3(char const* name, glm::mat3 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix3fv(m_id, glGetUniformLocation(m_id, name), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix3fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::set_mat4(char const* name, glm::mat4 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix4fv(m_id, glGetUniformLocation(m_id, name), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix4fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::set_bool(std::string const& name, bool value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1i(m_id, glGetUniformLocation(m_id, name.c_str()), (int)value);
+        glProgramUniform1i(m_id, location(name), (int)value);
     }
 
     void Shader::set_int(std::string const& name, int value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1i(m_id, glGetUniformLocation(m_id, name.c_str()), value);
+        glProgramUniform1i(m_id, location(name), value);
     }
 
     void Shader::set_float(std::string const& name, float value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform1f(m_id, glGetUniformLocation(m_id, name.c_str()), value);
+        glProgramUniform1f(m_id, location(name), value);
     }
 
     void Shader::set_vec2(std::string const& name, glm::vec2 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform2fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+        glProgramUniform2fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec2(std::string const& name, float x, float y) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform2f(m_id, glGetUniformLocation(m_id, name.c_str()), x, y);
+        glProgramUniform2f(m_id, location(name), x, y);
     }
 
     void Shader::set_vec3(std::string const& name, glm::vec3 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform3fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+        glProgramUniform3fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec3(std::string const& name, float x, float y, float z) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform3f(m_id, glGetUniformLocation(m_id, name.c_str()), x, y, z);
+        glProgramUniform3f(m_id, location(name), x, y, z);
     }
 
     void Shader::set_vec4(std::string const& name, glm::vec4 const& value) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform4fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+        glProgramUniform4fv(m_id, location(name), 1, &value[0]);
     }
 
     void Shader::set_vec4(std::string const& name, float x, float y, float z, float w) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniform4f(m_id, glGetUniformLocation(m_id, name.c_str()), x, y, z, w);
+        glProgramUniform4f(m_id, location(name), x, y, z, w);
     }
 
     void Shader::set_mat2(std::string const& name, glm::mat2 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix2fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix2fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::set_mat3(std::string const& name, glm::mat3 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix3fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix3fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::set_mat4(std::string const& name, glm::mat4 const& mat) const
     {
         if (!check_program_valid())
             return;
-        glProgramUniformMatrix4fv(m_id, glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glProgramUniformMatrix4fv(m_id, location(name), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void Shader::set_bool(UniformHandle uniform, bool value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform1i(m_id, location(uniform), (int)value);
+    }
+
+    void Shader::set_int(UniformHandle uniform, int value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform1i(m_id, location(uniform), value);
+    }
+
+    void Shader::set_float(UniformHandle uniform, float value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform1f(m_id, location(uniform), value);
+    }
+
+    void Shader::set_vec2(UniformHandle uniform, glm::vec2 const& value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform2fv(m_id, location(uniform), 1, &value[0]);
+    }
+
+    void Shader::set_vec2(UniformHandle uniform, float x, float y) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform2f(m_id, location(uniform), x, y);
+    }
+
+    void Shader::set_vec3(UniformHandle uniform, glm::vec3 const& value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform3fv(m_id, location(uniform), 1, &value[0]);
+    }
+
+    void Shader::set_vec3(UniformHandle uniform, float x, float y, float z) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform3f(m_id, location(uniform), x, y, z);
+    }
+
+    void Shader::set_vec4(UniformHandle uniform, glm::vec4 const& value) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform4fv(m_id, location(uniform), 1, &value[0]);
+    }
+
+    void Shader::set_vec4(UniformHandle uniform, float x, float y, float z, float w) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform4f(m_id, location(uniform), x, y, z, w);
+    }
+
+    void Shader::set_mat2(UniformHandle uniform, glm::mat2 const& mat) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniformMatrix2fv(m_id, location(uniform), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void Shader::set_mat3(UniformHandle uniform, glm::mat3 const& mat) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniformMatrix3fv(m_id, location(uniform), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void Shader::set_mat4(UniformHandle uniform, glm::mat4 const& mat) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniformMatrix4fv(m_id, location(uniform), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void Shader::set_float_array(UniformHandle uniform, std::span<float const> values) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniform1fv(m_id, location(uniform), values.size(), values.data());
+    }
+
+    void Shader::set_mat4_array(UniformHandle uniform, std::span<glm::mat4 const> mats) const
+    {
+        if (!check_program_valid())
+            return;
+        glProgramUniformMatrix4fv(m_id, location(uniform), mats.size(), GL_FALSE, &mats.data()[0][0][0]);
     }
 
-    void Shader::PreprocessedSources::operator+=(PreprocessedSources const& other)
+    void ShaderSources::operator+=(ShaderSources const& other)
     {
         vertex_shader += other.vertex_shader;
         geometry_shader += other.geometry_shader;
@@ -1,15 +1,63 @@
 #pragma once
 
 #include "core/Base.hpp"
-#include <set>
+#include "render/UniformHandle.hpp"
+#include <chrono>
+#include <optional>
+#include <span>
 
 namespace Birdy3d::render {
 
     // TODO: Create a single set_uniform template
 
+    /**
+     * @brief Sources of all stages of a shader after preprocessing.
+     */
+    struct ShaderSources {
+        std::string vertex_shader;
+        std::string geometry_shader;
+        std::string fragment_shader;
+        bool has_geometry_shader{false};
+
+        void operator+=(ShaderSources const&);
+    };
+
     class Shader {
     public:
-        Shader(std::string const& name, std::map<std::string, std::string> params);
+        /**
+         * @brief Resolves the includes, types and parameters of a shader file. Doesn't need the OpenGL context.
+         *
+         * Thread-safe. Parsed files are cached until they are modified, so the includes are only read once.
+         * @param name Shader file name
+         * @param params Values of the #parameter directives
+         * @returns the sources of all stages, empty if the file couldn't be read
+         */
+        static ShaderSources preprocess(std::string const& name, std::map<std::string, std::string> const& params);
+        /**
+         * @brief Like preprocess(), but with the header of the given driver configuration instead of the current one,
+         * e.g. to compile the variants for all drivers ahead of time.
+         * @param bindless_textures Whether the header enables GL_ARB_bindless_texture
+         */
+        static ShaderSources preprocess(std::string const& name, std::map<std::string, std::string> const& params, bool bindless_textures);
+
+        // The setters look locations up in a table that is filled once after linking. Unknown names are ignored.
+        // Use the UniformHandle overloads in hot paths to avoid hashing the name.
+        Shader(std::string const& name, std::map<std::string, std::string> const& params);
+        /**
+         * @brief Compiles sources returned by preprocess().
+         * @param wait Whether to block until the program is linked. Otherwise finish_linking() has to be called once
+         * link_complete() returns true, which lets the driver compile in the background.
+         */
+        Shader(std::string const& name, ShaderSources sources, bool wait = true);
+        Shader(Shader const&) = delete;
+        Shader& operator=(Shader const&) = delete;
+        ~Shader();
+
+        /// @returns whether the driver finished linking. Always true without GL_KHR_parallel_shader_compile.
+        [[nodiscard]] bool link_complete() const;
+        /// @brief Checks the result of a link that the constructor didn't wait for and deletes the program on errors.
+        void finish_linking();
+
         void use() const;
         void set_bool(char const* name, bool value) const;
         void set_int(char const* name, int value) const;
@@ -37,26 +85,64 @@ namespace Birdy3d::render {
         void set_mat3(std::string const& name, glm::mat3 const& mat) const;
         void set_mat4(std::string const& name, glm::mat4 const& mat) const;
 
+        void set_bool(UniformHandle uniform, bool value) const;
+        void set_int(UniformHandle uniform, int value) const;
+        void set_float(UniformHandle uniform, float value) const;
+        void set_vec2(UniformHandle uniform, glm::vec2 const& value) const;
+        void set_vec2(UniformHandle uniform, float x, float y) const;
+        void set_vec3(UniformHandle uniform, glm::vec3 const& value) const;
+        void set_vec3(UniformHandle uniform, float x, float y, float z) const;
+        void set_vec4(UniformHandle uniform, glm::vec4 const& value) const;
+        void set_vec4(UniformHandle uniform, float x, float y, float z, float w) const;
+        void set_mat2(UniformHandle uniform, glm::mat2 const& mat) const;
+        void set_mat3(UniformHandle uniform, glm::mat3 const& mat) const;
+        void set_mat4(UniformHandle uniform, glm::mat4 const& mat) const;
+        /// @brief Sets consecutive elements of an array, starting at the element of the handle.
+        void set_float_array(UniformHandle uniform, std::span<float const> values) const;
+        void set_mat4_array(UniformHandle uniform, std::span<glm::mat4 const> mats) const;
+
+        /// @returns size of the linked program binary in bytes
+        [[nodiscard]] std::size_t memory_size() const;
+        /// @returns whether the shader was compiled and linked successfully
+        [[nodiscard]] bool valid() const { return m_id != 0; }
+
     private:
-        struct PreprocessedSources {
-            std::string vertex_shader;
-            std::string geometry_shader;
-            std::string fragment_shader;
-            bool has_geometry_shader{false};
+        struct StringViewHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view string) const noexcept { return std::hash<std::string_view>{}(string); }
+        };
 
-            void operator+=(PreprocessedSources const&);
+        struct Stage {
+            GLuint id;
+            GLenum type;
         };
 
         std::string m_name;
-        std::map<std::string, std::string> m_params;
-        std::set<std::string> m_valid_param_names;
         GLuint m_id;
+        // Stages that are still attached while the program is linking
+        std::vector<Stage> m_stages;
+        std::optional<std::uint64_t> m_cache_key;
+        std::chrono::nanoseconds m_compile_time{0};
         mutable bool m_printed_error = false;
+        // Locations of all active uniforms, including every element of arrays
+        std::unordered_map<std::string, GLint, StringViewHash, std::equal_to<>> m_uniform_locations;
+        // Locations indexed by UniformHandle::id(), filled on first use
+        mutable std::vector<GLint> m_handle_locations;
 
         bool check_compile_errors(GLuint shader, GLenum type);
-        PreprocessedSources preprocess_file(std::string name);
-        void compile(PreprocessedSources const& shader_sources);
+        // Loads the SPIR-V that was compiled at build time. Fails if the driver doesn't reflect the uniform names.
+        bool load_spirv(ShaderSources const& shader_sources);
+        void compile(ShaderSources const& shader_sources);
+        GLuint compile_stage(GLenum type, std::string const& source);
         [[nodiscard]] bool check_program_valid() const;
+        /**
+         * @brief Looks up the locations of all active uniforms outside of uniform blocks.
+         * @returns false if one of them has no name or no location, so that it can't be set by name
+         */
+        bool reflect_uniforms();
+        [[nodiscard]] GLint location(std::string_view name) const;
+        [[nodiscard]] GLint location(UniformHandle uniform) const;
     };
 
 }
@@ -0,0 +1,81 @@
+#include "render/ShaderBuffer.hpp"
+
+namespace Birdy3d::render {
+
+    ShaderBuffer::ShaderBuffer(GLenum target, BufferBinding binding)
+        : m_target(target)
+        , m_binding(binding)
+    { }
+
+    ShaderBuffer::ShaderBuffer(GLenum target)
+        : m_target(target)
+    { }
+
+    ShaderBuffer::ShaderBuffer(ShaderBuffer const& other)
+        : m_target(other.m_target)
+        , m_binding(other.m_binding)
+    { }
+
+    ShaderBuffer& ShaderBuffer::operator=(ShaderBuffer const& other)
+    {
+        if (this == &other)
+            return *this;
+        if (m_id != 0)
+            glDeleteBuffers(1, &m_id);
+        m_target = other.m_target;
+        m_binding = other.m_binding;
+        m_id = 0;
+        m_capacity = 0;
+        return *this;
+    }
+
+    ShaderBuffer::~ShaderBuffer()
+    {
+        if (m_id != 0)
+            glDeleteBuffers(1, &m_id);
+    }
+
+    void ShaderBuffer::upload(void const* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+        if (m_id == 0)
+            glCreateBuffers(1, &m_id);
+        if (size > m_capacity) {
+            glNamedBufferData(m_id, size, data, GL_DYNAMIC_DRAW);
+            m_capacity = size;
+        } else {
+            glNamedBufferSubData(m_id, 0, size, data);
+        }
+    }
+
+    void ShaderBuffer::stream(void const* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+        if (m_id == 0)
+            glCreateBuffers(1, &m_id);
+        // Orphans the old storage, the driver keeps it alive until the draws that use it finished.
+        m_capacity = std::max(size, m_capacity);
+        glNamedBufferData(m_id, m_capacity, nullptr, GL_STREAM_DRAW);
+        glNamedBufferSubData(m_id, 0, size, data);
+    }
+
+    void ShaderBuffer::update(std::size_t offset, void const* data, std::size_t size)
+    {
+        if (m_id == 0 || offset + size > m_capacity)
+            return;
+        glNamedBufferSubData(m_id, offset, size, data);
+    }
+
+    void ShaderBuffer::bind() const
+    {
+        if (m_id == 0)
+            return;
+        if (m_binding)
+            glBindBufferBase(m_target, static_cast<GLuint>(*m_binding), m_id);
+        else
+            glBindBuffer(m_target, m_id);
+    }
+
+}
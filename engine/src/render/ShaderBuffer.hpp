@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include <optional>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Binding points of the buffers that are shared by all shaders.
+     *
+     * Shaders see them as CAMERA_BINDING, MATERIALS_BINDING, ... so the blocks in the GLSL code can't get out of sync.
+     */
+    enum class BufferBinding : GLuint {
+        CAMERA = 0,
+        MATERIALS = 1,
+        DIRECTIONAL_LIGHTS = 2,
+        SHADOW_CASCADES = 3,
+        POINT_LIGHTS = 4,
+        SPOTLIGHTS = 5,
+        INSTANCES = 6,
+    };
+
+    /**
+     * @brief Uniform or shader storage buffer that is bound to a fixed binding point, or a buffer of a target without
+     * binding points like GL_DRAW_INDIRECT_BUFFER.
+     *
+     * The OpenGL buffer is created on the first upload, so the owner can be constructed outside of the main thread.
+     * Copies don't share the OpenGL buffer, they create their own one on their first upload.
+     */
+    class ShaderBuffer {
+    public:
+        /**
+         * @param target GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+         */
+        ShaderBuffer(GLenum target, BufferBinding binding);
+        /**
+         * @param target Target without indexed binding points, e.g. GL_DRAW_INDIRECT_BUFFER
+         */
+        explicit ShaderBuffer(GLenum target);
+        ShaderBuffer(ShaderBuffer const&);
+        ShaderBuffer& operator=(ShaderBuffer const&);
+        ~ShaderBuffer();
+
+        /**
+         * @brief Replaces the content of the buffer. Grows the buffer if necessary, but never shrinks it.
+         */
+        void upload(void const* data, std::size_t size);
+
+        /**
+         * @brief Overwrites a part of the buffer, which has to be large enough already.
+         */
+        void update(std::size_t offset, void const* data, std::size_t size);
+
+        template <typename T>
+        void upload(std::vector<T> const& data)
+        {
+            upload(data.data(), data.size() * sizeof(T));
+        }
+
+        /**
+         * @brief Replaces the content with new storage, so that draws that still read the previous content don't
+         * have to finish first. For data that is rewritten several times per frame.
+         */
+        void stream(void const* data, std::size_t size);
+
+        template <typename T>
+        void stream(std::vector<T> const& data)
+        {
+            stream(data.data(), data.size() * sizeof(T));
+        }
+
+        /**
+         * @brief Binds the buffer to its binding point or target. Does nothing if nothing was uploaded yet.
+         */
+        void bind() const;
+
+    private:
+        GLenum m_target;
+        std::optional<BufferBinding> m_binding;
+        GLuint m_id = 0;
+        std::size_t m_capacity = 0;
+    };
+
+}
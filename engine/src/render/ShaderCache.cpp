@@ -0,0 +1,183 @@
+#include "render/ShaderCache.hpp"
+
+#include "core/Logger.hpp"
+#include "core/ResourceManager.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+namespace Birdy3d::render {
+
+    namespace {
+
+        constexpr std::array<char, 8> MAGIC{'B', '3', 'D', 'P', 'R', 'O', 'G', '1'};
+
+        struct BinaryHeader {
+            std::array<char, 8> magic;
+            std::uint64_t key;
+            std::uint32_t format;
+            std::uint32_t length;
+        };
+
+        // 64-bit FNV-1a, stable across runs unlike std::hash
+        std::uint64_t hash_bytes(std::string_view bytes, std::uint64_t hash = 14695981039346656037ull)
+        {
+            for (unsigned char c : bytes) {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::uint64_t hash_sources(std::string_view vertex, std::string_view geometry, std::string_view fragment, std::uint64_t hash)
+        {
+            // The sizes keep e.g. moving a line from one stage to the next from producing the same key.
+            for (auto source : {vertex, geometry, fragment}) {
+                hash = hash_bytes(std::to_string(source.size()) + '\n', hash);
+                hash = hash_bytes(source, hash);
+            }
+            return hash;
+        }
+
+        std::string const& driver_string()
+        {
+            static std::string const driver = [] {
+                std::string result;
+                for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+                    if (auto string = glGetString(name))
+                        result += reinterpret_cast<char const*>(string);
+                    result += '\n';
+                }
+                return result;
+            }();
+            return driver;
+        }
+
+        bool binaries_supported()
+        {
+            static bool const supported = [] {
+                GLint formats = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+                return formats > 0;
+            }();
+            return supported;
+        }
+
+    }
+
+    ShaderCacheStats ShaderCache::m_stats;
+
+    std::uint64_t ShaderCache::key(std::string_view vertex, std::string_view geometry, std::string_view fragment)
+    {
+        return hash_sources(vertex, geometry, fragment, hash_bytes(driver_string()));
+    }
+
+    std::uint64_t ShaderCache::source_key(std::string_view vertex, std::string_view geometry, std::string_view fragment)
+    {
+        return hash_sources(vertex, geometry, fragment, hash_bytes({}));
+    }
+
+    GLuint ShaderCache::load(std::uint64_t key)
+    {
+        if (!binaries_supported())
+            return 0;
+
+        auto path = directory() + fmt::format("{:016x}.bin", key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return 0;
+
+        BinaryHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.magic != MAGIC || header.key != key)
+            return 0;
+        std::vector<char> binary(header.length);
+        file.read(binary.data(), binary.size());
+        if (!file)
+            return 0;
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), binary.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            // Happens after driver updates that the driver string doesn't reflect.
+            core::Logger::debug("discarding rejected program binary '{}'", path);
+            glDeleteProgram(program);
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            return 0;
+        }
+        return program;
+    }
+
+    void ShaderCache::store(std::uint64_t key, GLuint program)
+    {
+        if (!binaries_supported())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0)
+            return;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory(), error);
+        if (error) {
+            core::Logger::warn("can't create shader cache directory '{}': {}", directory(), error.message());
+            return;
+        }
+
+        // Written to a temporary file first, so that a crash never leaves a truncated binary behind.
+        auto path = directory() + fmt::format("{:016x}.bin", key);
+        auto temporary_path = path + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            BinaryHeader header{MAGIC, key, format, static_cast<std::uint32_t>(written)};
+            file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file) {
+                core::Logger::warn("can't write program binary '{}'", temporary_path);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary_path, path, error);
+        if (error)
+            core::Logger::warn("can't write program binary '{}': {}", path, error.message());
+    }
+
+    void ShaderCache::record(bool hit, std::chrono::nanoseconds duration)
+    {
+        if (hit) {
+            ++m_stats.hits;
+            m_stats.hit_time += duration;
+        } else {
+            ++m_stats.misses;
+            m_stats.miss_time += duration;
+        }
+    }
+
+    std::size_t ShaderCache::clear()
+    {
+        std::size_t removed = 0;
+        std::error_code error;
+        for (auto const& entry : std::filesystem::directory_iterator(directory(), error)) {
+            if (entry.path().extension() == ".bin" && std::filesystem::remove(entry.path(), error))
+                ++removed;
+        }
+        return removed;
+    }
+
+    std::string ShaderCache::directory()
+    {
+        static auto const DIRECTORY = core::ResourceManager::get_resource_dir() + "../cache/shaders/";
+        return DIRECTORY;
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace Birdy3d::render {
+
+    struct ShaderCacheStats {
+        // Programs that were loaded from the cache
+        std::size_t hits = 0;
+        // Programs that had to be compiled, including rejected cache entries
+        std::size_t misses = 0;
+        std::chrono::nanoseconds hit_time{0};
+        std::chrono::nanoseconds miss_time{0};
+    };
+
+    /**
+     * @brief On-disk cache of linked program binaries, keyed by the preprocessed sources and the OpenGL driver.
+     *
+     * Only used on the main thread. Disabled with BoolOption::SHADER_CACHE.
+     */
+    class ShaderCache {
+    public:
+        /**
+         * @brief Hashes the sources of all stages together with the vendor, renderer and version of the driver.
+         */
+        static std::uint64_t key(std::string_view vertex, std::string_view geometry, std::string_view fragment);
+
+        /**
+         * @brief Hashes only the sources, e.g. to name the SPIR-V files that are compiled at build time.
+         */
+        static std::uint64_t source_key(std::string_view vertex, std::string_view geometry, std::string_view fragment);
+
+        /**
+         * @brief Creates a program from the cached binary.
+         * @returns the linked program or 0 if the binary is missing or the driver rejected it
+         */
+        static GLuint load(std::uint64_t key);
+
+        /**
+         * @brief Writes the binary of a linked program to the cache.
+         *
+         * The program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+         */
+        static void store(std::uint64_t key, GLuint program);
+
+        /**
+         * @brief Adds the time it took to create a program to the statistics.
+         * @param hit whether the program was loaded from the cache
+         */
+        static void record(bool hit, std::chrono::nanoseconds duration);
+        static ShaderCacheStats const& stats() { return m_stats; }
+
+        /**
+         * @brief Removes all cached binaries.
+         * @returns amount of removed files
+         */
+        static std::size_t clear();
+
+    private:
+        static ShaderCacheStats m_stats;
+
+        static std::string directory();
+    };
+
+}
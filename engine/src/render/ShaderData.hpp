@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/Base.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Mirrors of the blocks in the shaders. The camera uses the std140 layout, the materials, instances and lights are arrays
+// in std430 shader storage buffers. A vec3 is aligned like a vec4, but a following scalar may fill its fourth component.
+
+namespace Birdy3d::render {
+
+    struct alignas(16) CameraData {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 view_pos;
+    };
+    static_assert(sizeof(CameraData) == 144);
+
+    struct alignas(16) MaterialData {
+        glm::vec4 diffuse_color;
+        glm::vec4 emissive_color;
+        float specular_value;
+        std::uint32_t diffuse_map_enabled;
+        std::uint32_t specular_map_enabled;
+        std::uint32_t normal_map_enabled;
+        std::uint32_t emissive_map_enabled;
+        // Bindless texture handles, 0 if bindless textures aren't supported
+        std::uint64_t diffuse_map = 0;
+        std::uint64_t specular_map = 0;
+        std::uint64_t normal_map = 0;
+        std::uint64_t emissive_map = 0;
+
+        bool operator==(MaterialData const&) const = default;
+    };
+    static_assert(sizeof(MaterialData) == 96 && offsetof(MaterialData, diffuse_map) == 56);
+
+    struct alignas(16) InstanceData {
+        glm::mat4 model;
+        std::uint32_t material_index;
+    };
+    static_assert(sizeof(InstanceData) == 80);
+
+    struct alignas(16) DirectionalLightData {
+        glm::vec3 position;
+        std::uint32_t shadow_enabled;
+        alignas(16) glm::vec3 direction;
+        alignas(16) glm::vec3 ambient;
+        alignas(16) glm::vec3 diffuse;
+    };
+    static_assert(sizeof(DirectionalLightData) == 64 && offsetof(DirectionalLightData, diffuse) == 48);
+
+    /**
+     * @brief One cascade of the shadow map of a directional light. Each light has SHADOW_CASCADE_SIZE of them.
+     */
+    struct alignas(16) ShadowCascadeData {
+        glm::mat4 light_space_matrix;
+        float level;
+    };
+    static_assert(sizeof(ShadowCascadeData) == 80);
+
+    struct alignas(16) PointLightData {
+        glm::vec3 position;
+        std::uint32_t shadow_enabled;
+        glm::vec3 ambient;
+        float linear;
+        glm::vec3 diffuse;
+        float quadratic;
+        float far;
+    };
+    static_assert(sizeof(PointLightData) == 64 && offsetof(PointLightData, far) == 48);
+
+    struct alignas(16) SpotlightData {
+        glm::mat4 light_space_matrix;
+        glm::vec3 position;
+        std::uint32_t shadow_enabled;
+        glm::vec3 direction;
+        float inner_cutoff;
+        glm::vec3 ambient;
+        float outer_cutoff;
+        glm::vec3 diffuse;
+        float linear;
+        float quadratic;
+    };
+    static_assert(sizeof(SpotlightData) == 144 && offsetof(SpotlightData, quadratic) == 128);
+
+}
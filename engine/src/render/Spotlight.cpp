@@ -2,14 +2,23 @@
 
 #include "core/ResourceManager.hpp"
 #include "ecs/Entity.hpp"
-#include "ecs/Scene.hpp"
-#include "render/ModelComponent.hpp"
+#include "render/InstanceBatches.hpp"
+#include "render/RenderSnapshot.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        namespace uniforms {
+            UniformHandle const light_space_matrix{"light_space_matrix"};
+        }
+
+    }
+
     Spotlight::Spotlight(utils::Color color, float intensity_ambient, float intensity_diffuse, float linear, float quadratic, float inner_cutoff, float outer_cutoff, bool shadow_enabled)
         : color(color)
         , intensity_ambient(intensity_ambient)
@@ -30,54 +39,52 @@ namespace Birdy3d::render {
 
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderState::bind_framebuffer(0);
     }
 
-    void Spotlight::gen_shadow_map()
+    void Spotlight::gen_shadow_map(SnapshotTransform const& transform, InstanceBatches const& shadow_casters)
     {
-        glm::vec3 world_pos = entity->transform.world_position();
+        glm::vec3 world_pos = transform.position;
 
         m_shadow_rendertarget.bind();
         glClear(GL_DEPTH_BUFFER_BIT);
-        glCullFace(GL_FRONT);
-        glEnable(GL_DEPTH_TEST);
+        RenderState::cull_face(GL_FRONT);
+        RenderState::enable(GL_DEPTH_TEST);
 
         m_depth_shader->use();
         float aspect = (float)shadow_width / (float)shadow_height;
         float near = 1.0f;
         m_far = 25.0f;
         glm::mat4 light_projection = glm::perspective(m_outer_cutoff * 2, aspect, near, m_far);
-        glm::mat4 light_view = glm::lookAt(world_pos, world_pos + entity->world_forward(), entity->world_up());
+        glm::mat4 light_view = glm::lookAt(world_pos, world_pos + transform.forward, transform.up);
 
         m_light_space_transform = light_projection * light_view;
-        m_depth_shader->set_mat4("light_space_matrix", m_light_space_transform);
-        for (auto m : entity->scene->get_components<ModelComponent>(false, true)) {
-            m->render_depth(*m_depth_shader);
-        }
+        m_depth_shader->set_mat4(uniforms::light_space_matrix, m_light_space_transform);
+        shadow_casters.render_depth();
 
-        glCullFace(GL_BACK);
+        RenderState::cull_face(GL_BACK);
     }
 
-    void Spotlight::use(Shader const& light_shader, int id, int textureid)
+    SpotlightData Spotlight::use(int textureid, SnapshotTransform const& transform, InstanceBatches const& shadow_casters)
     {
         if (!m_shadow_map_updated) {
-            gen_shadow_map();
+            gen_shadow_map(transform, shadow_casters);
             m_shadow_map_updated = true;
         }
-        std::string name = "spotlights[" + std::to_string(id) + "].";
-        light_shader.use();
-        light_shader.set_bool(name + "shadow_enabled", shadow_enabled);
-        light_shader.set_vec3(name + "position", entity->transform.world_position());
-        light_shader.set_vec3(name + "direction", entity->world_forward());
-        light_shader.set_vec3(name + "ambient", color.value * intensity_ambient);
-        light_shader.set_vec3(name + "diffuse", color.value * intensity_diffuse);
-        light_shader.set_float(name + "inner_cutoff", glm::cos(m_inner_cutoff));
-        light_shader.set_float(name + "outer_cutoff", glm::cos(m_outer_cutoff));
-        light_shader.set_float(name + "linear", linear);
-        light_shader.set_float(name + "quadratic", quadratic);
         m_shadow_map->bind(textureid);
-        light_shader.set_mat4(name + "light_space_matrix", m_light_space_transform);
-        light_shader.set_int(name + "shadow_map", textureid);
+
+        return {
+            .light_space_matrix = m_light_space_transform,
+            .position = transform.position,
+            .shadow_enabled = shadow_enabled,
+            .direction = transform.forward,
+            .inner_cutoff = glm::cos(m_inner_cutoff),
+            .ambient = color.value * intensity_ambient,
+            .outer_cutoff = glm::cos(m_outer_cutoff),
+            .diffuse = color.value * intensity_diffuse,
+            .linear = linear,
+            .quadratic = quadratic,
+        };
     }
 
     void Spotlight::start()
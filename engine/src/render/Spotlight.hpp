@@ -4,6 +4,7 @@
 #include "ecs/Component.hpp"
 #include "render/Rendertarget.hpp"
 #include "render/Shader.hpp"
+#include "render/ShaderData.hpp"
 
 namespace Birdy3d::render {
 
@@ -20,8 +21,13 @@ namespace Birdy3d::render {
 
         Spotlight(utils::Color color = utils::Color::WHITE, float intensity_ambient = 1, float intensity_diffuse = 1, float linear = 0, float quadratic = 0, float inner_cutoff = glm::radians(40.0f), float outer_cutoff = glm::radians(50.0f), bool shadow_enabled = true);
         void setup_shadow_map();
-        void gen_shadow_map();
-        void use(Shader const& light_shader, int id, int textureid);
+        void gen_shadow_map(SnapshotTransform const&, InstanceBatches const& shadow_casters);
+        /**
+         * @brief Updates the shadow map if necessary and binds it to the texture unit.
+         * @param shadow_casters Models that are drawn into the shadow map, already uploaded
+         * @returns the data of the light for the shaders
+         */
+        SpotlightData use(int textureid, SnapshotTransform const&, InstanceBatches const& shadow_casters);
         void start() override;
         void update() override;
         void serialize(serializer::Adapter&) override;
@@ -1,9 +1,24 @@
 #include "render/Texture.hpp"
 
 #include "core/Logger.hpp"
+#include "render/RenderState.hpp"
 
 namespace Birdy3d::render {
 
+    namespace {
+
+        // GL_ARB_bindless_texture isn't part of the generated loader.
+        using GetTextureHandle = GLuint64(APIENTRYP)(GLuint texture);
+        using MakeTextureHandleResident = void(APIENTRYP)(GLuint64 handle);
+
+        GetTextureHandle get_texture_handle = nullptr;
+        MakeTextureHandleResident make_texture_handle_resident = nullptr;
+        MakeTextureHandleResident make_texture_handle_non_resident = nullptr;
+
+    }
+
+    bool Texture::m_bindless_supported = false;
+
     Texture::Texture(utils::TextureLoader::Image const& image)
     {
         m_width = image.width;
@@ -35,10 +50,11 @@ namespace Birdy3d::render {
         }
 
         m_transparent = m_format == GL_RGBA;
+        m_type = GL_UNSIGNED_BYTE;
+        m_mipmapped = true;
 
-        glGenTextures(1, &m_id);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+        RenderState::bind_texture(0, m_id);
         glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_width, m_height, 0, m_format, GL_UNSIGNED_BYTE, &image.data[0]);
         glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -52,10 +68,16 @@ namespace Birdy3d::render {
     {
         glm::vec4 vec = color.value;
         m_transparent = vec.a < 1;
+        m_width = 1;
+        m_height = 1;
+        m_channels = 4;
+        m_internal_format = GL_RGBA;
+        m_format = GL_RGBA;
+        m_type = GL_UNSIGNED_BYTE;
+        m_mipmapped = true;
         float data[4] = {vec.r, vec.g, vec.b, vec.a};
-        glGenTextures(1, &m_id);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+        RenderState::bind_texture(0, m_id);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_FLOAT, data);
         glGenerateMipmap(GL_TEXTURE_2D);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -70,9 +92,8 @@ namespace Birdy3d::render {
         , m_height(height)
         , m_resizable(true)
     {
-        glGenTextures(1, &m_id);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+        RenderState::bind_texture(0, m_id);
         switch (preset) {
         case Preset::NONE:
             core::Logger::error("Invalid Texture preset");
@@ -125,7 +146,9 @@ namespace Birdy3d::render {
 
     Texture::~Texture()
     {
-        glDeleteTextures(1, &m_id);
+        if (m_bindless_handle != 0)
+            make_texture_handle_non_resident(m_bindless_handle);
+        RenderState::delete_texture(m_id);
     }
 
     bool Texture::transparent() const
@@ -135,8 +158,7 @@ namespace Birdy3d::render {
 
     void Texture::bind(int texture_unit) const
     {
-        glActiveTexture(GL_TEXTURE0 + texture_unit);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        RenderState::bind_texture(texture_unit, m_id);
     }
 
     void Texture::resize(int width, int height)
@@ -145,11 +167,41 @@ namespace Birdy3d::render {
             return;
         m_width = width;
         m_height = height;
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        RenderState::bind_texture(0, m_id);
         glTexImage2D(GL_TEXTURE_2D, 0, m_internal_format, m_width, m_height, 0, m_format, m_type, nullptr);
     }
 
+    std::size_t Texture::memory_size() const
+    {
+        std::size_t bytes_per_channel = m_type == GL_FLOAT ? 4 : 1;
+        std::size_t size = static_cast<std::size_t>(m_width) * m_height * m_channels * bytes_per_channel;
+        // A full mipmap chain adds roughly one third
+        if (m_mipmapped)
+            size += size / 3;
+        return size;
+    }
+
+    std::uint64_t Texture::bindless_handle() const
+    {
+        if (!m_bindless_supported)
+            return 0;
+        if (m_bindless_handle == 0) {
+            m_bindless_handle = get_texture_handle(m_id);
+            make_texture_handle_resident(m_bindless_handle);
+        }
+        return m_bindless_handle;
+    }
+
+    void Texture::init_bindless()
+    {
+        if (!glfwExtensionSupported("GL_ARB_bindless_texture"))
+            return;
+        get_texture_handle = reinterpret_cast<GetTextureHandle>(glfwGetProcAddress("glGetTextureHandleARB"));
+        make_texture_handle_resident = reinterpret_cast<MakeTextureHandleResident>(glfwGetProcAddress("glMakeTextureHandleResidentARB"));
+        make_texture_handle_non_resident = reinterpret_cast<MakeTextureHandleResident>(glfwGetProcAddress("glMakeTextureHandleNonResidentARB"));
+        m_bindless_supported = get_texture_handle && make_texture_handle_resident && make_texture_handle_non_resident;
+    }
+
     GLuint Texture::id() const
     {
         return m_id;
@@ -29,6 +29,19 @@ namespace Birdy3d::render {
         [[nodiscard]] GLuint id() const;
         [[nodiscard]] bool is_depth() const;
         [[nodiscard]] Preset preset() const { return m_preset; }
+        /// @returns approximate size of the texture in video memory in bytes, including mipmaps
+        [[nodiscard]] std::size_t memory_size() const;
+        /**
+         * @brief Creates a resident bindless handle on first use. The texture can't be resized afterwards.
+         * @returns the handle or 0 if bindless textures aren't supported
+         */
+        [[nodiscard]] std::uint64_t bindless_handle() const;
+
+        /**
+         * @brief Checks for GL_ARB_bindless_texture. Called once on the main thread after the context was created.
+         */
+        static void init_bindless();
+        [[nodiscard]] static bool bindless_supported() { return m_bindless_supported; }
 
     private:
         Preset m_preset = Preset::NONE;
@@ -40,6 +53,10 @@ namespace Birdy3d::render {
         GLenum m_format;
         GLenum m_type;
         bool m_resizable = false;
+        bool m_mipmapped = false;
+        mutable std::uint64_t m_bindless_handle = 0;
+
+        static bool m_bindless_supported;
     };
 
 }
@@ -0,0 +1,69 @@
+#include "render/UniformHandle.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace Birdy3d::render {
+
+    namespace {
+
+        struct StringViewHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view string) const noexcept
+            {
+                return std::hash<std::string_view>{}(string);
+            }
+        };
+
+        struct UniformRegistry {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::uint32_t, StringViewHash, std::equal_to<>> ids;
+            // A deque doesn't move its elements, so references returned by UniformHandle::name() stay valid.
+            std::deque<std::string> names;
+        };
+
+        UniformRegistry& registry()
+        {
+            // Function local, because handles are usually created during static initialization.
+            static UniformRegistry registry;
+            return registry;
+        }
+
+    }
+
+    UniformHandle::UniformHandle(std::string_view name)
+    {
+        auto& uniforms = registry();
+        std::lock_guard<std::mutex> lock{uniforms.mutex};
+        auto it = uniforms.ids.find(name);
+        if (it != uniforms.ids.end()) {
+            m_id = it->second;
+            return;
+        }
+        m_id = static_cast<std::uint32_t>(uniforms.names.size());
+        uniforms.names.emplace_back(name);
+        uniforms.ids.emplace(uniforms.names.back(), m_id);
+    }
+
+    std::string const& UniformHandle::name() const
+    {
+        auto& uniforms = registry();
+        std::lock_guard<std::mutex> lock{uniforms.mutex};
+        return uniforms.names[m_id];
+    }
+
+    UniformArray::UniformArray(std::string_view name, std::string_view member)
+        : m_name(name)
+        , m_member(member)
+    { }
+
+    UniformHandle UniformArray::operator[](std::size_t index)
+    {
+        while (m_elements.size() <= index)
+            m_elements.emplace_back(m_name + "[" + std::to_string(m_elements.size()) + "]" + m_member);
+        return m_elements[index];
+    }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Birdy3d::render {
+
+    /**
+     * @brief Interned uniform name that a Shader can turn into a location without any string work.
+     *
+     * A shader looks the name up once per handle and caches the location, so handles should be created once, e.g. as
+     * static variables, and not every frame.
+     */
+    class UniformHandle {
+    public:
+        explicit UniformHandle(std::string_view name);
+        [[nodiscard]] std::uint32_t id() const { return m_id; }
+        [[nodiscard]] std::string const& name() const;
+
+    private:
+        std::uint32_t m_id;
+    };
+
+    /**
+     * @brief Handles for the elements of a uniform array, e.g. "point_lights[i].position", created on first use.
+     */
+    class UniformArray {
+    public:
+        /**
+         * @param name Name of the array
+         * @param member Appended to every element, e.g. ".position" for an array of structs
+         */
+        UniformArray(std::string_view name, std::string_view member = {});
+        UniformHandle operator[](std::size_t index);
+
+    private:
+        std::string m_name;
+        std::string m_member;
+        std::vector<UniformHandle> m_elements;
+    };
+
+}
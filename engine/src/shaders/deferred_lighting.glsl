@@ -1,3 +1,4 @@
+#include includes/camera.glsl
 #include includes/lighting.glsl
 
 #type vertex
@@ -21,9 +22,6 @@ uniform sampler2D gbuffer_normal;
 uniform sampler2D gbuffer_albedo_spec;
 uniform sampler2D ssao;
 
-uniform mat4 view;
-uniform vec3 view_pos;
-
 void main() {
     vec3 frag_pos = texture(gbuffer_position, v_tex_coord).rgb;
     vec3 normal = texture(gbuffer_normal, v_tex_coord).rgb;
@@ -1,11 +1,12 @@
 #parameter SHADOW_CASCADE_SIZE 1
 
+#include includes/instances.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 
-uniform mat4 model;
-
 void main() {
+    mat4 model = INSTANCE.model;
     gl_Position = model * vec4(in_pos, 1.0);
 }
 
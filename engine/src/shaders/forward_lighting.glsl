@@ -10,17 +10,11 @@ in vec2 v_tex_coords;
 in vec3 v_normal;
 in mat3 TBN;
 
-uniform sampler2D texture_diffuse;
-uniform sampler2D texture_specular;
-uniform sampler2D texture_normal;
-uniform vec3 view_pos;
-uniform mat4 view;
-
 void main() {
     vec3 view_dir = normalize(view_pos - v_frag_pos);
-    vec4 var_diffuse = material.diffuse_map_enabled ? texture(material.diffuse_map, v_tex_coords).rgba : material.diffuse_color;
-    float var_specular = material.specular_map_enabled ? texture(material.specular_map, v_tex_coords).r * 100 : material.specular_value;
-    vec3 var_normal = material.normal_map_enabled ? normalize(TBN * (texture(material.normal_map, v_tex_coords).rgb * 2.0 - 1.0)) : v_normal;
+    vec4 var_diffuse = material_diffuse(v_tex_coords);
+    float var_specular = material_specular(v_tex_coords);
+    vec3 var_normal = material_normal(v_tex_coords, TBN, v_normal);
     if (var_diffuse.a < 0.1)
         discard;
 
@@ -13,12 +13,7 @@ in mat3 TBN;
 
 void main() {
     gbuffer_position = v_frag_pos;
-    gbuffer_albedo_spec.rgb = material.diffuse_map_enabled ? texture(material.diffuse_map, v_tex_coords).rgb : material.diffuse_color.rgb;
-
-    if (material.normal_map_enabled)
-        gbuffer_normal = normalize(TBN * (texture(material.normal_map, v_tex_coords).rgb * 2.0 - 1.0));
-    else
-        gbuffer_normal = normalize(v_normal);
-
-    gbuffer_albedo_spec.a = material.specular_map_enabled ? texture(material.specular_map, v_tex_coords).r : material.specular_value / 100;
+    gbuffer_albedo_spec.rgb = material_diffuse(v_tex_coords).rgb;
+    gbuffer_normal = material_normal(v_tex_coords, TBN, v_normal);
+    gbuffer_albedo_spec.a = material_specular(v_tex_coords) / 100;
 }
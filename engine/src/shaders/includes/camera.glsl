@@ -0,0 +1,13 @@
+#type vertex
+layout (std140, binding = CAMERA_BINDING) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec3 view_pos;
+};
+
+#type fragment
+layout (std140, binding = CAMERA_BINDING) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec3 view_pos;
+};
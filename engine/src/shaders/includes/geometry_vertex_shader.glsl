@@ -1,3 +1,6 @@
+#include includes/camera.glsl
+#include includes/instances.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 layout (location = 1) in vec3 in_normal;
@@ -8,12 +11,10 @@ out vec3 v_frag_pos;
 out vec2 v_tex_coords;
 out vec3 v_normal;
 out mat3 TBN;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+flat out uint v_material_index;
 
 void main() {
+    mat4 model = INSTANCE.model;
     vec4 world_pos = model * vec4(in_pos, 1.0f);
 
     v_frag_pos = world_pos.xyz;
@@ -26,6 +27,7 @@ void main() {
     vec3 B = cross(v_normal, T);
 
     TBN = mat3(T, B, v_normal);
+    v_material_index = INSTANCE.material_index;
 
     gl_Position = projection * view * world_pos;
 }
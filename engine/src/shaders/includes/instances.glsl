@@ -0,0 +1,13 @@
+#type vertex
+// The layout is mirrored by render/ShaderData.hpp.
+struct Instance {
+    mat4 model;
+    uint material_index;
+};
+
+layout (std430, binding = INSTANCES_BINDING) readonly buffer Instances {
+    Instance instances[];
+};
+
+// Draws pass the offset of their first instance as base instance.
+#define INSTANCE instances[gl_BaseInstance + gl_InstanceID]
@@ -1,52 +1,43 @@
 #parameter SHADOW_CASCADE_SIZE 1
 
 #type fragment
-struct DirectionalLight {
-    bool shadow_enabled;
+// The layouts are mirrored by render/ShaderData.hpp.
+// Samplers can't be stored in buffers, so the shadow maps are arrays of uniforms with fixed texture units, starting at 4.
 
+struct DirectionalLight {
     vec3 position;
+    bool shadow_enabled;
     vec3 direction;
-
     vec3 ambient;
     vec3 diffuse;
+};
 
-    mat4 light_space_matrices[SHADOW_CASCADE_SIZE];
-    float shadow_cascade_levels[SHADOW_CASCADE_SIZE];
-    sampler2DArrayShadow shadow_map;
+struct ShadowCascade {
+    mat4 light_space_matrix;
+    float level;
 };
 
 struct PointLight {
-    bool shadow_enabled;
-
     vec3 position;
-
+    bool shadow_enabled;
     vec3 ambient;
-    vec3 diffuse;
-
     float linear;
+    vec3 diffuse;
     float quadratic;
-
     float far;
-
-    samplerCubeShadow shadow_map;
 };
 
 struct Spotlight {
-    bool shadow_enabled;
-
+    mat4 light_space_matrix;
     vec3 position;
+    bool shadow_enabled;
     vec3 direction;
     float inner_cutoff;
-    float outer_cutoff;
-
     vec3 ambient;
+    float outer_cutoff;
     vec3 diffuse;
-
     float linear;
     float quadratic;
-
-    mat4 light_space_matrix;
-    sampler2DShadow shadow_map;
 };
 
 #parameter DIRECTIONAL_LIGHTS_AMOUNT 0
@@ -54,15 +45,32 @@ struct Spotlight {
 #parameter SPOTLIGHTS_AMOUNT 0
 
 #if DIRECTIONAL_LIGHTS_AMOUNT > 0
-uniform DirectionalLight directional_lights[DIRECTIONAL_LIGHTS_AMOUNT];
+layout (std430, binding = DIRECTIONAL_LIGHTS_BINDING) readonly buffer DirectionalLights {
+    DirectionalLight directional_lights[];
+};
+
+// SHADOW_CASCADE_SIZE cascades per light
+layout (std430, binding = SHADOW_CASCADES_BINDING) readonly buffer ShadowCascades {
+    ShadowCascade shadow_cascades[];
+};
+
+layout (binding = 4) uniform sampler2DArrayShadow directional_shadow_maps[DIRECTIONAL_LIGHTS_AMOUNT];
 #endif
 
 #if POINTLIGHTS_AMOUNT > 0
-uniform PointLight point_lights[POINTLIGHTS_AMOUNT];
+layout (std430, binding = POINT_LIGHTS_BINDING) readonly buffer PointLights {
+    PointLight point_lights[];
+};
+
+layout (binding = 4 + DIRECTIONAL_LIGHTS_AMOUNT) uniform samplerCubeShadow point_shadow_maps[POINTLIGHTS_AMOUNT];
 #endif
 
 #if SPOTLIGHTS_AMOUNT > 0
-uniform Spotlight spotlights[SPOTLIGHTS_AMOUNT];
+layout (std430, binding = SPOTLIGHTS_BINDING) readonly buffer Spotlights {
+    Spotlight spotlights[];
+};
+
+layout (binding = 4 + DIRECTIONAL_LIGHTS_AMOUNT + POINTLIGHTS_AMOUNT) uniform sampler2DShadow spot_shadow_maps[SPOTLIGHTS_AMOUNT];
 #endif
 
 float calc_specular_factor(vec3 normal, vec3 light_dir, vec3 view_dir, float shininess) {
@@ -72,7 +80,9 @@ float calc_specular_factor(vec3 normal, vec3 light_dir, vec3 view_dir, float shi
     return pow(max(dot(normal, halfwayDir), 0.0f), shininess) * (shininess / 100.0f);
 }
 
-vec3 calc_directional_light(DirectionalLight light, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion, mat4 view) {
+#if DIRECTIONAL_LIGHTS_AMOUNT > 0
+vec3 calc_directional_light(int index, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion, mat4 view) {
+    DirectionalLight light = directional_lights[index];
     vec3 light_dir = normalize(-light.direction);
 
     // ambient lighting
@@ -112,7 +122,7 @@ vec3 calc_directional_light(DirectionalLight light, vec3 normal, vec3 frag_pos,
 
     int layer = -1;
     for (int i = 0; i < SHADOW_CASCADE_SIZE; ++i) {
-        if (depth < light.shadow_cascade_levels[i]) {
+        if (depth < shadow_cascades[index * SHADOW_CASCADE_SIZE + i].level) {
             layer = i;
             break;
         }
@@ -121,7 +131,8 @@ vec3 calc_directional_light(DirectionalLight light, vec3 normal, vec3 frag_pos,
         layer = SHADOW_CASCADE_SIZE - 1;
     }
 
-    vec4 frag_pos_light_space = light.light_space_matrices[layer] * vec4(frag_pos, 1.0);
+    ShadowCascade cascade = shadow_cascades[index * SHADOW_CASCADE_SIZE + layer];
+    vec4 frag_pos_light_space = cascade.light_space_matrix * vec4(frag_pos, 1.0);
 
     vec3 proj_coords = frag_pos_light_space.xyz / frag_pos_light_space.w;
     proj_coords = proj_coords * 0.5 + 0.5;
@@ -133,15 +144,18 @@ vec3 calc_directional_light(DirectionalLight light, vec3 normal, vec3 frag_pos,
     // }
     // calculate bias (based on depth map resolution and slope)
     float bias = max(0.05 * (1.0 - dot(normal, light_dir)), 0.005);
-    bias *= 1 / (light.shadow_cascade_levels[layer] * 0.5f);
+    bias *= 1 / (cascade.level * 0.5f);
 
     // float shadow = texture(light.shadow_map, vec4(proj_coords, layer), bias);
-    float shadow = texture(light.shadow_map, vec4(proj_coords.xy, layer, proj_coords.z));
+    float shadow = texture(directional_shadow_maps[index], vec4(proj_coords.xy, layer, proj_coords.z));
 
     return lighting * shadow + ambient;
 }
+#endif
 
-vec3 calc_point_light(PointLight light, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion) {
+#if POINTLIGHTS_AMOUNT > 0
+vec3 calc_point_light(int index, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion) {
+    PointLight light = point_lights[index];
     vec3 light_dir = normalize(light.position - frag_pos);
     float distance = length(light.position - frag_pos);
     float attenuation = 1.0f / (1.0f + light.linear * distance + light.quadratic * (distance * distance));
@@ -166,12 +180,15 @@ vec3 calc_point_light(PointLight light, vec3 normal, vec3 frag_pos, vec3 view_di
     vec3 frag_to_light = frag_pos - light.position;
     float depth = length(frag_to_light) / light.far;
     float bias = 0.0f;
-    float shadow = texture(light.shadow_map, vec4(frag_to_light, depth), bias);
+    float shadow = texture(point_shadow_maps[index], vec4(frag_to_light, depth), bias);
 
     return lighting * shadow + ambient;
 }
+#endif
 
-vec3 calc_spotlight(Spotlight light, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion) {
+#if SPOTLIGHTS_AMOUNT > 0
+vec3 calc_spotlight(int index, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion) {
+    Spotlight light = spotlights[index];
     vec3 light_dir = normalize(light.position - frag_pos);
     float theta = dot(light_dir, normalize(-light.direction));
     float epsilon = light.inner_cutoff - light.outer_cutoff;
@@ -202,26 +219,27 @@ vec3 calc_spotlight(Spotlight light, vec3 normal, vec3 frag_pos, vec3 view_dir,
     proj_coords = proj_coords * 0.5f + 0.5f;
     light_dir = normalize(light.position - frag_pos);
     float bias = 0.0f;
-    float shadow = texture(light.shadow_map, proj_coords, bias);
+    float shadow = texture(spot_shadow_maps[index], proj_coords, bias);
 
     return lighting * shadow + ambient;
 }
+#endif
 
 vec3 calc_lights(mat4 view, vec3 normal, vec3 frag_pos, vec3 view_dir, vec3 material_color, float shininess, float ambient_occlusion) {
     vec3 lighting = vec3(0);
 #if DIRECTIONAL_LIGHTS_AMOUNT > 0
     for (int i = 0; i < DIRECTIONAL_LIGHTS_AMOUNT; i++)
-        lighting += calc_directional_light(directional_lights[i], normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion, view);
+        lighting += calc_directional_light(i, normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion, view);
 #endif
 
 #if POINTLIGHTS_AMOUNT > 0
     for (int i = 0; i < POINTLIGHTS_AMOUNT; i++)
-        lighting += calc_point_light(point_lights[i], normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion);
+        lighting += calc_point_light(i, normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion);
 #endif
 
 #if SPOTLIGHTS_AMOUNT > 0
     for (int i = 0; i < SPOTLIGHTS_AMOUNT; i++)
-        lighting += calc_spotlight(spotlights[i], normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion);
+        lighting += calc_spotlight(i, normal, frag_pos, view_dir, material_color, shininess, ambient_occlusion);
 #endif
 
     return lighting;
@@ -1,19 +1,54 @@
 #type fragment
+// The layout is mirrored by render/ShaderData.hpp.
 struct Material {
-    bool diffuse_map_enabled;
     vec4 diffuse_color;
-    sampler2D diffuse_map;
-
-    bool specular_map_enabled;
+    vec4 emissive_color;
     float specular_value;
-    sampler2D specular_map;
-
+    bool diffuse_map_enabled;
+    bool specular_map_enabled;
     bool normal_map_enabled;
-    sampler2D normal_map;
-
     bool emissive_map_enabled;
-    vec4 emissive_color;
-    sampler2D emissive_map;
+    // Bindless texture handles, only set if BINDLESS_TEXTURES is defined
+    uvec2 diffuse_map;
+    uvec2 specular_map;
+    uvec2 normal_map;
+    uvec2 emissive_map;
+};
+
+layout (std430, binding = MATERIALS_BINDING) readonly buffer Materials {
+    Material materials[];
 };
 
-uniform Material material;
+flat in uint v_material_index;
+
+#ifdef BINDLESS_TEXTURES
+#define MATERIAL_MAP(handle, sampler) sampler2D(handle)
+#else
+layout (binding = 0) uniform sampler2D material_diffuse_map;
+layout (binding = 1) uniform sampler2D material_specular_map;
+layout (binding = 2) uniform sampler2D material_normal_map;
+layout (binding = 3) uniform sampler2D material_emissive_map;
+#define MATERIAL_MAP(handle, sampler) sampler
+#endif
+
+vec4 material_diffuse(vec2 tex_coords) {
+    Material material = materials[v_material_index];
+    if (!material.diffuse_map_enabled)
+        return material.diffuse_color;
+    return texture(MATERIAL_MAP(material.diffuse_map, material_diffuse_map), tex_coords);
+}
+
+// Between 0 and 100
+float material_specular(vec2 tex_coords) {
+    Material material = materials[v_material_index];
+    if (!material.specular_map_enabled)
+        return material.specular_value;
+    return texture(MATERIAL_MAP(material.specular_map, material_specular_map), tex_coords).r * 100;
+}
+
+vec3 material_normal(vec2 tex_coords, mat3 TBN, vec3 normal) {
+    Material material = materials[v_material_index];
+    if (!material.normal_map_enabled)
+        return normalize(normal);
+    return normalize(TBN * (texture(MATERIAL_MAP(material.normal_map, material_normal_map), tex_coords).rgb * 2.0 - 1.0));
+}
@@ -1,3 +1,6 @@
+#include includes/camera.glsl
+#include includes/instances.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 layout (location = 1) in vec3 in_normal;
@@ -6,10 +9,8 @@ out VS_OUT {
     vec3 normal;
 } vs_out;
 
-uniform mat4 view;
-uniform mat4 model;
-
 void main() {
+    mat4 model = INSTANCE.model;
     gl_Position = view * model * vec4(in_pos, 1.0);
     mat3 normal_matrix = mat3(transpose(inverse(view * model)));
     vs_out.normal = normalize(normal_matrix * in_normal);
@@ -25,7 +26,11 @@ in VS_OUT {
 
 const float MAGNITUDE = 0.3;
 
-uniform mat4 projection;
+layout (std140, binding = CAMERA_BINDING) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec3 view_pos;
+};
 
 void GenerateLine(int index) {
     gl_Position = projection * gl_in[index].gl_Position;
@@ -1,9 +1,10 @@
+#include includes/instances.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 
-uniform mat4 model;
-
 void main() {
+    mat4 model = INSTANCE.model;
     gl_Position = model * vec4(in_pos, 1.0);
 }
 
@@ -1,10 +1,12 @@
+#include includes/instances.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 
 uniform mat4 light_space_matrix;
-uniform mat4 model;
 
 void main() {
+    mat4 model = INSTANCE.model;
     gl_Position = light_space_matrix * model * vec4(in_pos, 1.0);
 }
 
@@ -1,3 +1,5 @@
+#include includes/camera.glsl
+
 #type vertex
 layout (location = 0) in vec3 in_pos;
 layout (location = 1) in vec2 in_tex_coords;
@@ -26,9 +28,6 @@ uniform vec3 samples[KERNEL_SIZE];
 float radius = 0.07;
 float bias = 0.01;
 
-uniform mat4 projection;
-uniform mat4 view;
-
 void main() {
     // get input for SSAO algorithm
     vec3 frag_pos = texture(gbuffer_position, v_tex_coords).xyz;
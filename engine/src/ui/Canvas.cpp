@@ -4,6 +4,7 @@
 #include "core/Input.hpp"
 #include "events/EventBus.hpp"
 #include "events/InputEvents.hpp"
+#include "render/RenderState.hpp"
 
 namespace Birdy3d::ui {
 
@@ -40,12 +41,12 @@ namespace Birdy3d::ui {
     void Canvas::draw_canvas()
     {
         if (updated) {
-            glDisable(GL_CULL_FACE);
+            render::RenderState::disable(GL_CULL_FACE);
             glClear(GL_DEPTH_BUFFER_BIT);
-            glEnable(GL_SCISSOR_TEST);
+            render::RenderState::enable(GL_SCISSOR_TEST);
             Widget::external_draw();
-            glDisable(GL_SCISSOR_TEST);
-            glEnable(GL_CULL_FACE);
+            render::RenderState::disable(GL_SCISSOR_TEST);
+            render::RenderState::enable(GL_CULL_FACE);
         }
     }
 
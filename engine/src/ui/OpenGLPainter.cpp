@@ -3,6 +3,7 @@
 #include "core/ResourceManager.hpp"
 #include "events/EventBus.hpp"
 #include "events/WindowResizeEvent.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include "render/Texture.hpp"
 #include "ui/Rect.hpp"
@@ -12,6 +13,19 @@
 
 namespace Birdy3d::ui {
 
+    namespace {
+
+        namespace uniforms {
+            render::UniformHandle const fill_color{"fill_color"};
+            render::UniformHandle const outline_color{"outline_color"};
+            render::UniformHandle const outline_width{"outline_width"};
+            render::UniformHandle const projection{"projection"};
+            render::UniformHandle const rect_texture{"rect_texture"};
+            render::UniformHandle const transform{"transform"};
+        }
+
+    }
+
     OpenGLPainter::OpenGLPainter()
     {
         m_color_shader = core::ResourceManager::get_shader("file::ui_rectangle.glsl:TEXTURE=0");
@@ -30,7 +44,7 @@ namespace Birdy3d::ui {
         glGenVertexArrays(1, &m_rectangle_vao);
         glGenBuffers(1, &m_rectangle_vbo);
         // Write to buffers
-        glBindVertexArray(m_rectangle_vao);
+        render::RenderState::bind_vertex_array(m_rectangle_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_rectangle_vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(rectangle_vertices), &rectangle_vertices[0], GL_STATIC_DRAW);
         // vertex positions
@@ -52,7 +66,7 @@ namespace Birdy3d::ui {
         glGenVertexArrays(1, &m_triangle_vao);
         glGenBuffers(1, &m_triangle_vbo);
         // Write to buffers
-        glBindVertexArray(m_triangle_vao);
+        render::RenderState::bind_vertex_array(m_triangle_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_triangle_vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(triangle_vertices), &triangle_vertices[0], GL_STATIC_DRAW);
         // vertex positions
@@ -73,7 +87,7 @@ namespace Birdy3d::ui {
     OpenGLPainter::~OpenGLPainter()
     {
         glDeleteBuffers(1, &m_rectangle_vbo);
-        glDeleteVertexArrays(1, &m_rectangle_vao);
+        render::RenderState::delete_vertex_array(m_rectangle_vao);
     }
 
     [[nodiscard]] Rect const& OpenGLPainter::visible_rectangle() const
@@ -98,16 +112,16 @@ namespace Birdy3d::ui {
         transform = glm::translate(transform, glm::vec3(rect.position(), 0.0f));
         transform = glm::scale(transform, glm::vec3(rect.size(), 1.0f));
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        render::RenderState::disable(GL_DEPTH_TEST);
+        render::RenderState::enable(GL_BLEND);
+        render::RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         m_color_shader->use();
-        m_color_shader->set_mat4("projection", m_projection_matrix);
-        m_color_shader->set_mat4("transform", transform);
-        m_color_shader->set_vec4("fill_color", fill_color);
-        m_color_shader->set_vec4("outline_color", outline_color);
-        m_color_shader->set_int("outline_width", outline_width);
-        glBindVertexArray(m_rectangle_vao);
+        m_color_shader->set_mat4(uniforms::projection, m_projection_matrix);
+        m_color_shader->set_mat4(uniforms::transform, transform);
+        m_color_shader->set_vec4(uniforms::fill_color, fill_color);
+        m_color_shader->set_vec4(uniforms::outline_color, outline_color);
+        m_color_shader->set_int(uniforms::outline_width, outline_width);
+        render::RenderState::bind_vertex_array(m_rectangle_vao);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
@@ -117,16 +131,15 @@ namespace Birdy3d::ui {
         transform = glm::translate(transform, glm::vec3(rect.position(), 0.0f));
         transform = glm::scale(transform, glm::vec3(rect.size(), 1.0f));
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture.id());
+        render::RenderState::disable(GL_DEPTH_TEST);
+        render::RenderState::enable(GL_BLEND);
+        render::RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        render::RenderState::bind_texture(0, texture.id());
         m_texture_shader->use();
-        m_texture_shader->set_mat4("projection", m_projection_matrix);
-        m_texture_shader->set_mat4("transform", transform);
-        m_texture_shader->set_int("rect_texture", 0);
-        glBindVertexArray(m_rectangle_vao);
+        m_texture_shader->set_mat4(uniforms::projection, m_projection_matrix);
+        m_texture_shader->set_mat4(uniforms::transform, transform);
+        m_texture_shader->set_int(uniforms::rect_texture, 0);
+        render::RenderState::bind_vertex_array(m_rectangle_vao);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
@@ -137,16 +150,16 @@ namespace Birdy3d::ui {
         transform = glm::rotate(transform, orientation, glm::vec3(0.0f, 0.0f, 1.0f));
         transform = glm::scale(transform, glm::vec3(rect.size(), 1.0f));
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        render::RenderState::disable(GL_DEPTH_TEST);
+        render::RenderState::enable(GL_BLEND);
+        render::RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         m_color_shader->use();
-        m_color_shader->set_mat4("projection", m_projection_matrix);
-        m_color_shader->set_mat4("transform", transform);
-        m_color_shader->set_vec4("fill_color", fill_color);
-        m_color_shader->set_vec4("outline_color", utils::Color::NONE);
-        m_color_shader->set_int("outline_width", 0);
-        glBindVertexArray(m_triangle_vao);
+        m_color_shader->set_mat4(uniforms::projection, m_projection_matrix);
+        m_color_shader->set_mat4(uniforms::transform, transform);
+        m_color_shader->set_vec4(uniforms::fill_color, fill_color);
+        m_color_shader->set_vec4(uniforms::outline_color, utils::Color::NONE);
+        m_color_shader->set_int(uniforms::outline_width, 0);
+        render::RenderState::bind_vertex_array(m_triangle_vao);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 3);
     }
 
@@ -2,6 +2,7 @@
 
 #include "core/Logger.hpp"
 #include "core/ResourceManager.hpp"
+#include "render/RenderState.hpp"
 #include "render/Shader.hpp"
 #include "ui/Theme.hpp"
 #include "utils/Unicode.hpp"
@@ -12,6 +13,16 @@
 
 namespace Birdy3d::ui {
 
+    namespace {
+
+        namespace uniforms {
+            render::UniformHandle const font_atlas{"font_atlas"};
+            render::UniformHandle const move{"move"};
+            render::UniformHandle const projection{"projection"};
+        }
+
+    }
+
     TextRenderer::~TextRenderer()
     {
         FT_Done_Face(*m_face);
@@ -41,9 +52,8 @@ namespace Birdy3d::ui {
         for (size_t i = 0; i < pixels.size(); i++)
             pixels[i] = 0;
         m_texture_atlas_current_pos = glm::ivec2(0);
-        glGenTextures(1, &m_texture_atlas);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_texture_atlas);
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_texture_atlas);
+        render::RenderState::bind_texture(0, m_texture_atlas);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -71,8 +81,7 @@ namespace Birdy3d::ui {
             m_texture_atlas_current_line_height = 0;
         }
         // generate texture
-        glBindTexture(GL_TEXTURE_2D, m_texture_atlas);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, m_texture_atlas_current_pos.x, m_texture_atlas_current_pos.y, (*m_face)->glyph->bitmap.width, (*m_face)->glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE, (*m_face)->glyph->bitmap.buffer);
+        glTextureSubImage2D(m_texture_atlas, 0, m_texture_atlas_current_pos.x, m_texture_atlas_current_pos.y, (*m_face)->glyph->bitmap.width, (*m_face)->glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE, (*m_face)->glyph->bitmap.buffer);
         // store character
         Character character = {
             glm::vec2((m_texture_atlas_current_pos.x) / m_texture_atlas_size.x, (m_texture_atlas_current_pos.y) / m_texture_atlas_size.y),
@@ -103,7 +112,6 @@ namespace Birdy3d::ui {
 
             if (new_text_length > m_buffer_char_capacity) {
                 m_buffer_char_capacity = new_text_length + increase_size;
-                glBindVertexArray(m_vao);
                 glNamedBufferData(m_vbo, sizeof(TextVertex) * m_buffer_char_capacity * 4, 0, GL_DYNAMIC_DRAW);
                 glNamedBufferData(m_ebo, sizeof(GLuint) * m_buffer_char_capacity * 6, 0, GL_DYNAMIC_DRAW);
             }
@@ -176,7 +184,6 @@ namespace Birdy3d::ui {
                 max_x = x;
 
             // Write to buffers
-            glBindVertexArray(m_vao);
             glNamedBufferSubData(m_vbo, 0, sizeof(TextVertex) * m_vertices.size(), m_vertices.data());
             glNamedBufferSubData(m_ebo, 0, sizeof(GLuint) * m_indices.size(), m_indices.data());
         }
@@ -186,16 +193,15 @@ namespace Birdy3d::ui {
         auto viewport = core::Application::get_viewport_size();
         auto projection_matrix = glm::ortho(0.0f, viewport.x, viewport.y, 0.0f);
 
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, core::Application::theme().text_renderer().m_texture_atlas);
+        render::RenderState::disable(GL_DEPTH_TEST);
+        render::RenderState::enable(GL_BLEND);
+        render::RenderState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        render::RenderState::bind_texture(0, core::Application::theme().text_renderer().m_texture_atlas);
         m_shader->use();
-        m_shader->set_mat4("projection", projection_matrix);
-        m_shader->set_mat4("move", move);
-        m_shader->set_int("font_atlas", 0);
-        glBindVertexArray(m_vao);
+        m_shader->set_mat4(uniforms::projection, projection_matrix);
+        m_shader->set_mat4(uniforms::move, move);
+        m_shader->set_int(uniforms::font_atlas, 0);
+        render::RenderState::bind_vertex_array(m_vao);
         glDrawElements(GL_TRIANGLES, m_escaped_text_length * 6, GL_UNSIGNED_INT, 0);
     }
 
@@ -277,7 +283,7 @@ namespace Birdy3d::ui {
         glCreateBuffers(1, &m_vbo);
         glCreateBuffers(1, &m_ebo);
         // Allocate buffers
-        glBindVertexArray(m_vao);
+        render::RenderState::bind_vertex_array(m_vao);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
         glNamedBufferData(m_vbo, sizeof(TextVertex) * m_buffer_char_capacity * 4, 0, GL_DYNAMIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
@@ -296,7 +302,7 @@ namespace Birdy3d::ui {
     void TextRenderer::delete_buffers()
     {
         glDeleteBuffers(1, &m_vbo);
-        glDeleteVertexArrays(1, &m_vao);
+        render::RenderState::delete_vertex_array(m_vao);
     }
 
 }
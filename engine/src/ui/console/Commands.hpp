@@ -8,11 +8,15 @@ namespace Birdy3d::ui {
         {
             register_console();
             register_ui();
+            register_resources();
+            register_render();
         }
 
     private:
         static void register_console();
         static void register_ui();
+        static void register_resources();
+        static void register_render();
     };
 
 }
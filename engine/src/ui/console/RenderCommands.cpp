@@ -0,0 +1,31 @@
+#include "core/Application.hpp"
+#include "ecs/Scene.hpp"
+#include "render/Camera.hpp"
+#include "render/RenderState.hpp"
+#include "ui/console/Commands.hpp"
+#include "ui/console/Console.hpp"
+#include <fmt/format.h>
+
+namespace Birdy3d::ui {
+
+    void ConsoleCommands::register_render()
+    {
+        Console::register_command("render.state", [](std::vector<std::string>) {
+            auto const& stats = render::RenderState::stats();
+            Console::println(fmt::format("{} state changes in the last frame, {} redundant ones skipped", stats.issued, stats.skipped));
+            Console::println(fmt::format("{} redundant state changes skipped in total", stats.total_skipped));
+        });
+
+        Console::register_command("render.culling", [](std::vector<std::string>) {
+            auto scene = core::Application::scene.lock();
+            auto camera = scene ? scene->main_camera.lock() : nullptr;
+            if (!camera) {
+                Console::println("No main camera");
+                return;
+            }
+            auto const& stats = camera->culling_stats();
+            Console::println(fmt::format("{} models visible, {} culled by the view frustum", stats.visible, stats.culled));
+        });
+    }
+
+}
@@ -0,0 +1,133 @@
+#include "core/Application.hpp"
+#include "core/ResourceManager.hpp"
+#include "render/ShaderCache.hpp"
+#include "ui/console/Commands.hpp"
+#include "ui/console/Console.hpp"
+#include "utils/serializer/Json.hpp"
+#include <fmt/format.h>
+#include <fstream>
+#include <limits>
+
+namespace Birdy3d::ui {
+
+    namespace {
+
+        double milliseconds(std::chrono::nanoseconds duration)
+        {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        std::string status(core::ResourceLoadStats const& stats)
+        {
+            return stats.failed ? "failed" : "complete";
+        }
+
+        void write_csv(std::ostream& stream, std::vector<core::ResourceLoadStats> const& loads)
+        {
+            stream << "id,status,total_ms,queue_wait_ms,decode_ms,upload_ms,cpu_bytes,gpu_bytes\n";
+            for (auto const& stats : loads) {
+                std::string id = stats.id.to_string();
+                std::string escaped_id;
+                for (char c : id) {
+                    if (c == '"')
+                        escaped_id += '"';
+                    escaped_id += c;
+                }
+                stream << fmt::format("\"{}\",{},{:.3f},{:.3f},{:.3f},{:.3f},{},{}\n", escaped_id, status(stats), milliseconds(stats.total_time()), milliseconds(stats.queue_wait), milliseconds(stats.decode_time), milliseconds(stats.upload_time), stats.memory.cpu, stats.memory.gpu);
+            }
+        }
+
+        void write_json(std::ostream& stream, std::vector<core::ResourceLoadStats> const& loads)
+        {
+            serializer::Array array;
+            for (auto const& stats : loads) {
+                serializer::Object object;
+                object["id"] = serializer::String(stats.id.to_string());
+                object["status"] = serializer::String(status(stats));
+                object["total_ms"] = serializer::Number(milliseconds(stats.total_time()));
+                object["queue_wait_ms"] = serializer::Number(milliseconds(stats.queue_wait));
+                object["decode_ms"] = serializer::Number(milliseconds(stats.decode_time));
+                object["upload_ms"] = serializer::Number(milliseconds(stats.upload_time));
+                object["cpu_bytes"] = serializer::Number(static_cast<double>(stats.memory.cpu));
+                object["gpu_bytes"] = serializer::Number(static_cast<double>(stats.memory.gpu));
+                array.value.push_back(std::move(object));
+            }
+            serializer::PrettyJsonGenerator generator(stream);
+            generator.generate(array);
+        }
+
+    }
+
+    void ConsoleCommands::register_resources()
+    {
+        Console::register_command("resources.progress", [](std::vector<std::string>) {
+            auto progress = core::ResourceManager::loading_progress();
+            Console::println(fmt::format("{} complete, {} failed, {} pending ({:.0f}%)", progress.complete, progress.failed, progress.pending, progress.fraction() * 100));
+        });
+
+        Console::register_command("resources.main_tasks", [](std::vector<std::string>) {
+            auto const& stats = core::Application::main_task_stats();
+            Console::println(fmt::format("{} tasks in the last frame, {} carried over", stats.last_frame_tasks, stats.backlog));
+            Console::println(fmt::format("{} frames over budget, {:.2f} ms max overrun, {:.2f} ms total overrun", stats.overrun_frames, milliseconds(stats.max_overrun), milliseconds(stats.total_overrun)));
+        });
+
+        Console::register_command("resources.slowest", [](std::vector<std::string> args) {
+            std::size_t count = 10;
+            try {
+                if (args.size() == 1)
+                    count = std::stoul(args[0]);
+                else if (args.size() > 1)
+                    throw std::invalid_argument("too many arguments");
+            } catch (std::exception const&) {
+                Console::println("Usage: resources.slowest [count]");
+                return;
+            }
+
+            Console::println("   total    queue   decode   upload   CPU KiB   GPU KiB  resource");
+            for (auto const& stats : core::ResourceManager::slowest_loads(count)) {
+                auto line = fmt::format("{:8.2f} {:8.2f} {:8.2f} {:8.2f} {:9} {:9}  {}", milliseconds(stats.total_time()), milliseconds(stats.queue_wait), milliseconds(stats.decode_time), milliseconds(stats.upload_time), stats.memory.cpu / 1024, stats.memory.gpu / 1024, stats.id.to_string());
+                Console::println(line, stats.failed ? utils::Color::Name::RED : utils::Color::Name::NONE);
+            }
+        });
+
+        Console::register_command("resources.export", [](std::vector<std::string> args) {
+            if (args.size() != 2 || (args[0] != "csv" && args[0] != "json")) {
+                Console::println("Usage: resources.export <csv|json> <path>");
+                return;
+            }
+
+            std::ofstream file(args[1]);
+            if (!file) {
+                Console::println("Can't open " + args[1], utils::Color::Name::RED);
+                return;
+            }
+
+            auto loads = core::ResourceManager::slowest_loads(std::numeric_limits<std::size_t>::max());
+            if (args[0] == "csv")
+                write_csv(file, loads);
+            else
+                write_json(file, loads);
+            Console::println(fmt::format("Exported {} resource loads to {}", loads.size(), args[1]));
+        });
+
+        Console::register_command("resources.shader_cache", [](std::vector<std::string> args) {
+            if (args.size() == 1 && args[0] == "clear") {
+                Console::println(fmt::format("Removed {} program binaries", render::ShaderCache::clear()));
+                return;
+            }
+            if (!args.empty()) {
+                Console::println("Usage: resources.shader_cache [clear]");
+                return;
+            }
+
+            auto const& stats = render::ShaderCache::stats();
+            auto average = [](std::chrono::nanoseconds total, std::size_t count) {
+                return count == 0 ? 0.0 : milliseconds(total) / count;
+            };
+            Console::println(fmt::format("cache {}", core::Application::option_bool(core::BoolOption::SHADER_CACHE) ? "enabled" : "disabled"));
+            Console::println(fmt::format("{} loaded from cache, {:.2f} ms total, {:.2f} ms average", stats.hits, milliseconds(stats.hit_time), average(stats.hit_time, stats.hits)));
+            Console::println(fmt::format("{} compiled, {:.2f} ms total, {:.2f} ms average", stats.misses, milliseconds(stats.miss_time), average(stats.miss_time, stats.misses)));
+        });
+    }
+
+}
@@ -1,6 +1,7 @@
 #include "ui/widgets/ContextMenu.hpp"
 
 #include "core/Input.hpp"
+#include "render/RenderState.hpp"
 #include "ui/Canvas.hpp"
 #include "ui/Painter.hpp"
 #include "ui/Theme.hpp"
@@ -41,9 +42,9 @@ namespace Birdy3d::ui {
     void ContextMenu::draw()
     {
         root_item.m_child_rect.position(m_absolute_rect.position());
-        glDisable(GL_SCISSOR_TEST);
+        render::RenderState::disable(GL_SCISSOR_TEST);
         draw_context_item_children(root_item);
-        glEnable(GL_SCISSOR_TEST);
+        render::RenderState::enable(GL_SCISSOR_TEST);
     }
 
     void ContextMenu::open(glm::ivec2 open_pos)
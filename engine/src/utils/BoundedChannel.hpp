@@ -0,0 +1,327 @@
+#pragma once
+
+#include "utils/Channel.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace channel_detail {
+
+    // Keeps the indices of producers and consumers on separate cache lines.
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Lets threads wait for a condition by spinning shortly and then parking on an atomic.
+     *
+     * notify() is cheap while nobody is parked, so it can be called after every push and pop.
+     */
+    class SpinParkWaiter {
+    public:
+        // Amount of checks before the thread parks. The second half yields in between.
+        static constexpr int SPIN_COUNT = 64;
+
+        template <typename Predicate>
+        void wait(Predicate const& ready)
+        {
+            for (int i = 0; i < SPIN_COUNT; ++i) {
+                if (ready())
+                    return;
+                if (i >= SPIN_COUNT / 2)
+                    std::this_thread::yield();
+            }
+
+            while (true) {
+                m_parked.fetch_add(1, std::memory_order_seq_cst);
+                auto epoch = m_epoch.load(std::memory_order_seq_cst);
+                if (ready()) {
+                    m_parked.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                m_epoch.wait(epoch, std::memory_order_seq_cst);
+                m_parked.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        void notify()
+        {
+            // Orders the state change of the caller before the check for parked threads.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_parked.load(std::memory_order_relaxed) == 0)
+                return;
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            m_epoch.notify_all();
+        }
+
+    private:
+        std::atomic<std::uint32_t> m_epoch = 0;
+        std::atomic<std::uint32_t> m_parked = 0;
+    };
+
+    inline std::size_t ring_capacity(std::size_t capacity)
+    {
+        return std::bit_ceil(std::max<std::size_t>(capacity, 2));
+    }
+
+    /**
+     * @brief Ring buffer for exactly one producer and one consumer thread.
+     */
+    template <typename T>
+    class SpscRing {
+    public:
+        explicit SpscRing(std::size_t capacity)
+            : m_slots(ring_capacity(capacity))
+            , m_mask(m_slots.size() - 1)
+        { }
+
+        bool try_push(T&& item)
+        {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cached_head == m_slots.size()) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (tail - m_cached_head == m_slots.size())
+                    return false;
+            }
+            m_slots[tail & m_mask].emplace(std::move(item));
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename Container>
+        std::size_t try_pop_bulk(Container& out, std::size_t max)
+        {
+            auto head = m_head.load(std::memory_order_relaxed);
+            if (m_cached_tail - head < max) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+            }
+            auto count = std::min(m_cached_tail - head, max);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto& slot = m_slots[(head + i) & m_mask];
+                out.push_back(std::move(*slot));
+                slot.reset();
+            }
+            if (count > 0)
+                m_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+        bool full() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire) == m_slots.size(); }
+        std::size_t capacity() const { return m_slots.size(); }
+
+    private:
+        std::vector<std::optional<T>> m_slots;
+        std::size_t const m_mask;
+        // Written by the consumer
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head = 0;
+        std::size_t m_cached_tail = 0;
+        // Written by the producer
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail = 0;
+        std::size_t m_cached_head = 0;
+    };
+
+    /**
+     * @brief Ring buffer for any amount of producers and consumers, based on Dmitry Vyukov's bounded MPMC queue.
+     *
+     * Every slot has a sequence number that tells producers and consumers whose turn it is, so threads only contend on
+     * the index they advance.
+     */
+    template <typename T>
+    class MpmcRing {
+    public:
+        explicit MpmcRing(std::size_t capacity)
+            : m_slots(ring_capacity(capacity))
+            , m_mask(m_slots.size() - 1)
+        {
+            for (std::size_t i = 0; i < m_slots.size(); ++i)
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool try_push(T&& item)
+        {
+            auto position = m_enqueue_position.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &m_slots[position & m_mask];
+                auto sequence = slot->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (difference == 0) {
+                    if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+            slot->value.emplace(std::move(item));
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename Container>
+        std::size_t try_pop_bulk(Container& out, std::size_t max)
+        {
+            auto position = m_dequeue_position.load(std::memory_order_relaxed);
+            std::size_t count;
+            while (true) {
+                // Claims the run of filled slots at the front with a single compare exchange.
+                count = 0;
+                while (count < max && count < m_slots.size() && m_slots[(position + count) & m_mask].sequence.load(std::memory_order_acquire) == position + count + 1)
+                    ++count;
+                if (count == 0)
+                    return 0;
+                if (m_dequeue_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                    break;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                auto& slot = m_slots[(position + i) & m_mask];
+                out.push_back(std::move(*slot.value));
+                slot.value.reset();
+                slot.sequence.store(position + i + m_slots.size(), std::memory_order_release);
+            }
+            return count;
+        }
+
+        bool empty() const
+        {
+            auto position = m_dequeue_position.load(std::memory_order_acquire);
+            return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position + 1;
+        }
+
+        bool full() const
+        {
+            auto position = m_enqueue_position.load(std::memory_order_acquire);
+            return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position;
+        }
+
+        std::size_t capacity() const { return m_slots.size(); }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> sequence;
+            std::optional<T> value;
+        };
+
+        std::vector<Slot> m_slots;
+        std::size_t const m_mask;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueue_position = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_dequeue_position = 0;
+    };
+
+}
+
+/**
+ * @brief Lock-free alternative to Channel with a fixed capacity.
+ *
+ * Behaves like Channel: get() blocks until an item arrives and all getters throw ChannelClosedException once the channel
+ * is closed. push() blocks while the channel is full. Blocking calls spin shortly before they park the thread.
+ * Use SpscChannel or MpmcChannel.
+ */
+template <typename T, typename Ring>
+class BoundedChannel {
+public:
+    /**
+     * @param capacity Maximum amount of queued items, rounded up to a power of two
+     */
+    explicit BoundedChannel(std::size_t capacity)
+        : m_ring(capacity)
+    { }
+
+    /**
+     * @brief Queues the item if there is space. The item is only moved from if it was queued.
+     * @returns whether the item was queued
+     */
+    bool try_push(T&& item)
+    {
+        if (!m_ring.try_push(std::move(item)))
+            return false;
+        m_not_empty.notify();
+        return true;
+    }
+
+    /**
+     * @brief Queues the item, waiting for space if the channel is full.
+     * @throws ChannelClosedException if the channel is closed while waiting
+     */
+    void push_task(T item)
+    {
+        while (!try_push(std::move(item))) {
+            m_not_full.wait([&]() { return !m_ring.full() || !is_open(); });
+            if (!is_open())
+                throw ChannelClosedException();
+        }
+    }
+
+    std::optional<T> try_get()
+    {
+        std::optional<T> item;
+        OptionalSink sink{item};
+        try_pop_bulk(sink, 1);
+        return item;
+    }
+
+    /**
+     * @brief Moves up to max queued items to the end of a container.
+     * @returns amount of moved items
+     */
+    template <typename Container>
+    std::size_t try_pop_bulk(Container& out, std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+        if (!is_open())
+            throw ChannelClosedException();
+
+        auto count = m_ring.try_pop_bulk(out, max);
+        if (count > 0)
+            m_not_full.notify();
+        return count;
+    }
+
+    T get()
+    {
+        while (true) {
+            if (auto item = try_get())
+                return std::move(item.value());
+            m_not_empty.wait([&]() { return !m_ring.empty() || !is_open(); });
+        }
+    }
+
+    void close()
+    {
+        m_is_open.store(false, std::memory_order_release);
+        m_not_empty.notify();
+        m_not_full.notify();
+    }
+
+    std::size_t capacity() const { return m_ring.capacity(); }
+
+private:
+    // Lets try_get() use the bulk pop of the ring.
+    struct OptionalSink {
+        std::optional<T>& item;
+        void push_back(T&& value) { item.emplace(std::move(value)); }
+    };
+
+    Ring m_ring;
+    std::atomic<bool> m_is_open{true};
+    channel_detail::SpinParkWaiter m_not_empty;
+    channel_detail::SpinParkWaiter m_not_full;
+
+    bool is_open() const { return m_is_open.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief BoundedChannel for one producer and one consumer thread.
+ */
+template <typename T>
+using SpscChannel = BoundedChannel<T, channel_detail::SpscRing<T>>;
+
+/**
+ * @brief BoundedChannel for any amount of producer and consumer threads.
+ */
+template <typename T>
+using MpmcChannel = BoundedChannel<T, channel_detail::MpmcRing<T>>;
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
+#include <limits>
+#include <mutex>
 #include <optional>
 #include <queue>
+#include <stdexcept>
 
 class ChannelClosedException : public std::runtime_error {
 public:
@@ -33,6 +37,27 @@ public:
         return {};
     }
 
+    /**
+     * @brief Moves up to max queued items to the end of a container, locking only once.
+     * @returns amount of moved items
+     */
+    template <typename Container>
+    std::size_t try_pop_bulk(Container& out, std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+        std::lock_guard<std::mutex> queue_lock{m_queue_mutex};
+
+        if (!m_is_open) {
+            throw ChannelClosedException();
+        }
+
+        auto count = std::min(m_queue.size(), max);
+        for (std::size_t i = 0; i < count; ++i) {
+            out.push_back(std::move(m_queue.front()));
+            m_queue.pop();
+        }
+        return count;
+    }
+
     T get()
     {
         while (true) {
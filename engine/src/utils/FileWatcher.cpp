@@ -0,0 +1,109 @@
+#include "utils/FileWatcher.hpp"
+
+#include "core/Base.hpp"
+#include <set>
+
+#ifdef BIRDY3D_PLATFORM_LINUX
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace Birdy3d::utils {
+
+    FileWatcher::FileWatcher(std::vector<std::filesystem::path> const& directories, Callback callback)
+        : m_callback(std::move(callback))
+    {
+#ifdef BIRDY3D_PLATFORM_LINUX
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0) {
+            core::Logger::error("Failed to initialize inotify");
+            return;
+        }
+
+        for (auto const& directory : directories)
+            add_watch(directory);
+
+        m_thread = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+#else
+        core::Logger::warn("Watching files is only supported on Linux");
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        if (m_thread.joinable()) {
+            m_thread.request_stop();
+            m_thread.join();
+        }
+#ifdef BIRDY3D_PLATFORM_LINUX
+        if (m_fd >= 0)
+            close(m_fd);
+#endif
+    }
+
+    void FileWatcher::add_watch(std::filesystem::path const& directory)
+    {
+#ifdef BIRDY3D_PLATFORM_LINUX
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error))
+            return;
+
+        auto watch = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch < 0) {
+            core::Logger::warn("Failed to watch directory '{}'", directory.string());
+            return;
+        }
+        m_watched_directories[watch] = directory;
+
+        for (auto const& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.is_directory())
+                add_watch(entry.path());
+        }
+#else
+        (void)directory;
+#endif
+    }
+
+    void FileWatcher::run(std::stop_token stop_token)
+    {
+#ifdef BIRDY3D_PLATFORM_LINUX
+        alignas(inotify_event) char buffer[4096];
+        pollfd poll_fd{.fd = m_fd, .events = POLLIN, .revents = 0};
+
+        while (!stop_token.stop_requested()) {
+            // Wake up regularly to check for a stop request
+            if (poll(&poll_fd, 1, 100) <= 0)
+                continue;
+
+            // Editors often write a file in several steps, so every file is reported only once per batch of events.
+            std::set<std::filesystem::path> changed_files;
+            ssize_t length;
+            while ((length = read(m_fd, buffer, sizeof(buffer))) > 0) {
+                for (char* it = buffer; it < buffer + length;) {
+                    auto event = reinterpret_cast<inotify_event const*>(it);
+                    it += sizeof(inotify_event) + event->len;
+
+                    auto directory = m_watched_directories.find(event->wd);
+                    if (directory == m_watched_directories.end() || event->len == 0)
+                        continue;
+                    auto path = directory->second / event->name;
+
+                    if (event->mask & IN_ISDIR) {
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                            add_watch(path);
+                    } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                        changed_files.insert(path);
+                    }
+                }
+            }
+
+            for (auto const& path : changed_files)
+                m_callback(path);
+        }
+#else
+        (void)stop_token;
+#endif
+    }
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Birdy3d::utils {
+
+    /**
+     * @brief Watches directories recursively on a background thread and reports files that were written.
+     *
+     * Only implemented on Linux (inotify). On other platforms no changes are reported.
+     */
+    class FileWatcher {
+    public:
+        using Callback = std::function<void(std::filesystem::path const&)>;
+
+        /**
+         * @param directories directories to watch, including their subdirectories
+         * @param callback called on the watcher thread for each changed file
+         */
+        FileWatcher(std::vector<std::filesystem::path> const& directories, Callback callback);
+        ~FileWatcher();
+
+        FileWatcher(FileWatcher const&) = delete;
+        FileWatcher& operator=(FileWatcher const&) = delete;
+
+    private:
+        int m_fd = -1;
+        std::unordered_map<int, std::filesystem::path> m_watched_directories;
+        Callback m_callback;
+        std::jthread m_thread;
+
+        void add_watch(std::filesystem::path const& directory);
+        void run(std::stop_token);
+    };
+
+}
@@ -2,6 +2,7 @@
 
 namespace Birdy3d::utils {
 
+    class FileWatcher;
     class Identifier;
 
 }
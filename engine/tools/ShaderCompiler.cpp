@@ -0,0 +1,76 @@
+// Preprocesses the shader variants listed in a file with the rules of the engine and compiles them to SPIR-V with
+// glslangValidator. The files are named by ShaderCache::source_key(), so that Shader finds them at runtime.
+// Every variant is compiled with and without bindless textures, because the header that the driver decides on at runtime
+// is part of the key. Has to run from the output directory of the engine, so that the shaders are found like at runtime.
+
+#include "core/Logger.hpp"
+#include "core/ResourceIdentifier.hpp"
+#include "render/Shader.hpp"
+#include "render/ShaderCache.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using namespace Birdy3d;
+
+namespace {
+
+    bool compile_stage(std::string const& glslang, std::filesystem::path const& path, std::string const& source)
+    {
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file << source;
+            if (!file) {
+                core::Logger::error("can't write '{}'", path.string());
+                return false;
+            }
+        }
+        // The locations of inputs, outputs and uniforms are assigned automatically, because the shaders don't specify them.
+        auto command = fmt::format("\"{}\" -G --auto-map-locations -o \"{}.spv\" \"{}\"", glslang, path.string(), path.string());
+        return std::system(command.c_str()) == 0;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4) {
+        fmt::print(stderr, "usage: {} <glslangValidator> <variants file> <output directory>\n", argv[0]);
+        return 1;
+    }
+    std::string glslang = argv[1];
+    std::ifstream variants(argv[2]);
+    std::filesystem::path output_directory = argv[3];
+    if (!variants) {
+        core::Logger::error("can't read '{}'", argv[2]);
+        return 1;
+    }
+    std::filesystem::create_directories(output_directory);
+
+    bool success = true;
+    std::string line;
+    while (std::getline(variants, line)) {
+        if (line.empty() || line.starts_with('#'))
+            continue;
+
+        core::ResourceIdentifier id{line};
+        for (bool bindless_textures : {false, true}) {
+            auto sources = render::Shader::preprocess(id.name(), id.args(), bindless_textures);
+            if (sources.vertex_shader.empty() || sources.fragment_shader.empty()) {
+                core::Logger::error("can't preprocess shader '{}'", line);
+                success = false;
+                break;
+            }
+
+            auto key = render::ShaderCache::source_key(sources.vertex_shader, sources.geometry_shader, sources.fragment_shader);
+            auto base_path = output_directory / fmt::format("{:016x}", key);
+            // glslangValidator infers the stage from the extension.
+            success = compile_stage(glslang, base_path.string() + ".vert", sources.vertex_shader) && success;
+            if (sources.has_geometry_shader)
+                success = compile_stage(glslang, base_path.string() + ".geom", sources.geometry_shader) && success;
+            success = compile_stage(glslang, base_path.string() + ".frag", sources.fragment_shader) && success;
+        }
+    }
+
+    return success ? 0 : 1;
+}
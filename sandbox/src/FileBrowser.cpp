@@ -14,11 +14,11 @@ std::optional<ui::TreeItem> FileBrowserTreeModel::item(ui::TreeItem const* paren
                 .hash = std::hash<std::string>{}("primitive::")};
         case 1:
             return ui::TreeItem{
-                .text = std::filesystem::path{root_directory.name}.filename().string(),
+                .text = std::filesystem::path{root_directory.name()}.filename().string(),
                 .data = std::make_any<core::ResourceIdentifier>(root_directory),
                 .local_index = local_index,
-                .is_leaf = !std::filesystem::is_directory(root_directory.name),
-                .hash = std::hash<std::string>{}(root_directory.name)};
+                .is_leaf = !std::filesystem::is_directory(root_directory.name()),
+                .hash = std::hash<std::string>{}(root_directory.name())};
         default:
             return {};
         }
@@ -27,16 +27,16 @@ std::optional<ui::TreeItem> FileBrowserTreeModel::item(ui::TreeItem const* paren
     auto parent_identifier = std::any_cast<core::ResourceIdentifier>(parent->data);
 
     // Primitive section
-    if (parent_identifier.source == "primitive") {
-        if (!parent_identifier.name.empty())
+    if (parent_identifier.source() == "primitive") {
+        if (!parent_identifier.name().empty())
             return {};
 
         core::ResourceIdentifier id;
 
         switch (local_index) {
         case 0:
-            id.source = "primitive";
-            id.type = core::ResourceType::MODEL;
+            id.source("primitive");
+            id.type(core::ResourceType::MODEL);
             return ui::TreeItem{
                 .text = "models",
                 .data = std::make_any<core::ResourceIdentifier>(id),
@@ -50,10 +50,10 @@ std::optional<ui::TreeItem> FileBrowserTreeModel::item(ui::TreeItem const* paren
     }
 
     // File section
-    if (parent_identifier.source != "file")
+    if (parent_identifier.source() != "file")
         return {};
 
-    auto parent_directory = std::filesystem::path{parent_identifier.name};
+    auto parent_directory = std::filesystem::path{parent_identifier.name()};
 
     if (!std::filesystem::is_directory(parent_directory))
         return {};
@@ -75,8 +75,8 @@ std::optional<ui::TreeItem> FileBrowserTreeModel::item(ui::TreeItem const* paren
 
         if (current_index++ == local_index) {
             core::ResourceIdentifier id;
-            id.source = "file";
-            id.name = entry.path().string();
+            id.source("file");
+            id.name(entry.path().string());
             return ui::TreeItem{
                 .text = entry.path().filename().string(),
                 .data = std::make_any<core::ResourceIdentifier>(id),
@@ -107,8 +107,8 @@ void FileBrowser::sync()
     // Sync files
     m_file_container->clear_children();
 
-    if (m_current_directory.source == "primitive") {
-        if (m_current_directory.type == core::ResourceType::MODEL) {
+    if (m_current_directory.source() == "primitive") {
+        if (m_current_directory.type() == core::ResourceType::MODEL) {
             m_file_container->add_child<FileItem>({.id = "primitive::plane"});
             m_file_container->add_child<FileItem>({.id = "primitive::cube"});
             m_file_container->add_child<FileItem>({.id = "primitive::uv_sphere:resolution=20"});
@@ -116,10 +116,10 @@ void FileBrowser::sync()
         return;
     }
 
-    if (!std::filesystem::is_directory(m_current_directory.name))
+    if (!std::filesystem::is_directory(m_current_directory.name()))
         return;
 
-    for (auto const& entry : std::filesystem::directory_iterator{m_current_directory.name}) {
+    for (auto const& entry : std::filesystem::directory_iterator{m_current_directory.name()}) {
         if (entry.is_directory())
             continue;
         m_file_container->add_child<FileItem>({.id = "file::" + entry.path().string()});
@@ -40,10 +40,11 @@ public:
         m_tree = tree_scroll_container->add_child<ui::TreeView>({});
         m_tree->m_model = std::make_unique<FileBrowserTreeModel>();
         auto tree_model = static_cast<FileBrowserTreeModel*>(m_tree->m_model.get());
-        m_root_directory.source = "file";
-        m_root_directory.name = options.root_directory.string();
-        if (m_root_directory.name.ends_with('/'))
-            m_root_directory.name = m_root_directory.name.substr(0, m_root_directory.name.length() - 1);
+        auto root_directory = options.root_directory.string();
+        if (root_directory.ends_with('/'))
+            root_directory = root_directory.substr(0, root_directory.length() - 1);
+        m_root_directory.source("file");
+        m_root_directory.name(root_directory);
         tree_model->root_directory = m_root_directory;
 
         m_file_container = add_child<ui::ScrollContainer>({});
@@ -68,7 +69,7 @@ private:
         FileItem(Options options)
             : ui::Widget(options)
             , m_resource_id(options.id)
-            , m_label(std::filesystem::path(options.id.name).filename().string())
+            , m_label(std::filesystem::path(options.id.name()).filename().string())
         {
             using namespace ui::literals;
             this->size = 100_px;
@@ -443,7 +443,12 @@ int main()
     // Entities
     std::shared_ptr<ecs::Scene> scene;
     auto scene_path = core::ResourceManager::get_resource_dir() + "scene.json";
+    auto manifest_path = core::ResourceManager::manifest_path(scene_path);
+    core::ResourceManager::record_manifest(true);
+    core::ResourcePreload preload;
     if (std::filesystem::exists(scene_path)) {
+        // Loads the resources of the last session in parallel while the scene is deserialized
+        preload = core::ResourceManager::preload_manifest(manifest_path);
         serializer::JsonParser parser(core::ResourceManager::read_file(scene_path));
         serializer::Serializer::deserialize(core::ResourceManager::read_file(scene_path), "scene", scene);
         core::Application::scene = scene;
@@ -531,7 +536,21 @@ int main()
     },
         GLFW_KEY_P);
 
+    core::Application::event_bus->subscribe<events::InputKeyEvent>([](events::InputKeyEvent const&) {
+        core::Application::option_toggle(core::BoolOption::HOT_RELOAD);
+        core::Logger::debug("Hot reload {}", core::Application::option_bool(core::BoolOption::HOT_RELOAD) ? "enabled" : "disabled");
+    },
+        GLFW_KEY_R);
+
+    core::Application::event_bus->subscribe<events::InputKeyEvent>([](events::InputKeyEvent const&) {
+        core::Application::option_toggle(core::BoolOption::PIPELINED_SIMULATION);
+        core::Logger::debug("Pipelined simulation {}", core::Application::option_bool(core::BoolOption::PIPELINED_SIMULATION) ? "enabled" : "disabled");
+    },
+        GLFW_KEY_T);
+
     scene->start();
+    // The scene holds its own handles now, everything else may be evicted.
+    preload = {};
 
     tree_model->root_entity = scene;
     tree->update_cache();
@@ -540,6 +559,7 @@ int main()
     core::Application::mainloop();
 
     scene->cleanup();
+    core::ResourceManager::save_manifest(manifest_path);
     core::Application::cleanup();
 
     std::fstream filestream;
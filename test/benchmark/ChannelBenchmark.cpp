@@ -0,0 +1,68 @@
+#include "utils/BoundedChannel.hpp"
+#include "utils/Channel.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Measures the throughput of the channels with a single consumer, like the main thread queue of Application.
+
+namespace {
+
+    constexpr std::size_t ITEMS = 4'000'000;
+    constexpr std::size_t CAPACITY = 4096;
+
+    template <typename ChannelType>
+    double measure(ChannelType& channel, std::size_t producers)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        std::size_t per_producer = ITEMS / producers;
+        for (std::size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&channel, per_producer]() {
+                for (std::uint64_t i = 0; i < per_producer; ++i)
+                    channel.push_task(i);
+            });
+        }
+
+        std::vector<std::uint64_t> items;
+        items.reserve(CAPACITY);
+        std::size_t received = 0;
+        std::uint64_t sum = 0;
+        while (received < per_producer * producers) {
+            items.clear();
+            if (channel.try_pop_bulk(items) == 0)
+                items.push_back(channel.get());
+            received += items.size();
+            for (auto item : items)
+                sum += item;
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        std::uint64_t expected = producers * (per_producer * (per_producer - 1) / 2);
+        if (sum != expected)
+            std::printf("  checksum mismatch: %llu != %llu\n", (unsigned long long)sum, (unsigned long long)expected);
+        return received / duration.count() / 1e6;
+    }
+
+}
+
+int main()
+{
+    std::printf("%-10s %12s %12s %12s\n", "producers", "Channel", "MpmcChannel", "SpscChannel");
+    for (std::size_t producers : {1, 4, 16}) {
+        Channel<std::uint64_t> channel;
+        MpmcChannel<std::uint64_t> mpmc{CAPACITY};
+        std::printf("%-10zu %9.2f M/s %9.2f M/s", producers, measure(channel, producers), measure(mpmc, producers));
+        if (producers == 1) {
+            SpscChannel<std::uint64_t> spsc{CAPACITY};
+            std::printf(" %9.2f M/s", measure(spsc, producers));
+        }
+        std::printf("\n");
+    }
+}
@@ -0,0 +1,38 @@
+#include "common.hpp"
+
+#include "core/JobSystem.hpp"
+#include <atomic>
+#include <stdexcept>
+
+using namespace Birdy3d::core;
+
+TEST_CASE("JobSystem")
+{
+    SUBCASE("parallel_for")
+    {
+        std::atomic<std::size_t> sum = 0;
+        JobSystem::parallel_for(1000, [&](std::size_t i) { sum += i; }, 10);
+        CHECK_EQ(sum, 999 * 1000 / 2);
+    }
+
+    SUBCASE("exception of a child")
+    {
+        auto root = JobSystem::create([]() { });
+        JobSystem::run([]() { throw std::runtime_error("child"); }, root);
+        JobSystem::run(root);
+        CHECK_THROWS_AS(JobSystem::wait(root), std::runtime_error);
+    }
+
+    SUBCASE("exception in parallel_for")
+    {
+        std::atomic<std::size_t> calls = 0;
+        auto throwing = [&](std::size_t i) {
+            ++calls;
+            if (i == 500)
+                throw std::runtime_error("batch");
+        };
+        CHECK_THROWS_AS(JobSystem::parallel_for(1000, throwing, 10), std::runtime_error);
+        // The other batches still ran.
+        CHECK_EQ(calls, 1000);
+    }
+}
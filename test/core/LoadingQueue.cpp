@@ -0,0 +1,93 @@
+#include "common.hpp"
+
+#include "core/LoadingQueue.hpp"
+#include <vector>
+
+using namespace Birdy3d::core;
+
+namespace {
+
+    void run_all(LoadingQueue& queue)
+    {
+        while (auto task = queue.try_get())
+            (*task)();
+    }
+
+}
+
+TEST_CASE("LoadingQueue")
+{
+    LoadingQueue queue;
+    std::vector<int> order;
+    auto push = [&](int value, float priority) {
+        return queue.push([&order, value](std::stop_token) { order.push_back(value); }, priority);
+    };
+
+    SUBCASE("higher priority first")
+    {
+        push(1, 1.0f);
+        push(2, 3.0f);
+        push(3, 2.0f);
+        run_all(queue);
+        CHECK_EQ(order, (std::vector{2, 3, 1}));
+    }
+
+    SUBCASE("same priority in push order")
+    {
+        for (int i = 0; i < 8; ++i)
+            push(i, 1.0f);
+        run_all(queue);
+        CHECK_EQ(order, (std::vector{0, 1, 2, 3, 4, 5, 6, 7}));
+    }
+
+    SUBCASE("reprioritize")
+    {
+        auto first = push(1, 3.0f);
+        push(2, 2.0f);
+        auto third = push(3, 1.0f);
+        third.priority(4.0f);
+        first.priority(0.0f);
+        run_all(queue);
+        CHECK_EQ(order, (std::vector{3, 2, 1}));
+    }
+
+    SUBCASE("reprioritize after the task was taken")
+    {
+        auto ticket = push(1, 1.0f);
+        auto task = queue.try_get();
+        REQUIRE(task.has_value());
+        ticket.priority(2.0f);
+        push(2, 1.0f);
+        run_all(queue);
+        CHECK_EQ(order, (std::vector{2}));
+    }
+
+    SUBCASE("cancelled tasks are skipped")
+    {
+        push(1, 1.0f);
+        auto ticket = push(2, 2.0f);
+        push(3, 1.0f);
+        ticket.cancel();
+        CHECK(ticket.cancelled());
+        run_all(queue);
+        CHECK_EQ(order, (std::vector{1, 3}));
+    }
+
+    SUBCASE("cancel a running task")
+    {
+        bool stopped = false;
+        auto ticket = queue.push([&](std::stop_token stop_token) { stopped = stop_token.stop_requested(); }, 1.0f);
+        auto task = queue.try_get();
+        REQUIRE(task.has_value());
+        ticket.cancel();
+        (*task)();
+        CHECK(stopped);
+    }
+
+    SUBCASE("closed queue")
+    {
+        push(1, 1.0f);
+        queue.close();
+        CHECK_FALSE(queue.try_get().has_value());
+    }
+}
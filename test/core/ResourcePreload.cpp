@@ -0,0 +1,51 @@
+#include "common.hpp"
+
+#include "core/ResourceManager.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace Birdy3d::core;
+
+TEST_CASE("preload_manifest")
+{
+    // Evicts every unreferenced resource.
+    auto gpu_budget = Application::option_int(IntOption::RESOURCE_GPU_BUDGET);
+    Application::option_int(IntOption::RESOURCE_GPU_BUDGET, 1);
+    ResourceManager::enforce_memory_budget();
+    auto before = ResourceManager::memory_usage(ResourceType::SHADER).gpu;
+
+    // A variant that nothing else uses
+    auto path = (std::filesystem::temp_directory_path() / "birdy3d_test.manifest.json").string();
+    {
+        std::ofstream manifest(path, std::ios::trunc);
+        manifest << R"({"resources": [{"type": "shader", "id": "file::directional_light_depth.glsl:SHADOW_CASCADE_SIZE=7"}]})";
+    }
+
+    SUBCASE("dropped preload leaves the shader unused")
+    {
+        {
+            auto preload = ResourceManager::preload_manifest(path);
+            REQUIRE_EQ(preload.shaders.size(), 1);
+            CHECK(preload.shaders[0].ptr());
+            ResourceManager::enforce_memory_budget();
+            CHECK(ResourceManager::memory_usage(ResourceType::SHADER).gpu > before);
+        }
+        ResourceManager::enforce_memory_budget();
+        CHECK_EQ(ResourceManager::memory_usage(ResourceType::SHADER).gpu, before);
+    }
+
+    SUBCASE("cached shaders are kept by the preload")
+    {
+        auto handle = ResourceManager::get_shader("file::directional_light_depth.glsl:SHADOW_CASCADE_SIZE=7");
+        auto preload = ResourceManager::preload_manifest(path);
+        REQUIRE_EQ(preload.shaders.size(), 1);
+        CHECK_EQ(preload.shaders[0].ptr(), handle.ptr());
+        handle = ResourceHandle<render::Shader>{};
+        ResourceManager::enforce_memory_budget();
+        CHECK(preload.shaders[0].ptr());
+    }
+
+    std::filesystem::remove(path);
+    Application::option_int(IntOption::RESOURCE_GPU_BUDGET, gpu_budget);
+    ResourceManager::enforce_memory_budget();
+}
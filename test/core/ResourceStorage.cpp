@@ -0,0 +1,135 @@
+#include "common.hpp"
+
+#include "core/ResourceStorage.hpp"
+#include <memory>
+
+using namespace Birdy3d::core;
+
+namespace {
+
+    struct TestResource {
+        std::size_t size;
+    };
+
+}
+
+template <>
+ResourceMemory ResourceStorage<TestResource>::memory_usage(TestResource const& resource)
+{
+    return {.cpu = resource.size};
+}
+
+TEST_CASE("ResourceStorage")
+{
+    ResourceStorage<TestResource> storage;
+    ResourceIdentifier a{"test::a"};
+    ResourceIdentifier b{"test::b"};
+
+    SUBCASE("insert and find")
+    {
+        auto index = storage.insert(a, std::make_unique<TestResource>(10));
+        REQUIRE(storage.get(index));
+        CHECK_EQ(storage.get(index)->size, 10);
+        CHECK_EQ(storage.id(index), a);
+        CHECK_EQ(storage.memory().cpu, 10);
+        CHECK_EQ(storage.find(a), index);
+        CHECK_FALSE(storage.find(b).has_value());
+    }
+
+    SUBCASE("released resources stay cached")
+    {
+        auto index = storage.insert(a, std::make_unique<TestResource>(10));
+        CHECK_FALSE(storage.release(index).has_value());
+        CHECK(storage.get(index));
+        CHECK(storage.oldest_unused(true, false).has_value());
+        CHECK_FALSE(storage.oldest_unused(false, true).has_value());
+        CHECK_EQ(storage.find(a), index);
+        // Retained again, so there is nothing to evict.
+        CHECK_FALSE(storage.evict_oldest_unused(true, false));
+    }
+
+    SUBCASE("eviction in least recently used order")
+    {
+        auto index_a = storage.insert(a, std::make_unique<TestResource>(10));
+        auto index_b = storage.insert(b, std::make_unique<TestResource>(20));
+        CHECK_FALSE(storage.evict_oldest_unused(true, false));
+        storage.release(index_a);
+        storage.release(index_b);
+        CHECK_EQ(storage.memory().cpu, 30);
+
+        CHECK(storage.evict_oldest_unused(true, false));
+        CHECK_FALSE(storage.get(index_a));
+        CHECK_FALSE(storage.find(a).has_value());
+        CHECK(storage.get(index_b));
+        CHECK_EQ(storage.memory().cpu, 20);
+
+        CHECK(storage.evict_oldest_unused(true, false));
+        CHECK_FALSE(storage.get(index_b));
+        CHECK_EQ(storage.memory().cpu, 0);
+        CHECK_FALSE(storage.evict_oldest_unused(true, false));
+    }
+
+    SUBCASE("evicted slots are reused")
+    {
+        auto old_index = storage.insert(a, std::make_unique<TestResource>(10));
+        storage.release(old_index);
+        storage.evict_oldest_unused(true, false);
+
+        auto new_index = storage.insert(b, std::make_unique<TestResource>(20));
+        CHECK_EQ(storage.capacity(), 1);
+        CHECK_NE(new_index, old_index);
+        // The index of the previous use doesn't resolve to the new resource.
+        CHECK_FALSE(storage.get(old_index));
+        REQUIRE(storage.get(new_index));
+        CHECK_EQ(storage.get(new_index)->size, 20);
+    }
+
+    SUBCASE("releasing a pending resource cancels its load")
+    {
+        auto index = storage.insert_pending(a, [](std::size_t) { return LoadingTicket{}; });
+        CHECK_EQ(storage.insert_pending(a, [](std::size_t) { return LoadingTicket{}; }), index);
+        CHECK_FALSE(storage.release(index).has_value());
+        CHECK_EQ(storage.release(index), a);
+        CHECK_FALSE(storage.find(a).has_value());
+
+        // A result that arrives after the cancellation is discarded.
+        storage.store(index, std::make_unique<TestResource>(10));
+        CHECK_FALSE(storage.get(index));
+        CHECK_EQ(storage.memory().cpu, 0);
+    }
+
+    SUBCASE("failed loads")
+    {
+        auto index = storage.insert_pending(a, [](std::size_t) { return LoadingTicket{}; });
+        bool called = false;
+        storage.then(index, [&](TestResource const* resource) {
+            called = true;
+            CHECK_FALSE(resource);
+        });
+        storage.fail(index);
+        CHECK(called);
+        CHECK(storage.failed(index));
+        // The next request loads the resource again.
+        auto retry = storage.insert_pending(a, [](std::size_t) { return LoadingTicket{}; });
+        CHECK_NE(retry, index);
+        storage.release(index);
+        CHECK_FALSE(storage.failed(retry));
+    }
+
+    SUBCASE("replace")
+    {
+        auto old_index = storage.insert(a, std::make_unique<TestResource>(10));
+        storage.replace(a, std::make_unique<TestResource>(20));
+        auto new_index = storage.successor(old_index);
+        REQUIRE(new_index.has_value());
+        CHECK_EQ(storage.get(*new_index)->size, 20);
+        CHECK_EQ(storage.find(a), new_index);
+        storage.release(*new_index);
+
+        // The old version is dropped with its last reference, the new one stays cached.
+        storage.release(old_index);
+        CHECK_FALSE(storage.get(old_index));
+        CHECK(storage.get(*new_index));
+        CHECK_EQ(storage.memory().cpu, 20);
+    }
+}
@@ -0,0 +1,103 @@
+#include "common.hpp"
+
+#include "ecs/BoundingVolumeHierarchy.hpp"
+#include "ecs/Component.hpp"
+#include <array>
+#include <set>
+
+using namespace Birdy3d::ecs;
+
+namespace {
+
+    // Unit box around a point on the x axis
+    render::BoundingBox box_at(float x)
+    {
+        return {glm::vec3{x, 0, 0}, glm::vec3{1}};
+    }
+
+    std::set<Component*> overlapping(BoundingVolumeHierarchy const& tree, render::BoundingBox const& box, BoundsLayer layer = BoundsLayer::MODELS)
+    {
+        std::set<Component*> result;
+        tree.query(box, layer, [&](Component* component) { result.insert(component); });
+        return result;
+    }
+
+}
+
+TEST_CASE("BoundingVolumeHierarchy")
+{
+    BoundingVolumeHierarchy tree;
+    std::array<Component, 64> components;
+    std::array<BoundingVolumeHierarchy::ProxyId, 64> proxies;
+    for (std::size_t i = 0; i < components.size(); ++i)
+        proxies[i] = tree.insert(&components[i], BoundsLayer::MODELS, box_at(i * 10.0f));
+
+    SUBCASE("insert")
+    {
+        CHECK_EQ(tree.size(), 64);
+        // Balanced by the rotations
+        CHECK(tree.height() <= 12);
+        CHECK_EQ(overlapping(tree, box_at(0.0f)), std::set{&components[0]});
+        CHECK_EQ(overlapping(tree, {glm::vec3{25, 0, 0}, glm::vec3{6, 1, 1}}), (std::set{&components[2], &components[3]}));
+        CHECK(overlapping(tree, box_at(5.0f)).empty());
+    }
+
+    SUBCASE("layers")
+    {
+        Component collider;
+        tree.insert(&collider, BoundsLayer::COLLIDERS, box_at(0.0f));
+        CHECK_EQ(overlapping(tree, box_at(0.0f)), std::set{&components[0]});
+        CHECK_EQ(overlapping(tree, box_at(0.0f), BoundsLayer::COLLIDERS), std::set{&collider});
+    }
+
+    SUBCASE("remove")
+    {
+        tree.remove(proxies[2]);
+        CHECK_EQ(tree.size(), 63);
+        CHECK(overlapping(tree, box_at(20.0f)).empty());
+        CHECK_EQ(overlapping(tree, box_at(30.0f)), std::set{&components[3]});
+
+        // The proxy is reused.
+        Component other;
+        CHECK_EQ(tree.insert(&other, BoundsLayer::MODELS, box_at(20.0f)), proxies[2]);
+        CHECK_EQ(overlapping(tree, box_at(20.0f)), std::set{&other});
+    }
+
+    SUBCASE("move")
+    {
+        // Small movements stay within the enlarged leaf, but queries use the exact box.
+        tree.move(proxies[0], box_at(0.1f));
+        CHECK(overlapping(tree, {glm::vec3{-1.05f, 0, 0}, glm::vec3{0.1f}}).empty());
+        tree.move(proxies[0], box_at(1000.0f));
+        CHECK(overlapping(tree, box_at(0.0f)).empty());
+        CHECK_EQ(overlapping(tree, box_at(1000.0f)), std::set{&components[0]});
+    }
+
+    SUBCASE("sphere and ray queries")
+    {
+        std::set<Component*> in_sphere;
+        tree.query(Sphere{glm::vec3{15, 0, 0}, 5.0f}, BoundsLayer::MODELS, [&](Component* component) { in_sphere.insert(component); });
+        CHECK_EQ(in_sphere, (std::set{&components[1], &components[2]}));
+
+        std::set<Component*> hits;
+        float nearest = std::numeric_limits<float>::infinity();
+        tree.query(Ray{glm::vec3{-5, 0, 0}, glm::vec3{1, 0, 0}, 20.0f}, BoundsLayer::MODELS, [&](Component* component, float distance) {
+            hits.insert(component);
+            nearest = std::min(nearest, distance);
+        });
+        CHECK_EQ(hits, (std::set{&components[0], &components[1]}));
+        CHECK_EQ(nearest, 4.0f);
+    }
+
+    SUBCASE("rebuild")
+    {
+        for (std::size_t i = 0; i < components.size(); ++i)
+            tree.move(proxies[i], box_at(i * -10.0f));
+        tree.rebuild();
+        CHECK_FALSE(tree.degraded());
+        // Split at the median
+        CHECK_EQ(tree.height(), 6);
+        CHECK_EQ(overlapping(tree, box_at(-630.0f)), std::set{&components[63]});
+        CHECK(overlapping(tree, box_at(630.0f)).empty());
+    }
+}
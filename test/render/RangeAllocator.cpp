@@ -0,0 +1,75 @@
+#include "common.hpp"
+
+#include "render/GeometryArena.hpp"
+#include <utility>
+#include <vector>
+
+using namespace Birdy3d::render;
+
+namespace {
+
+    using Ranges = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+}
+
+TEST_CASE("RangeAllocator")
+{
+    RangeAllocator allocator;
+    CHECK_FALSE(allocator.allocate(1).has_value());
+    allocator.grow(100);
+    CHECK_EQ(allocator.capacity(), 100);
+    CHECK_EQ(allocator.allocate(10), 0);
+    CHECK_EQ(allocator.allocate(20), 10);
+    CHECK_EQ(allocator.allocate(30), 30);
+    CHECK_EQ(allocator.allocate(25), 60);
+    CHECK_EQ(allocator.free_ranges(), (Ranges{{85, 15}}));
+
+    SUBCASE("first fit")
+    {
+        allocator.free(10, 20);
+        CHECK_FALSE(allocator.allocate(21).has_value());
+        CHECK_EQ(allocator.allocate(15), 10);
+        // The rest of the first range is too small.
+        CHECK_EQ(allocator.allocate(10), 85);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{25, 5}, {95, 5}}));
+    }
+
+    SUBCASE("merge")
+    {
+        allocator.free(30, 30);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{30, 30}, {85, 15}}));
+        // Merges with the previous and the next range.
+        allocator.free(60, 25);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{30, 70}}));
+        // Not adjacent to any free range
+        allocator.free(0, 10);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{0, 10}, {30, 70}}));
+        // Merges with the previous range only.
+        allocator.free(10, 5);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{0, 15}, {30, 70}}));
+        // Merges with the next range only.
+        allocator.free(20, 10);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{0, 15}, {20, 80}}));
+        allocator.free(15, 5);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{0, 100}}));
+        allocator.free(50, 0);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{0, 100}}));
+        CHECK_EQ(allocator.allocate(100), 0);
+    }
+
+    SUBCASE("grow")
+    {
+        // The new space merges with the free range at the end.
+        allocator.grow(150);
+        CHECK_EQ(allocator.capacity(), 150);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{85, 65}}));
+        CHECK_EQ(allocator.allocate(65), 85);
+
+        allocator.grow(200);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{150, 50}}));
+        // Shrinking isn't possible.
+        allocator.grow(100);
+        CHECK_EQ(allocator.capacity(), 200);
+        CHECK_EQ(allocator.free_ranges(), (Ranges{{150, 50}}));
+    }
+}
@@ -0,0 +1,87 @@
+#include "common.hpp"
+
+#include "utils/BoundedChannel.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE_TEMPLATE("BoundedChannel", ChannelType, SpscChannel<int>, MpmcChannel<int>)
+{
+    ChannelType channel{4};
+
+    SUBCASE("capacity")
+    {
+        CHECK_EQ(channel.capacity(), 4);
+        for (int i = 0; i < 4; ++i)
+            CHECK(channel.try_push(int{i}));
+        CHECK_FALSE(channel.try_push(4));
+        CHECK_EQ(channel.try_get(), 0);
+        CHECK(channel.try_push(4));
+    }
+
+    SUBCASE("wrap around")
+    {
+        // Every round starts at a different position of the ring.
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 3; ++i)
+                CHECK(channel.try_push(round * 3 + i));
+            for (int i = 0; i < 3; ++i)
+                CHECK_EQ(channel.try_get(), round * 3 + i);
+            CHECK_FALSE(channel.try_get().has_value());
+        }
+    }
+
+    SUBCASE("bulk pop across the end of the ring")
+    {
+        for (int i = 0; i < 3; ++i)
+            channel.try_push(int{i});
+        std::vector<int> items;
+        CHECK_EQ(channel.try_pop_bulk(items), 3);
+
+        // Occupies the last slot and the first three slots.
+        for (int i = 3; i < 7; ++i)
+            CHECK(channel.try_push(int{i}));
+        items.clear();
+        CHECK_EQ(channel.try_pop_bulk(items, 3), 3);
+        CHECK_EQ(items, (std::vector{3, 4, 5}));
+        CHECK_EQ(channel.try_pop_bulk(items), 1);
+        CHECK_EQ(items, (std::vector{3, 4, 5, 6}));
+        CHECK_EQ(channel.try_pop_bulk(items), 0);
+    }
+
+    SUBCASE("close while a consumer is parked")
+    {
+        std::atomic<bool> closed = false;
+        std::thread consumer([&]() {
+            try {
+                channel.get();
+            } catch (ChannelClosedException const&) {
+                closed = true;
+            }
+        });
+        // Long enough for the consumer to stop spinning and park.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        channel.close();
+        consumer.join();
+        CHECK(closed);
+    }
+
+    SUBCASE("close while a producer is parked")
+    {
+        for (int i = 0; i < 4; ++i)
+            channel.try_push(int{i});
+        std::atomic<bool> closed = false;
+        std::thread producer([&]() {
+            try {
+                channel.push_task(4);
+            } catch (ChannelClosedException const&) {
+                closed = true;
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        channel.close();
+        producer.join();
+        CHECK(closed);
+    }
+}